@@ -0,0 +1,68 @@
+#include "AliasTable.h"
+
+#include <sstream>
+#include <stdexcept>
+
+AliasTable::AliasTable(const std::vector<double>& weights)
+    : m_probabilities()
+    , m_thresholds()
+    , m_aliases()
+{
+    if (!weights.empty())
+        setWeights(weights);
+}
+
+void AliasTable::setWeights(const std::vector<double>& weights)
+{
+    double sum = 0;
+    for (unsigned i = 0; i < weights.size(); ++i) {
+        if (!(weights[i] >= 0)) {
+            std::ostringstream exceptionStream;
+            exceptionStream << __PRETTY_FUNCTION__ << ": Invalid weight (" << weights[i] << ") at index " << i << ".";
+            throw std::invalid_argument(exceptionStream.str());
+        }
+        sum += weights[i];
+    }
+    if (!(sum > 0)) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Building an alias table from weights with a null sum.";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    unsigned n = weights.size();
+    m_probabilities.resize(n);
+    m_thresholds.resize(n);
+    m_aliases.resize(n);
+
+    // Scale the probabilities so that each column has to be filled up to 1
+    std::vector<unsigned> small, large;
+    small.reserve(n);
+    large.reserve(n);
+    for (unsigned i = 0; i < n; ++i) {
+        m_probabilities[i] = weights[i] / sum;
+        m_thresholds[i] = m_probabilities[i] * n;
+        m_aliases[i] = i;
+        if (m_thresholds[i] < 1)
+            small.push_back(i);
+        else
+            large.push_back(i);
+    }
+
+    // Fill each under-full column with the excess of an over-full one
+    while (!small.empty() && !large.empty()) {
+        unsigned less = small.back(), more = large.back();
+        small.pop_back();
+        m_aliases[less] = more;
+        m_thresholds[more] -= 1 - m_thresholds[less];
+        if (m_thresholds[more] < 1) {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+
+    // Remaining columns are full (up to rounding errors)
+    for (unsigned i : small)
+        m_thresholds[i] = 1;
+    for (unsigned i : large)
+        m_thresholds[i] = 1;
+}
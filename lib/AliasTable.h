@@ -0,0 +1,73 @@
+#ifndef ALIASTABLE_H
+#define ALIASTABLE_H
+
+#include <vector>
+
+/**
+  * \brief  Table of Walker's alias method, to draw in constant time the index of an arbitrary discrete distribution.
+  *
+  * The table is built, in linear time, from the weights of the indexes (Vose's algorithm). Drawing an index then only
+  * needs a column picked uniformly, and a comparison with the threshold of the column: below it, the column index is
+  * drawn, above it, the alias of the column is drawn. Drawing is done by Random::discrete().
+  */
+class AliasTable {
+public:
+    /**
+      * \brief  Constructor
+      * \param  weights Weight of each index: the probability of index i is weights[i] / sum(weights)
+      */
+    AliasTable(const std::vector<double>& weights = std::vector<double>());
+
+    /**
+      * \brief  Rebuilds the table from the given weights
+      * \param  weights Weight of each index, must be positive or null, with a positive sum
+      */
+    void setWeights(const std::vector<double>& weights);
+
+    /**
+      * \brief  Returns the number of indexes of the distribution
+      */
+    unsigned size() const
+    {
+        return m_probabilities.size();
+    }
+
+    /**
+      * \brief  Returns true if the table has no index
+      */
+    bool isEmpty() const
+    {
+        return m_probabilities.empty();
+    }
+
+    /**
+      * \brief  Returns the probability of the given index
+      */
+    double probability(unsigned index) const
+    {
+        return m_probabilities.at(index);
+    }
+
+    /**
+      * \brief  Returns the probability of drawing the index of the column (and not its alias), once the column is drawn
+      */
+    double threshold(unsigned column) const
+    {
+        return m_thresholds[column];
+    }
+
+    /**
+      * \brief  Returns the alias of the column
+      */
+    unsigned alias(unsigned column) const
+    {
+        return m_aliases[column];
+    }
+
+private:
+    std::vector<double> m_probabilities;
+    std::vector<double> m_thresholds;
+    std::vector<unsigned> m_aliases;
+};
+
+#endif // ALIASTABLE_H
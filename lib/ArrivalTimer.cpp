@@ -0,0 +1,193 @@
+#include "ArrivalTimer.h"
+#include "DESimulator.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+ArrivalTimer::ArrivalTimer(const std::string name)
+    : ModuleTimer(name)
+    , m_times()
+    , m_rates()
+    , m_cumulativeRates()
+    , m_majorants()
+    , m_periodic(true)
+    , m_method(CumulativeRateInversion)
+{
+}
+
+void ArrivalTimer::setRateProfile(const std::vector<double>& times, const std::vector<double>& rates, bool periodic)
+{
+    if (times.size() != rates.size() || times.size() < 2 || times[0] != 0) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": A rate profile needs at least two breakpoints, the first one at time 0"
+                        << " (" << times.size() << " times and " << rates.size() << " rates given).";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+    for (unsigned i = 0; i < times.size(); ++i) {
+        if ((i > 0 && !(times[i] > times[i - 1])) || !(rates[i] >= 0)) {
+            std::ostringstream exceptionStream;
+            exceptionStream << __PRETTY_FUNCTION__ << ": Invalid breakpoint " << i << " (time " << times[i]
+                            << ", rate " << rates[i] << ") of the rate profile.";
+            throw std::invalid_argument(exceptionStream.str());
+        }
+    }
+
+    m_times = times;
+    m_rates = rates;
+    m_periodic = periodic;
+
+    // Expected number of arrivals at each breakpoint, and maximal rate of each segment
+    m_cumulativeRates.assign(1, 0);
+    m_majorants.clear();
+    for (unsigned i = 0; i + 1 < times.size(); ++i) {
+        m_cumulativeRates.push_back(m_cumulativeRates.back() + (rates[i] + rates[i + 1]) / 2 * (times[i + 1] - times[i]));
+        m_majorants.push_back(std::max(rates[i], rates[i + 1]));
+    }
+}
+
+unsigned ArrivalTimer::segment(double time) const
+{
+    long index = std::upper_bound(m_times.begin(), m_times.end(), time) - m_times.begin() - 1;
+    return (unsigned)std::min(std::max(index, 0L), (long)m_times.size() - 2);
+}
+
+double ArrivalTimer::rate(double time) const
+{
+    if (m_times.empty() || time < 0)
+        return 0;
+    if (!m_periodic && time >= m_times.back())
+        return m_rates.back();
+
+    double period = m_times.back();
+    double t = m_periodic ? time - floor(time / period) * period : time;
+    unsigned i = segment(t);
+    return m_rates[i] + (m_rates[i + 1] - m_rates[i]) * (t - m_times[i]) / (m_times[i + 1] - m_times[i]);
+}
+
+double ArrivalTimer::cumulativeRate(double time) const
+{
+    if (m_times.empty() || time <= 0)
+        return 0;
+
+    double period = m_times.back(), total = m_cumulativeRates.back();
+    if (!m_periodic && time >= period)
+        return total + (time - period) * m_rates.back();
+
+    double periods = m_periodic ? floor(time / period) : 0;
+    double t = time - periods * period;
+    unsigned i = segment(t);
+    double s = t - m_times[i];
+    double slope = (m_rates[i + 1] - m_rates[i]) / (m_times[i + 1] - m_times[i]);
+    return periods * total + m_cumulativeRates[i] + m_rates[i] * s + slope * s * s / 2;
+}
+
+double ArrivalTimer::inverseCumulativeRate(double value) const
+{
+    // Last breakpoint not after the value (segments without arrivals are skipped)
+    long index = std::upper_bound(m_cumulativeRates.begin(), m_cumulativeRates.end(), value) - m_cumulativeRates.begin() - 1;
+    unsigned i = (unsigned)std::min(std::max(index, 0L), (long)m_times.size() - 2);
+
+    // Root of rate * s + slope * s^2 / 2 = remaining, in a form without cancellation
+    double length = m_times[i + 1] - m_times[i];
+    double slope = (m_rates[i + 1] - m_rates[i]) / length;
+    double remaining = value - m_cumulativeRates[i];
+    if (remaining <= 0)
+        return m_times[i];
+    double s = 2 * remaining / (m_rates[i] + sqrt(std::max(m_rates[i] * m_rates[i] + 2 * slope * remaining, 0.)));
+    return m_times[i] + std::min(s, length);
+}
+
+double ArrivalTimer::arrivalByInversion(double time, Random* generator) const
+{
+    double period = m_times.back(), total = m_cumulativeRates.back();
+    double target = cumulativeRate(time) + generator->exponential(1);
+
+    double arrival;
+    if (m_periodic) {
+        if (total <= 0)
+            return -1;
+        double periods = floor(target / total);
+        arrival = periods * period + inverseCumulativeRate(target - periods * total);
+    } else if (target < total)
+        arrival = inverseCumulativeRate(target);
+    else if (m_rates.back() > 0)
+        arrival = period + (target - total) / m_rates.back();
+    else
+        return -1;
+
+    // Rounding errors must not move the arrival in the past
+    return std::max(arrival, time);
+}
+
+double ArrivalTimer::arrivalByThinning(double time, Random* generator) const
+{
+    double period = m_times.back();
+    if (m_periodic && m_cumulativeRates.back() <= 0)
+        return -1;
+
+    double periodStart = m_periodic ? floor(time / period) * period : 0;
+    double t = time;
+    unsigned i = segment(t - periodStart);
+    while (1) {
+        // Constant rate after the end of a non periodic profile
+        if (!m_periodic && t >= period) {
+            if (m_rates.back() <= 0)
+                return -1;
+            return t + generator->exponential(m_rates.back());
+        }
+
+        double segmentEnd = periodStart + m_times[i + 1];
+        double majorant = m_majorants[i];
+        if (majorant > 0) {
+            double candidate = t + generator->exponential(majorant);
+            if (candidate < segmentEnd) {
+                t = candidate;
+                double s = t - periodStart - m_times[i];
+                double rate = m_rates[i] + (m_rates[i + 1] - m_rates[i]) * s / (m_times[i + 1] - m_times[i]);
+                if (generator->uniform(0, 1) * majorant <= rate)
+                    return t;
+                continue;
+            }
+        }
+
+        // No arrival left in the segment: go on from the start of the next one
+        t = segmentEnd;
+        if (++i == m_times.size() - 1 && m_periodic) {
+            i = 0;
+            periodStart += period;
+        }
+    }
+}
+
+double ArrivalTimer::nextArrivalTime(double time, Random* generator) const
+{
+    if (m_times.empty()) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Arrival timer \"" << name() << "\" has no rate profile.";
+        throw std::runtime_error(exceptionStream.str());
+    }
+
+    if (m_method == Thinning)
+        return arrivalByThinning(time, generator);
+    return arrivalByInversion(time, generator);
+}
+
+bool ArrivalTimer::scheduleNextArrival(Random* generator)
+{
+    if (ownerModuleId() == invalidModuleId)
+        throw std::runtime_error("Trying to schedule a timer not attached to a module.");
+
+    if (!generator) {
+        SimulationModule* owner = DESimulator::theSimulator()->module(ownerModuleId());
+        generator = owner ? owner->randomGenerator() : Random::Generate();
+    }
+
+    double arrival = nextArrivalTime(DESimulator::simTime().toDbl(), generator);
+    if (arrival < 0)
+        return false;
+    scheduleAt(arrival);
+    return true;
+}
@@ -0,0 +1,103 @@
+#ifndef ARRIVALTIMER_H
+#define ARRIVALTIMER_H
+
+#include "ModuleTimer.h"
+
+#include <vector>
+
+class Random;
+
+/**
+  * \brief  Timer firing at the arrivals of a non-homogeneous Poisson process.
+  *
+  * The rate of the process follows a profile (e.g. a daily demand curve), linear between given breakpoints, and
+  * repeated or not. The timer is scheduled once per arrival (see scheduleNextArrival()), instead of being polled to
+  * update a rate, so that a whole day of arrivals costs one event per arrival.
+  *
+  * Arrivals are produced either by inversion of the cumulative rate (expected number of arrivals since time 0), which
+  * is precomputed at each breakpoint, or by thinning of a Poisson process with a piecewise constant majorant of the
+  * rate (the maximal rate of each segment of the profile).
+  */
+class ArrivalTimer : public ModuleTimer {
+public:
+    /**
+      * \brief  Methods producing the arrival times
+      */
+    enum GenerationMethod {
+        CumulativeRateInversion, ///< One exponential value and one square root per arrival (default)
+        Thinning ///< Candidate arrivals at the rate of the majorant, accepted with probability rate / majorant
+    };
+
+    /**
+      * \brief  Constructor
+      */
+    ArrivalTimer(const std::string name = std::string());
+
+    /**
+      * \brief  Sets the rate profile of the arrivals
+      * \param  times       Times of the breakpoints of the profile, in seconds, increasing, starting at 0
+      * \param  rates       Rate of arrivals at each breakpoint (arrivals per second), linear between breakpoints
+      * \param  periodic    If true, the profile is repeated every times.back() seconds. If false, the rate stays
+      *                     rates.back() after the last breakpoint.
+      */
+    void setRateProfile(const std::vector<double>& times, const std::vector<double>& rates, bool periodic = true);
+
+    /**
+      * \brief  Sets the method producing the arrival times
+      */
+    void setGenerationMethod(GenerationMethod method)
+    {
+        m_method = method;
+    }
+
+    GenerationMethod generationMethod() const
+    {
+        return m_method;
+    }
+
+    /**
+      * \brief  Returns the rate of arrivals at the given time
+      */
+    double rate(double time) const;
+
+    /**
+      * \brief  Returns the expected number of arrivals between time 0 and the given time
+      */
+    double cumulativeRate(double time) const;
+
+    /**
+      * \brief  Returns the time of the first arrival after the given time, or a negative value if there is none
+      * \param  generator   Generator of the random values
+      */
+    double nextArrivalTime(double time, Random* generator) const;
+
+    /**
+      * \brief  Schedules the timer at the first arrival after the current simulation time.
+      * \param  generator   Generator of the random values (the generator of the owner module if not given)
+      * \return false if there is no more arrival (the timer is then not scheduled)
+      */
+    bool scheduleNextArrival(Random* generator = NULL);
+
+private:
+    /**
+      * \brief  Returns the index of the segment of the profile containing the given time, taken inside the first period
+      */
+    unsigned segment(double time) const;
+
+    /**
+      * \brief  Returns the time at which the cumulative rate, taken inside the first period, reaches the given value
+      */
+    double inverseCumulativeRate(double value) const;
+
+    double arrivalByInversion(double time, Random* generator) const;
+    double arrivalByThinning(double time, Random* generator) const;
+
+    std::vector<double> m_times;
+    std::vector<double> m_rates;
+    std::vector<double> m_cumulativeRates;
+    std::vector<double> m_majorants;
+    bool m_periodic;
+    GenerationMethod m_method;
+};
+
+#endif // ARRIVALTIMER_H
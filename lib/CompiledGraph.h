@@ -0,0 +1,594 @@
+#ifndef COMPILEDGRAPH_H
+#define COMPILEDGRAPH_H
+
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/**
+  * \brief  Immutable snapshot of a graph, in compressed sparse row (CSR) form.
+  *
+  * The vertices are numbered by their index, from 0 to verticesNb() - 1, in the increasing order of their Ids. The
+  * successors of all the vertices are stored in one contiguous array, the successors of vertex i being at positions
+  * [successorsOffset(i), successorsOffset(i + 1)), and the data of each arc at the same position in a second array.
+  * The predecessors are stored the same way, with the position of each arc in the arrays of successors.
+  *
+  * A snapshot takes a few machine words per vertex and per arc (instead of the nodes of several trees per vertex in
+  * GenericGraph), and its neighbours are iterated without indirection. It is built by GenericGraph::compile(), and does
+  * not follow later changes of the graph.
+  *
+  * The arrays can also be saved in a binary file by save(), and used in place by map(): the file is mapped in memory
+  * and nothing is parsed nor copied, so that large topologies are reloaded in constant time, and shared between the
+  * processes running replications. Copies of a mapped snapshot share the mapping.
+  */
+template <typename V, typename A>
+class CompiledGraph {
+public: // Types and consts
+    typedef unsigned long VertexID;
+    typedef unsigned long VertexIndex;
+    typedef unsigned long ArcIndex;
+    static const VertexIndex IllegalVertexIndex; // = ~(VertexIndex)(0);
+    static const ArcIndex IllegalArcIndex; // = ~(ArcIndex)(0);
+
+    /**
+      * \brief  Contiguous range of vertex or arc indexes, that can be iterated without copy
+      */
+    class IndexRange {
+    public:
+        IndexRange(const unsigned long* first = 0, const unsigned long* last = 0)
+            : m_first(first)
+            , m_last(last)
+        {
+        }
+
+        const unsigned long* begin() const
+        {
+            return m_first;
+        }
+
+        const unsigned long* end() const
+        {
+            return m_last;
+        }
+
+        unsigned long size() const
+        {
+            return m_last - m_first;
+        }
+
+        bool empty() const
+        {
+            return m_first == m_last;
+        }
+
+        unsigned long operator[](unsigned long position) const
+        {
+            return m_first[position];
+        }
+
+    private:
+        const unsigned long* m_first;
+        const unsigned long* m_last;
+    };
+
+public: // Methods
+    /**
+      * \brief  Default constructor, builds an empty snapshot
+      */
+    CompiledGraph()
+        : m_vertexIds(NULL)
+        , m_vertices(NULL)
+        , m_successorsOffsets(NULL)
+        , m_successors(NULL)
+        , m_arcs(NULL)
+        , m_predecessorsOffsets(NULL)
+        , m_predecessors(NULL)
+        , m_predecessorArcs(NULL)
+        , m_verticesNb(0)
+        , m_arcsNb(0)
+        , m_contiguousIds(true)
+        , m_vertexIdsStorage()
+        , m_verticesStorage()
+        , m_successorsOffsetsStorage(1, 0)
+        , m_successorsStorage()
+        , m_arcsStorage()
+        , m_predecessorsOffsetsStorage(1, 0)
+        , m_predecessorsStorage()
+        , m_predecessorArcsStorage()
+        , m_file()
+    {
+        attachStorage();
+    }
+
+    /**
+      * \brief  Copy constructor (the arrays of a mapped snapshot are not copied, the mapping is shared)
+      */
+    CompiledGraph(const CompiledGraph& other)
+        : m_vertexIds(other.m_vertexIds)
+        , m_vertices(other.m_vertices)
+        , m_successorsOffsets(other.m_successorsOffsets)
+        , m_successors(other.m_successors)
+        , m_arcs(other.m_arcs)
+        , m_predecessorsOffsets(other.m_predecessorsOffsets)
+        , m_predecessors(other.m_predecessors)
+        , m_predecessorArcs(other.m_predecessorArcs)
+        , m_verticesNb(other.m_verticesNb)
+        , m_arcsNb(other.m_arcsNb)
+        , m_contiguousIds(other.m_contiguousIds)
+        , m_vertexIdsStorage(other.m_vertexIdsStorage)
+        , m_verticesStorage(other.m_verticesStorage)
+        , m_successorsOffsetsStorage(other.m_successorsOffsetsStorage)
+        , m_successorsStorage(other.m_successorsStorage)
+        , m_arcsStorage(other.m_arcsStorage)
+        , m_predecessorsOffsetsStorage(other.m_predecessorsOffsetsStorage)
+        , m_predecessorsStorage(other.m_predecessorsStorage)
+        , m_predecessorArcsStorage(other.m_predecessorArcsStorage)
+        , m_file(other.m_file)
+    {
+        if (!m_file)
+            attachStorage();
+    }
+
+    CompiledGraph(CompiledGraph&& other)
+        : CompiledGraph()
+    {
+        swap(other);
+    }
+
+    CompiledGraph& operator=(CompiledGraph other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    /**
+      * \brief  Exchanges the content of two snapshots, without copy
+      */
+    void swap(CompiledGraph& other);
+
+    /**
+      * \brief  Sets the content of the snapshot
+      * \param  vertexIds           Ids of the vertices, in increasing order
+      * \param  vertices            Data of each vertex
+      * \param  successorsOffsets   Position of the first successor of each vertex, followed by the number of arcs
+      * \param  successors          Index of the head of each arc, the arcs of a vertex sorted by head index
+      * \param  arcs                Data of each arc
+      */
+    void assign(std::vector<VertexID>& vertexIds, std::vector<V>& vertices, std::vector<ArcIndex>& successorsOffsets,
+        std::vector<VertexIndex>& successors, std::vector<A>& arcs);
+
+    /**
+      * \brief  Saves the snapshot in a binary file, that can be mapped by map()
+      * \return true if saving process did not encounter errors, false else.
+      *
+      * The arrays are written as they are in memory (in the native byte order), after a header giving their sizes. The
+      * vertices and arcs data are thus copied bytewise, and must not hold pointers nor resources (V and A must be
+      * trivially copyable, and can not be pointers).
+      */
+    bool save(const char* writeFileName) const;
+
+    /**
+      * \brief  Replaces the content of the snapshot by the one of a binary file written by save()
+      * \throw  std::runtime_error if the file can not be mapped, or was not saved from a snapshot of the same types on
+      *         a compatible machine
+      *
+      * The file is mapped in memory, and its arrays are used in place: only the header is checked, the pages of the
+      * arrays being read by the system when they are first accessed.
+      */
+    void map(const char* readFileName);
+
+    /**
+      * \brief  Returns true if the arrays of the snapshot are in a mapped file
+      */
+    bool isMapped() const
+    {
+        return m_file != NULL;
+    }
+
+    /**
+      * \brief  Removes all the vertices and arcs
+      */
+    void clear()
+    {
+        CompiledGraph emptyGraph;
+        swap(emptyGraph);
+    }
+
+    unsigned long verticesNb() const
+    {
+        return m_verticesNb;
+    }
+
+    unsigned long arcsNb() const
+    {
+        return m_arcsNb;
+    }
+
+    bool isEmpty() const
+    {
+        return m_verticesNb == 0;
+    }
+
+    /**
+      * \brief  Returns the index of the vertex of the given Id, or IllegalVertexIndex if there is no such vertex
+      *
+      * The index is computed directly when the Ids of the vertices are contiguous, and found by binary search else.
+      */
+    VertexIndex index(const VertexID vertexId) const
+    {
+        if (m_contiguousIds) {
+            VertexIndex index = vertexId - (m_verticesNb == 0 ? 0 : m_vertexIds[0]);
+            return index < m_verticesNb ? index : IllegalVertexIndex;
+        }
+        const VertexID* it = std::lower_bound(m_vertexIds, m_vertexIds + m_verticesNb, vertexId);
+        return it != m_vertexIds + m_verticesNb && *it == vertexId ? it - m_vertexIds : IllegalVertexIndex;
+    }
+
+    VertexID vertexId(const VertexIndex index) const
+    {
+        return m_vertexIds[index];
+    }
+
+    const V& vertex(const VertexIndex index) const
+    {
+        return m_vertices[index];
+    }
+
+    /**
+      * \brief  Returns the indexes of the successors of the given vertex, in increasing order
+      */
+    IndexRange successors(const VertexIndex index) const
+    {
+        return IndexRange(m_successors + m_successorsOffsets[index], m_successors + m_successorsOffsets[index + 1]);
+    }
+
+    /**
+      * \brief  Returns the indexes of the predecessors of the given vertex, in increasing order
+      */
+    IndexRange predecessors(const VertexIndex index) const
+    {
+        return IndexRange(m_predecessors + m_predecessorsOffsets[index], m_predecessors + m_predecessorsOffsets[index + 1]);
+    }
+
+    /**
+      * \brief  Returns the arc indexes of the arcs ending at the given vertex, in the order of predecessors()
+      */
+    IndexRange predecessorArcs(const VertexIndex index) const
+    {
+        return IndexRange(m_predecessorArcs + m_predecessorsOffsets[index], m_predecessorArcs + m_predecessorsOffsets[index + 1]);
+    }
+
+    unsigned long successorsNb(const VertexIndex index) const
+    {
+        return m_successorsOffsets[index + 1] - m_successorsOffsets[index];
+    }
+
+    unsigned long predecessorsNb(const VertexIndex index) const
+    {
+        return m_predecessorsOffsets[index + 1] - m_predecessorsOffsets[index];
+    }
+
+    /**
+      * \brief  Returns the arc index of the first arc leaving the given vertex (the arcs of vertex i are numbered from
+      *         successorsOffset(i) to successorsOffset(i + 1) - 1)
+      */
+    ArcIndex successorsOffset(const VertexIndex index) const
+    {
+        return m_successorsOffsets[index];
+    }
+
+    /**
+      * \brief  Returns the index of the arc from tail to head, or IllegalArcIndex if there is no such arc
+      */
+    ArcIndex arcIndex(const VertexIndex tail, const VertexIndex head) const
+    {
+        const VertexIndex* first = m_successors + m_successorsOffsets[tail];
+        const VertexIndex* last = m_successors + m_successorsOffsets[tail + 1];
+        const VertexIndex* it = std::lower_bound(first, last, head);
+        return it != last && *it == head ? it - m_successors : IllegalArcIndex;
+    }
+
+    VertexIndex arcHead(const ArcIndex arcIndex) const
+    {
+        return m_successors[arcIndex];
+    }
+
+    const A& arc(const ArcIndex arcIndex) const
+    {
+        return m_arcs[arcIndex];
+    }
+
+private:
+    /**
+      * \brief  Header of the binary files, followed by the arrays of the snapshot, in the order of FileArray
+      */
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t indexSize;
+        uint32_t vertexSize;
+        uint32_t arcSize;
+        uint32_t reserved;
+        uint64_t verticesNb;
+        uint64_t arcsNb;
+    };
+
+    enum FileArray {
+        VertexIdsArray,
+        VerticesArray,
+        SuccessorsOffsetsArray,
+        SuccessorsArray,
+        ArcsArray,
+        PredecessorsOffsetsArray,
+        PredecessorsArray,
+        PredecessorArcsArray,
+        FileArraysNb
+    };
+
+    static const char fileMagic[8];
+    static const uint32_t fileVersion = 1;
+    static const uint32_t fileByteOrder = 0x01020304;
+    static const size_t fileAlignment = 64; // Arrays are aligned on cache lines
+
+    /**
+      * \brief  Computes the position and size of each array in a file, and returns the size of the file
+      */
+    static size_t fileLayout(unsigned long verticesNb, unsigned long arcsNb, size_t positions[FileArraysNb], size_t sizes[FileArraysNb]);
+
+    /**
+      * \brief  Points the arrays to the vectors holding them
+      */
+    void attachStorage();
+
+    // Arrays of the snapshot, in the storage vectors below or in the mapped file
+    const VertexID* m_vertexIds;
+    const V* m_vertices;
+    const ArcIndex* m_successorsOffsets;
+    const VertexIndex* m_successors;
+    const A* m_arcs;
+    const ArcIndex* m_predecessorsOffsets;
+    const VertexIndex* m_predecessors;
+    const ArcIndex* m_predecessorArcs;
+    unsigned long m_verticesNb;
+    unsigned long m_arcsNb;
+    bool m_contiguousIds;
+
+    std::vector<VertexID> m_vertexIdsStorage;
+    std::vector<V> m_verticesStorage;
+    std::vector<ArcIndex> m_successorsOffsetsStorage;
+    std::vector<VertexIndex> m_successorsStorage;
+    std::vector<A> m_arcsStorage;
+    std::vector<ArcIndex> m_predecessorsOffsetsStorage;
+    std::vector<VertexIndex> m_predecessorsStorage;
+    std::vector<ArcIndex> m_predecessorArcsStorage;
+    std::shared_ptr<const MappedFile> m_file;
+};
+
+template <typename V, typename A>
+const typename CompiledGraph<V, A>::VertexIndex CompiledGraph<V, A>::IllegalVertexIndex = ~(VertexIndex)(0);
+
+template <typename V, typename A>
+const typename CompiledGraph<V, A>::ArcIndex CompiledGraph<V, A>::IllegalArcIndex = ~(ArcIndex)(0);
+
+template <typename V, typename A>
+const char CompiledGraph<V, A>::fileMagic[8] = { 'D', 'E', 'S', 'G', 'R', 'A', 'P', 'H' };
+
+template <typename V, typename A>
+const uint32_t CompiledGraph<V, A>::fileVersion;
+
+template <typename V, typename A>
+const uint32_t CompiledGraph<V, A>::fileByteOrder;
+
+template <typename V, typename A>
+const size_t CompiledGraph<V, A>::fileAlignment;
+
+template <typename V, typename A>
+void CompiledGraph<V, A>::attachStorage()
+{
+    m_vertexIds = m_vertexIdsStorage.data();
+    m_vertices = m_verticesStorage.data();
+    m_successorsOffsets = m_successorsOffsetsStorage.data();
+    m_successors = m_successorsStorage.data();
+    m_arcs = m_arcsStorage.data();
+    m_predecessorsOffsets = m_predecessorsOffsetsStorage.data();
+    m_predecessors = m_predecessorsStorage.data();
+    m_predecessorArcs = m_predecessorArcsStorage.data();
+    m_verticesNb = m_vertexIdsStorage.size();
+    m_arcsNb = m_successorsStorage.size();
+}
+
+template <typename V, typename A>
+void CompiledGraph<V, A>::swap(CompiledGraph& other)
+{
+    // Vectors keep their buffers when swapped, so that the arrays stay valid
+    std::swap(m_vertexIds, other.m_vertexIds);
+    std::swap(m_vertices, other.m_vertices);
+    std::swap(m_successorsOffsets, other.m_successorsOffsets);
+    std::swap(m_successors, other.m_successors);
+    std::swap(m_arcs, other.m_arcs);
+    std::swap(m_predecessorsOffsets, other.m_predecessorsOffsets);
+    std::swap(m_predecessors, other.m_predecessors);
+    std::swap(m_predecessorArcs, other.m_predecessorArcs);
+    std::swap(m_verticesNb, other.m_verticesNb);
+    std::swap(m_arcsNb, other.m_arcsNb);
+    std::swap(m_contiguousIds, other.m_contiguousIds);
+    m_vertexIdsStorage.swap(other.m_vertexIdsStorage);
+    m_verticesStorage.swap(other.m_verticesStorage);
+    m_successorsOffsetsStorage.swap(other.m_successorsOffsetsStorage);
+    m_successorsStorage.swap(other.m_successorsStorage);
+    m_arcsStorage.swap(other.m_arcsStorage);
+    m_predecessorsOffsetsStorage.swap(other.m_predecessorsOffsetsStorage);
+    m_predecessorsStorage.swap(other.m_predecessorsStorage);
+    m_predecessorArcsStorage.swap(other.m_predecessorArcsStorage);
+    m_file.swap(other.m_file);
+}
+
+template <typename V, typename A>
+void CompiledGraph<V, A>::assign(std::vector<VertexID>& vertexIds, std::vector<V>& vertices, std::vector<ArcIndex>& successorsOffsets,
+    std::vector<VertexIndex>& successors, std::vector<A>& arcs)
+{
+    const unsigned long n = vertexIds.size();
+    if (vertices.size() != n || successorsOffsets.size() != n + 1 || successorsOffsets.back() != successors.size() || arcs.size() != successors.size()) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Inconsistent sizes of the arrays of the graph (" << n << " vertices, "
+                        << successors.size() << " arcs).";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    for (VertexIndex head : successors)
+        if (head >= n) {
+            std::ostringstream exceptionStream;
+            exceptionStream << __PRETTY_FUNCTION__ << ": Arc head index " << head << " out of the " << n << " vertices.";
+            throw std::invalid_argument(exceptionStream.str());
+        }
+
+    // The arrays are taken, not copied
+    m_vertexIdsStorage.swap(vertexIds);
+    m_verticesStorage.swap(vertices);
+    m_successorsOffsetsStorage.swap(successorsOffsets);
+    m_successorsStorage.swap(successors);
+    m_arcsStorage.swap(arcs);
+    m_file.reset();
+    m_contiguousIds = m_vertexIdsStorage.empty() || m_vertexIdsStorage.back() - m_vertexIdsStorage.front() + 1 == n;
+
+    // Predecessors by counting sort of the arcs on their head (stable, so that predecessors are sorted)
+    m_predecessorsOffsetsStorage.assign(n + 1, 0);
+    for (VertexIndex head : m_successorsStorage)
+        ++m_predecessorsOffsetsStorage[head + 1];
+    for (VertexIndex i = 0; i < n; ++i)
+        m_predecessorsOffsetsStorage[i + 1] += m_predecessorsOffsetsStorage[i];
+    m_predecessorsStorage.resize(m_successorsStorage.size());
+    m_predecessorArcsStorage.resize(m_successorsStorage.size());
+    std::vector<ArcIndex> positions(m_predecessorsOffsetsStorage.begin(), m_predecessorsOffsetsStorage.end() - 1);
+    for (VertexIndex tail = 0; tail < n; ++tail)
+        for (ArcIndex arcIndex = m_successorsOffsetsStorage[tail]; arcIndex < m_successorsOffsetsStorage[tail + 1]; ++arcIndex) {
+            ArcIndex position = positions[m_successorsStorage[arcIndex]]++;
+            m_predecessorsStorage[position] = tail;
+            m_predecessorArcsStorage[position] = arcIndex;
+        }
+    attachStorage();
+}
+
+template <typename V, typename A>
+size_t CompiledGraph<V, A>::fileLayout(unsigned long verticesNb, unsigned long arcsNb, size_t positions[FileArraysNb], size_t sizes[FileArraysNb])
+{
+    sizes[VertexIdsArray] = verticesNb * sizeof(VertexID);
+    sizes[VerticesArray] = verticesNb * sizeof(V);
+    sizes[SuccessorsOffsetsArray] = (verticesNb + 1) * sizeof(ArcIndex);
+    sizes[SuccessorsArray] = arcsNb * sizeof(VertexIndex);
+    sizes[ArcsArray] = arcsNb * sizeof(A);
+    sizes[PredecessorsOffsetsArray] = (verticesNb + 1) * sizeof(ArcIndex);
+    sizes[PredecessorsArray] = arcsNb * sizeof(VertexIndex);
+    sizes[PredecessorArcsArray] = arcsNb * sizeof(ArcIndex);
+
+    size_t position = sizeof(FileHeader);
+    for (int i = 0; i < FileArraysNb; ++i) {
+        position = (position + fileAlignment - 1) / fileAlignment * fileAlignment;
+        positions[i] = position;
+        position += sizes[i];
+    }
+    return position;
+}
+
+template <typename V, typename A>
+bool CompiledGraph<V, A>::save(const char* writeFileName) const
+{
+    static_assert(std::is_trivially_copyable<V>::value && std::is_trivially_copyable<A>::value && !std::is_pointer<V>::value && !std::is_pointer<A>::value,
+        "Only snapshots of trivially copyable vertices and arcs, other than pointers, can be saved in binary files");
+    static_assert(alignof(V) <= fileAlignment && alignof(A) <= fileAlignment, "Vertices and arcs are over-aligned");
+
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, fileMagic, sizeof(header.magic));
+    header.version = fileVersion;
+    header.byteOrder = fileByteOrder;
+    header.indexSize = sizeof(ArcIndex);
+    header.vertexSize = sizeof(V);
+    header.arcSize = sizeof(A);
+    header.verticesNb = m_verticesNb;
+    header.arcsNb = m_arcsNb;
+
+    size_t positions[FileArraysNb], sizes[FileArraysNb];
+    fileLayout(m_verticesNb, m_arcsNb, positions, sizes);
+    const char* arrays[FileArraysNb] = {
+        reinterpret_cast<const char*>(m_vertexIds),
+        reinterpret_cast<const char*>(m_vertices),
+        reinterpret_cast<const char*>(m_successorsOffsets),
+        reinterpret_cast<const char*>(m_successors),
+        reinterpret_cast<const char*>(m_arcs),
+        reinterpret_cast<const char*>(m_predecessorsOffsets),
+        reinterpret_cast<const char*>(m_predecessors),
+        reinterpret_cast<const char*>(m_predecessorArcs)
+    };
+
+    std::ofstream outFile(writeFileName, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+    if (!outFile.is_open())
+        return false;
+    outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    const char padding[fileAlignment] = { 0 };
+    size_t position = sizeof(header);
+    for (int i = 0; i < FileArraysNb; ++i) {
+        outFile.write(padding, positions[i] - position);
+        outFile.write(arrays[i], sizes[i]);
+        position = positions[i] + sizes[i];
+    }
+    outFile.close();
+
+    return !outFile.fail();
+}
+
+template <typename V, typename A>
+void CompiledGraph<V, A>::map(const char* readFileName)
+{
+    static_assert(std::is_trivially_copyable<V>::value && std::is_trivially_copyable<A>::value && !std::is_pointer<V>::value && !std::is_pointer<A>::value,
+        "Only snapshots of trivially copyable vertices and arcs, other than pointers, can be mapped from binary files");
+    static_assert(alignof(V) <= fileAlignment && alignof(A) <= fileAlignment, "Vertices and arcs are over-aligned");
+
+    std::shared_ptr<const MappedFile> file = std::make_shared<const MappedFile>(readFileName);
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(file->data());
+    if (file->size() < sizeof(FileHeader) || memcmp(header->magic, fileMagic, sizeof(header->magic)) != 0
+        || header->version != fileVersion || header->byteOrder != fileByteOrder || header->indexSize != sizeof(ArcIndex)
+        || header->vertexSize != sizeof(V) || header->arcSize != sizeof(A)) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": File \"" << readFileName << "\" is not a graph of this type saved on this machine.";
+        throw std::runtime_error(exceptionStream.str());
+    }
+
+    size_t positions[FileArraysNb], sizes[FileArraysNb];
+    const unsigned long verticesNb = header->verticesNb;
+    const unsigned long arcsNb = header->arcsNb;
+    const char* data = file->data();
+    if (verticesNb > file->size() || arcsNb > file->size() || file->size() != fileLayout(verticesNb, arcsNb, positions, sizes)
+        || reinterpret_cast<const ArcIndex*>(data + positions[SuccessorsOffsetsArray])[verticesNb] != arcsNb
+        || reinterpret_cast<const ArcIndex*>(data + positions[PredecessorsOffsetsArray])[verticesNb] != arcsNb) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Graph file \"" << readFileName << "\" is truncated or corrupted.";
+        throw std::runtime_error(exceptionStream.str());
+    }
+
+    CompiledGraph mappedGraph;
+    mappedGraph.m_vertexIds = reinterpret_cast<const VertexID*>(data + positions[VertexIdsArray]);
+    mappedGraph.m_vertices = reinterpret_cast<const V*>(data + positions[VerticesArray]);
+    mappedGraph.m_successorsOffsets = reinterpret_cast<const ArcIndex*>(data + positions[SuccessorsOffsetsArray]);
+    mappedGraph.m_successors = reinterpret_cast<const VertexIndex*>(data + positions[SuccessorsArray]);
+    mappedGraph.m_arcs = reinterpret_cast<const A*>(data + positions[ArcsArray]);
+    mappedGraph.m_predecessorsOffsets = reinterpret_cast<const ArcIndex*>(data + positions[PredecessorsOffsetsArray]);
+    mappedGraph.m_predecessors = reinterpret_cast<const VertexIndex*>(data + positions[PredecessorsArray]);
+    mappedGraph.m_predecessorArcs = reinterpret_cast<const ArcIndex*>(data + positions[PredecessorArcsArray]);
+    mappedGraph.m_verticesNb = verticesNb;
+    mappedGraph.m_arcsNb = arcsNb;
+    mappedGraph.m_contiguousIds = verticesNb == 0 || mappedGraph.m_vertexIds[verticesNb - 1] - mappedGraph.m_vertexIds[0] + 1 == verticesNb;
+    mappedGraph.m_file = file;
+    swap(mappedGraph);
+}
+
+#endif // COMPILEDGRAPH_H
@@ -1,17 +1,37 @@
 #include "DESimulator.h"
+#include "GraphAlgorithms.h"
 #include "ModuleTimer.h"
 #include "MovingParticle.h"
+#include "ParallelTasks.h"
 #include "common.h"
 
+#include <atomic>
+
 DESimulator* DESimulator::m_simulator = NULL;
+thread_local DESimulator::SimulationRun* DESimulator::m_threadRun = NULL;
+
+DESimulator::SimulationRun::SimulationRun()
+    : modules()
+    , currentTime()
+    , processedModule(invalidModuleId)
+    , eventsQueue()
+    , stage(OutOfSimulationStage)
+    , generator(0)
+    , scheduledEventsNb(0)
+{
+}
 
 DESimulator::DESimulator()
     : m_simulationPattern(BasedOnModulesBehaviours)
-    , m_simulationCurrentTime()
-    , m_simulationCurrentProcessedModule(invalidModuleId)
-    , m_simulationEventsQueue()
+    , m_mainRun()
+    , m_componentRuns()
+    , m_modulesComponents()
     , m_simulationGraph(NULL)
-    , m_currentSimulationStage(OutOfSimulationStage)
+    , m_compiledSimulationGraph()
+    , m_routingTable()
+    , m_currentReplication(0)
+    , m_antitheticReplications(false)
+    , m_componentsThreadsNb(1)
 {
 }
 
@@ -30,44 +50,128 @@ DESimulator* DESimulator::theSimulator()
 
 SimulationTime DESimulator::simTime()
 {
-    return theSimulator()->m_simulationCurrentTime;
+    return theSimulator()->currentRun().currentTime;
 }
 
 ModuleId DESimulator::processedModule()
 {
-    return theSimulator()->m_simulationCurrentProcessedModule;
+    return theSimulator()->currentRun().processedModule;
 }
 
-void DESimulator::simulate(const SimulationTime& maxSimTime, unsigned simulationsNumber)
+unsigned DESimulator::replication()
+{
+    return theSimulator()->m_currentReplication;
+}
+
+void DESimulator::simulate(const SimulationTime& maxSimTime, unsigned simulationsNumber, unsigned firstReplication)
 {
     if (!m_simulationGraph)
         throw std::runtime_error("Launching simulation before assigning simulation graph.");
 
-    m_simulationCurrentProcessedModule = invalidModuleId;
-    m_currentSimulationStage = OutOfSimulationStage;
+    // Components are only simulated apart when there are several of them, and several threads
+    const unsigned componentsThreadsNb = std::min<unsigned long>(ParallelTasks::threadsNb(m_componentsThreadsNb), m_componentRuns.size());
+
+    m_mainRun.processedModule = invalidModuleId;
+    m_mainRun.stage = OutOfSimulationStage;
     for (unsigned i = 0; i < simulationsNumber; i++) {
-        m_simulationCurrentTime = 0.;
+        m_mainRun.currentTime = 0.;
+        m_currentReplication = firstReplication + i;
+        if (m_antitheticReplications) {
+            Random::Generate()->setReplication(m_currentReplication / 2);
+            Random::Generate()->setAntithetic(m_currentReplication % 2);
+        } else
+            Random::Generate()->setReplication(m_currentReplication);
+        setComponentsGenerators();
+
+        if (componentsThreadsNb > 1) {
+            simulateComponents(maxSimTime, i, componentsThreadsNb);
+            continue;
+        }
 
-        m_simulationCurrentProcessedModule = invalidModuleId;
-        m_currentSimulationStage = InitializationStage;
+        m_mainRun.processedModule = invalidModuleId;
+        m_mainRun.stage = InitializationStage;
         prepareSimulation(i);
 
-        m_simulationCurrentProcessedModule = invalidModuleId;
-        m_currentSimulationStage = EventsSimulationStage;
-        makeSimulation(maxSimTime, i);
+        m_mainRun.processedModule = invalidModuleId;
+        m_mainRun.stage = EventsSimulationStage;
+        try {
+            makeSimulation(maxSimTime, i);
+        } catch (...) {
+            Random::setThreadGenerator(NULL);
+            throw;
+        }
+        Random::setThreadGenerator(NULL);
 
-        m_simulationCurrentProcessedModule = invalidModuleId;
-        m_currentSimulationStage = PostProcessingStage;
+        m_mainRun.processedModule = invalidModuleId;
+        m_mainRun.stage = PostProcessingStage;
         postProcessSimulation(i);
 
-        m_simulationCurrentProcessedModule = invalidModuleId;
-        m_currentSimulationStage = OutOfSimulationStage;
+        m_mainRun.processedModule = invalidModuleId;
+        m_mainRun.stage = OutOfSimulationStage;
+    }
+    Random::Generate()->setAntithetic(false);
+}
+
+void DESimulator::simulateComponents(const SimulationTime& maxSimTime, unsigned currentSimulationId, unsigned threadsNb)
+{
+    try {
+        // The calling thread prepares the components in turn, each scheduling its first events in its own queue
+        m_mainRun.stage = InitializationStage;
+        for (SimulationRun& run : m_componentRuns) {
+            m_threadRun = &run;
+            run.currentTime = 0.;
+            run.processedModule = invalidModuleId;
+            run.stage = InitializationStage;
+            prepareSimulation(currentSimulationId);
+            run.processedModule = invalidModuleId;
+            run.stage = EventsSimulationStage;
+        }
+        m_threadRun = NULL;
+
+        // Each thread takes the next component left, and simulates its events with the generator of the component
+        m_mainRun.stage = EventsSimulationStage;
+        std::atomic<unsigned long> nextComponent(0);
+        ParallelTasks::run(threadsNb, [&](unsigned) {
+            unsigned long component;
+            while ((component = nextComponent++) < m_componentRuns.size()) {
+                Random::setThreadGenerator(&m_componentRuns[component].generator);
+                m_threadRun = &m_componentRuns[component];
+                try {
+                    makeSimulation(maxSimTime, currentSimulationId);
+                } catch (...) {
+                    m_threadRun = NULL;
+                    Random::setThreadGenerator(NULL);
+                    throw;
+                }
+                m_threadRun = NULL;
+                Random::setThreadGenerator(NULL);
+            }
+        });
+
+        // The calling thread post-processes the components in turn, the simulation ending with the last of them
+        m_mainRun.stage = PostProcessingStage;
+        for (SimulationRun& run : m_componentRuns) {
+            m_threadRun = &run;
+            run.processedModule = invalidModuleId;
+            run.stage = PostProcessingStage;
+            postProcessSimulation(currentSimulationId);
+            run.processedModule = invalidModuleId;
+            run.stage = OutOfSimulationStage;
+            if (m_mainRun.currentTime < run.currentTime)
+                m_mainRun.currentTime = run.currentTime;
+        }
+        m_threadRun = NULL;
+        m_mainRun.stage = OutOfSimulationStage;
+    } catch (...) {
+        m_threadRun = NULL;
+        throw;
     }
 }
 
 void DESimulator::prepareSimulation(unsigned currentSimulationId)
 {
-    m_simulationCurrentProcessedModule = invalidModuleId;
+    SimulationRun& run = currentRun();
+    run.processedModule = invalidModuleId;
 
     // Call initialization methods of all the modules of this simulation
     if (!m_simulationGraph) {
@@ -76,20 +180,23 @@ void DESimulator::prepareSimulation(unsigned currentSimulationId)
         throw std::runtime_error(exceptionStream.str());
     }
 
-    if (m_currentSimulationStage != InitializationStage) {
+    if (run.stage != InitializationStage) {
         std::ostringstream exceptionStream;
         exceptionStream << __PRETTY_FUNCTION__ << ": Launching simulation initialization out of initialization stage.";
         throw std::runtime_error(exceptionStream.str());
     }
 
-    for (ModuleId initializedModule : m_simulationGraph->vertices()) {
-        m_simulationCurrentProcessedModule = m_simulationGraph->vertex(initializedModule)->id();
-        m_simulationGraph->vertex(initializedModule)->sim_getReady();
+    for (CompiledSimulationGraph::VertexIndex i : run.modules) {
+        SimulationModule* initializedModule = m_compiledSimulationGraph.vertex(i);
+        run.processedModule = initializedModule->id();
+        initializedModule->sim_getReady();
     }
 }
 
 void DESimulator::postProcessSimulation(unsigned currentSimulationId)
 {
+    SimulationRun& run = currentRun();
+
     // Call post-processing methods of all the modules of this simulation
     if (!m_simulationGraph) {
         std::ostringstream exceptionStream;
@@ -97,33 +204,36 @@ void DESimulator::postProcessSimulation(unsigned currentSimulationId)
         throw std::runtime_error(exceptionStream.str());
     }
 
-    if (m_currentSimulationStage != PostProcessingStage) {
+    if (run.stage != PostProcessingStage) {
         std::ostringstream exceptionStream;
         exceptionStream << __PRETTY_FUNCTION__ << ": Launching simulation finalization out of post-processing stage.";
         throw std::runtime_error(exceptionStream.str());
     }
 
-    for (ModuleId module : m_simulationGraph->vertices()) {
-        m_simulationCurrentProcessedModule = m_simulationGraph->vertex(module)->id();
-        m_simulationGraph->vertex(module)->sim_terminate();
+    for (CompiledSimulationGraph::VertexIndex i : run.modules) {
+        SimulationModule* terminatedModule = m_compiledSimulationGraph.vertex(i);
+        run.processedModule = terminatedModule->id();
+        terminatedModule->sim_terminate();
     }
 }
 
 void DESimulator::makeSimulation(const SimulationTime& maxSimTime, unsigned currentSimulationId)
 {
+    SimulationRun& run = currentRun();
+    tSimulationEventQueue& eventsQueue = run.eventsQueue;
     while (1) {
-        if (m_simulationEventsQueue.empty())
+        if (eventsQueue.empty())
             // No more events to simulate => simulation ends
             break;
 
-        if ((maxSimTime != 0) && (m_simulationEventsQueue.top()->occurrenceTime() > maxSimTime))
+        if ((maxSimTime != 0) && (eventsQueue.top()->occurrenceTime() > maxSimTime))
             // The next coming event has an occurrence time greater than the limit => end simulation before processing it
             break;
 
         // 1 -  Get an event (with the smallest simulation time) from the simulation queue,
         //      and remove that event from the queue of future events
-        SimulationEvent* currentEvent = m_simulationEventsQueue.top();
-        m_simulationEventsQueue.pop();
+        SimulationEvent* currentEvent = eventsQueue.top();
+        eventsQueue.pop();
 
         // 2 -  Check simulator's sanity
         if (!currentEvent->isScheduled()) {
@@ -133,7 +243,7 @@ void DESimulator::makeSimulation(const SimulationTime& maxSimTime, unsigned curr
         }
         currentEvent->cancelScheduling();
 
-        if (m_simulationCurrentTime > currentEvent->occurrenceTime()) // Meaning this event should have been executed in the past
+        if (run.currentTime > currentEvent->occurrenceTime()) // Meaning this event should have been executed in the past
         {
             std::ostringstream exceptionStream;
             exceptionStream << __PRETTY_FUNCTION__ << ": Retrieved an event whose execution time has already passed.";
@@ -143,16 +253,20 @@ void DESimulator::makeSimulation(const SimulationTime& maxSimTime, unsigned curr
         // Ok, everything is fine ... we can proceed
 
         // 3 -  Make the time jump to this event execution time
-        m_simulationCurrentTime = currentEvent->occurrenceTime();
+        run.currentTime = currentEvent->occurrenceTime();
 
         // 4 -  Check if this event is a timer ...
         ModuleTimer* currentTimer = dynamic_cast<ModuleTimer*>(currentEvent);
         if (currentTimer) {
-            m_simulationCurrentProcessedModule = currentTimer->ownerModuleId();
+            run.processedModule = currentTimer->ownerModuleId();
+            if (m_threadRun)
+                checkEventComponent(run.processedModule);
+            else if (m_componentRuns.size() > 1)
+                useComponentGenerator(run.processedModule);
             switch (m_simulationPattern) {
             case BasedOnModulesBehaviours:
                 // call the module's right method with currentTimer as argument
-                m_simulationGraph->vertex(currentTimer->ownerModuleId())->sim_handleTimerTriggering(currentTimer);
+                eventModule(currentTimer->ownerModuleId())->sim_handleTimerTriggering(currentTimer);
                 break;
             case BasedOnParticlesBehaviours:
                 currentTimer->sim_handleTriggering();
@@ -164,18 +278,22 @@ void DESimulator::makeSimulation(const SimulationTime& maxSimTime, unsigned curr
             } break;
             }
 
-            m_simulationCurrentProcessedModule = invalidModuleId;
+            run.processedModule = invalidModuleId;
             continue;
         }
 
         // 5-   ... or a moving particle arriving at some module
         MovingParticle* currentParticle = dynamic_cast<MovingParticle*>(currentEvent);
         if (currentParticle) {
-            m_simulationCurrentProcessedModule = currentParticle->nextModule();
+            run.processedModule = currentParticle->nextModule();
+            if (m_threadRun)
+                checkEventComponent(run.processedModule);
+            else if (m_componentRuns.size() > 1)
+                useComponentGenerator(run.processedModule);
             switch (m_simulationPattern) {
             case BasedOnModulesBehaviours:
                 // call the module's right method with currentParticle as argument
-                m_simulationGraph->vertex(currentParticle->nextModule())->sim_handleParticleArrival(currentParticle);
+                eventModule(currentParticle->nextModule())->sim_handleParticleArrival(currentParticle);
                 break;
             case BasedOnParticlesBehaviours:
                 currentParticle->sim_handleArrivalAtModule();
@@ -187,7 +305,7 @@ void DESimulator::makeSimulation(const SimulationTime& maxSimTime, unsigned curr
             } break;
             }
 
-            m_simulationCurrentProcessedModule = invalidModuleId;
+            run.processedModule = invalidModuleId;
             continue;
         }
 
@@ -198,6 +316,45 @@ void DESimulator::makeSimulation(const SimulationTime& maxSimTime, unsigned curr
     }
 }
 
+SimulationModule* DESimulator::eventModule(const ModuleId moduleId) const
+{
+    SimulationModule* eventModule = module(moduleId);
+    if (!eventModule) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Retrieved an event of module " << moduleId << ", which is not in the simulation graph.";
+        throw std::runtime_error(exceptionStream.str());
+    }
+    return eventModule;
+}
+
+void DESimulator::checkEventComponent(const ModuleId moduleId) const
+{
+    CompiledSimulationGraph::VertexIndex index = m_compiledSimulationGraph.index(moduleId);
+    if (index != CompiledSimulationGraph::IllegalVertexIndex && &m_componentRuns[m_modulesComponents[index]] != m_threadRun) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Retrieved an event of module " << moduleId << ", which is in another component of the simulation graph.";
+        throw std::runtime_error(exceptionStream.str());
+    }
+}
+
+void DESimulator::setComponentsGenerators()
+{
+    if (m_componentRuns.size() < 2)
+        return;
+    const Random* defaultGenerator = Random::defaultGenerator();
+    for (unsigned long component = 0; component < m_componentRuns.size(); ++component) {
+        std::ostringstream substreamName;
+        substreamName << "component" << component;
+        m_componentRuns[component].generator = defaultGenerator->substream(substreamName.str());
+    }
+}
+
+void DESimulator::useComponentGenerator(const ModuleId moduleId)
+{
+    CompiledSimulationGraph::VertexIndex index = m_compiledSimulationGraph.index(moduleId);
+    Random::setThreadGenerator(index != CompiledSimulationGraph::IllegalVertexIndex ? &m_componentRuns[m_modulesComponents[index]].generator : NULL);
+}
+
 DESimulator::SimulationPattern DESimulator::simulationPattern()
 {
     return theSimulator()->m_simulationPattern;
@@ -218,14 +375,40 @@ void DESimulator::setSimulationPattern(const DESimulator::SimulationPattern newP
     }
 }
 
+bool DESimulator::antitheticReplications()
+{
+    return theSimulator()->m_antitheticReplications;
+}
+
+void DESimulator::setAntitheticReplications(bool antithetic)
+{
+    theSimulator()->m_antitheticReplications = antithetic;
+}
+
+unsigned DESimulator::componentsThreadsNb()
+{
+    return theSimulator()->m_componentsThreadsNb;
+}
+
+void DESimulator::setComponentsThreadsNb(unsigned threadsNb)
+{
+    if (isCurrentlySimulating()) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Changing the number of threads of the components while simulating.";
+        throw std::runtime_error(exceptionStream.str());
+    }
+
+    theSimulator()->m_componentsThreadsNb = threadsNb;
+}
+
 DESimulator::SimulationStage DESimulator::simulationStage()
 {
-    return theSimulator()->m_currentSimulationStage;
+    return theSimulator()->currentRun().stage;
 }
 
 bool DESimulator::isCurrentlySimulating()
 {
-    return (theSimulator()->m_currentSimulationStage != OutOfSimulationStage);
+    return (theSimulator()->currentRun().stage != OutOfSimulationStage);
 }
 
 void DESimulator::initiateSimulator(DESimulator::SimulationGraph* const simulationGraph)
@@ -234,15 +417,30 @@ void DESimulator::initiateSimulator(DESimulator::SimulationGraph* const simulati
 
     if (simulationGraph) {
         m_simulationGraph = simulationGraph;
-        for (ModuleId moduleId : m_simulationGraph->vertices()) {
-            m_simulationGraph->vertex(moduleId)->sim_setNeighbours(
-                m_simulationGraph->predecessors(moduleId),
-                m_simulationGraph->successors(moduleId));
+        m_compiledSimulationGraph = m_simulationGraph->compile();
+
+        std::vector<ModuleId> sources, destinations;
+        for (unsigned long i = 0; i < m_compiledSimulationGraph.verticesNb(); ++i) {
+            sources.clear();
+            for (unsigned long source : m_compiledSimulationGraph.predecessors(i))
+                sources.push_back(m_compiledSimulationGraph.vertexId(source));
+            destinations.clear();
+            for (unsigned long destination : m_compiledSimulationGraph.successors(i))
+                destinations.push_back(m_compiledSimulationGraph.vertexId(destination));
+            m_compiledSimulationGraph.vertex(i)->sim_setNeighbours(sources, destinations);
         }
+
+        // No particle flows between the weakly connected components, which may so be simulated apart
+        m_mainRun.modules.resize(m_compiledSimulationGraph.verticesNb());
+        for (unsigned long i = 0; i < m_mainRun.modules.size(); ++i)
+            m_mainRun.modules[i] = i;
+        m_componentRuns.resize(GraphAlgorithms<SimulationModule*, int>::weaklyConnectedComponents(m_compiledSimulationGraph, m_modulesComponents));
+        for (unsigned long i = 0; i < m_modulesComponents.size(); ++i)
+            m_componentRuns[m_modulesComponents[i]].modules.push_back(i);
     }
 
-    m_currentSimulationStage = OutOfSimulationStage;
-    m_simulationCurrentTime = 0;
+    m_mainRun.stage = OutOfSimulationStage;
+    m_mainRun.currentTime = 0;
 }
 
 void DESimulator::cleanupSimulator()
@@ -253,16 +451,45 @@ void DESimulator::cleanupSimulator()
         throw std::runtime_error(exceptionStream.str());
     }
 
-    while (!m_simulationEventsQueue.empty()) {
-        SimulationEvent* event = m_simulationEventsQueue.top();
-        m_simulationEventsQueue.pop();
-        delete event;
-    }
+    std::vector<tSimulationEventQueue*> eventsQueues(1, &m_mainRun.eventsQueue);
+    for (SimulationRun& run : m_componentRuns)
+        eventsQueues.push_back(&run.eventsQueue);
+    for (tSimulationEventQueue* eventsQueue : eventsQueues)
+        while (!eventsQueue->empty()) {
+            SimulationEvent* event = eventsQueue->top();
+            eventsQueue->pop();
+            delete event;
+        }
     if (m_simulationGraph) {
         delete m_simulationGraph;
         m_simulationGraph = NULL;
     }
-    m_simulationCurrentTime = 0;
+    m_compiledSimulationGraph.clear();
+    m_routingTable.clear();
+    m_mainRun.modules.clear();
+    m_componentRuns.clear();
+    m_modulesComponents.clear();
+    m_mainRun.currentTime = 0;
+}
+
+void DESimulator::computeRoutingTable(const std::vector<ModuleId>& destinationIds, const SimulationRoutingTable::ArcWeight& arcWeight, unsigned threadsNb)
+{
+    if (destinationIds.empty()) {
+        m_routingTable = SimulationRoutingTable(m_compiledSimulationGraph, arcWeight, threadsNb);
+        return;
+    }
+
+    std::vector<CompiledSimulationGraph::VertexIndex> destinations;
+    for (ModuleId destinationId : destinationIds) {
+        CompiledSimulationGraph::VertexIndex destination = m_compiledSimulationGraph.index(destinationId);
+        if (destination == CompiledSimulationGraph::IllegalVertexIndex) {
+            std::ostringstream exceptionStream;
+            exceptionStream << __PRETTY_FUNCTION__ << ": No module of Id " << destinationId << " in the simulation graph.";
+            throw std::invalid_argument(exceptionStream.str());
+        }
+        destinations.push_back(destination);
+    }
+    m_routingTable = SimulationRoutingTable(m_compiledSimulationGraph, destinations, arcWeight, threadsNb);
 }
 
 void DESimulator::scheduleFutureEvent(SimulationEvent* futureEvent)
@@ -273,7 +500,9 @@ void DESimulator::scheduleFutureEvent(SimulationEvent* futureEvent)
         throw std::runtime_error(exceptionStream.str());
     }
 
-    m_simulationEventsQueue.push(futureEvent);
+    SimulationRun& run = currentRun();
+    futureEvent->m_schedulingRank = run.scheduledEventsNb++;
+    run.eventsQueue.push(futureEvent);
 }
 
 void DESimulator::cancelFutureEvent(SimulationEvent* futureEventToCancel)
@@ -287,14 +516,15 @@ void DESimulator::cancelFutureEvent(SimulationEvent* futureEventToCancel)
     if (!futureEventToCancel->isScheduled())
         return;
 
+    tSimulationEventQueue& eventsQueue = currentRun().eventsQueue;
     SimulationEvent* tmpEvent;
     DESimulator::tSimulationEventQueue tmpQueue;
     while (1) {
-        if (m_simulationEventsQueue.empty())
+        if (eventsQueue.empty())
             break;
 
-        tmpEvent = m_simulationEventsQueue.top();
-        m_simulationEventsQueue.pop();
+        tmpEvent = eventsQueue.top();
+        eventsQueue.pop();
 
         if (tmpEvent == futureEventToCancel)
             break; // DO not insert in tmpQueue, and stop searching
@@ -302,7 +532,7 @@ void DESimulator::cancelFutureEvent(SimulationEvent* futureEventToCancel)
     }
 
     while (!tmpQueue.empty()) {
-        m_simulationEventsQueue.push(tmpQueue.top());
+        eventsQueue.push(tmpQueue.top());
         tmpQueue.pop();
     }
 }
@@ -2,6 +2,7 @@
 #define DESIMULATOR_H
 
 #include "GenericGraph.h"
+#include "NextHopTable.h"
 #include "SimulationEvent.h"
 #include "SimulationModule.h"
 #include "SimulationTime.h"
@@ -16,11 +17,13 @@
  *  This operator is used in the simulator's  queue of  future events. Using this operator, the queue of particles is always
  *  sorted: the Particle with the smaller next arrival time is the first, ..., and the Particle with the greatest next arrival
  *  time is the last in the queue. Even when adding new Particles to the queue, this property is kept.
+ *  Simultaneous events come in the order they were scheduled, whatever the other events of the queue.
  */
 struct SimulationEventCmp {
     inline bool operator()(const SimulationEvent* pr1, const SimulationEvent* pr2) const
     {
-        return pr1->occurrenceTime() > pr2->occurrenceTime();
+        return pr1->occurrenceTime() > pr2->occurrenceTime()
+            || (pr1->occurrenceTime() == pr2->occurrenceTime() && pr1->schedulingRank() > pr2->schedulingRank());
     }
 };
 
@@ -55,9 +58,19 @@ public:
     typedef std::priority_queue<SimulationEvent*, std::deque<SimulationEvent*>, SimulationEventCmp> tSimulationEventQueue;
 
     /**
-      * \brief
+      * \brief  Graph of the simulated modules, whose Ids are the ones of the modules (so dense, as generated)
+      */
+    typedef GenericGraph<SimulationModule*, int, true, SimulationModulePtrCmp, HashedGraphStorage<SimulationModulePtrHash>> SimulationGraph;
+
+    /**
+      * \brief  Snapshot of the simulation graph, used while simulating
       */
-    typedef GenericGraph<SimulationModule*, int, true, SimulationModulePtrCmp> SimulationGraph;
+    typedef CompiledGraph<SimulationModule*, int> CompiledSimulationGraph;
+
+    /**
+      * \brief  Next-hop table of the simulation graph, used by the modules to forward particles
+      */
+    typedef NextHopTable<SimulationModule*, int> SimulationRoutingTable;
 
     /**
       *
@@ -75,7 +88,16 @@ public:
     static ModuleId processedModule();
 
     /**
+      * \brief  Returns the index of the replication being simulated (or of the last simulated one)
+      */
+    static unsigned replication();
+
+    /**
+      * \brief  Sets the graph of the modules to simulate, which is then owned by the simulator.
       *
+      * The graph is compiled into a snapshot (see GenericGraph::compile()), from which the neighbours of the modules are
+      * set, and the modules found while simulating. The graph must so not be changed after this call. Its weakly
+      * connected components, between which no particle can flow, are found too (see setComponentsThreadsNb()).
       */
     void initiateSimulator(SimulationGraph* const simulationGraph);
 
@@ -85,9 +107,18 @@ public:
     void cleanupSimulator();
 
     /**
-      * \param  maxSimTime  maximum simulation time for a single simulation (if equal to 0, then the simulations are done until no more events have to be simulated)
+      * \brief  Runs simulationsNumber replications of the simulation.
+      *
+      * Replication i draws all its random numbers from the streams of replication index firstReplication + i (or from
+      * the streams of a pair of replications, see setAntitheticReplications()): the default generator (see
+      * Random::Generate()) and the modules generators are moved to these streams before the replication starts.
+      * Replications are so independent, and any of them can be reproduced alone, given the seed of the default
+      * generator and its replication index.
+      * \param  maxSimTime          maximum simulation time for a single simulation (if equal to 0, then the simulations are done until no more events have to be simulated)
+      * \param  simulationsNumber   number of replications to run
+      * \param  firstReplication    replication index of the first replication
       */
-    void simulate(const SimulationTime& maxSimTime, unsigned simulationsNumber = 1);
+    void simulate(const SimulationTime& maxSimTime, unsigned simulationsNumber = 1, unsigned firstReplication = 0);
 
     /**
       * \brief
@@ -99,6 +130,51 @@ public:
       */
     static void setSimulationPattern(const SimulationPattern newPattern);
 
+    /**
+      * \brief  Returns true if replications are simulated by antithetic pairs
+      */
+    static bool antitheticReplications();
+
+    /**
+      * \brief  Sets whether replications are simulated by antithetic pairs.
+      *
+      * Replications 2k and 2k+1 then draw from the streams of the same replication index k, the second one drawing the
+      * complements of the values drawn by the first one (see Random::setAntithetic()). The negatively correlated results
+      * of a pair reduce the variance of their mean.
+      */
+    static void setAntitheticReplications(bool antithetic);
+
+    /**
+      * \brief  Returns the number of threads simulating the components of the simulation graph (see
+      *         setComponentsThreadsNb())
+      */
+    static unsigned componentsThreadsNb();
+
+    /**
+      * \brief  Sets the number of threads simulating the components of the simulation graph: 1 (the default) simulates
+      *         the whole graph at once, 0 uses the number of hardware threads.
+      *
+      * With several threads, each weakly connected component of the graph is simulated independently, with its own
+      * events queue and its own simulation time, the threads taking the components in turn. The modules of all the
+      * components are still prepared, then post-processed, one after the other by the calling thread, so that
+      * getReady() and terminate() may gather results; only the events are simulated in parallel. The modules must so
+      * not share any data while handling events, and particles must stay in their component.
+      *
+      * Whenever the graph has several components, the values drawn from Random::Generate() while handling the events
+      * of a component come from a substream of this component, and the input generators of the modules (see
+      * SimulationModule::inputGenerator()) from substreams of the default generator: a simulation gives the same
+      * results whatever the number of threads, 1 included.
+      */
+    static void setComponentsThreadsNb(unsigned threadsNb);
+
+    /**
+      * \brief  Returns the number of weakly connected components of the simulation graph
+      */
+    unsigned long componentsNb() const
+    {
+        return m_componentRuns.size();
+    }
+
     /**
       *
       */
@@ -129,6 +205,55 @@ public:
         return m_simulationGraph;
     }
 
+    /**
+      * \brief  Returns the snapshot of the simulation graph, built by initiateSimulator()
+      */
+    const CompiledSimulationGraph& getCompiledSimulationGraph() const
+    {
+        return m_compiledSimulationGraph;
+    }
+
+    /**
+      * \brief  Returns the module of the given Id in the simulation graph, or NULL if there is no such module
+      */
+    SimulationModule* module(const ModuleId moduleId) const
+    {
+        CompiledSimulationGraph::VertexIndex index = m_compiledSimulationGraph.index(moduleId);
+        return index == CompiledSimulationGraph::IllegalVertexIndex ? NULL : m_compiledSimulationGraph.vertex(index);
+    }
+
+    /**
+      * \brief  Computes the routing table of the simulation graph, from which the modules find the neighbour to which
+      *         particles are forwarded to reach a destination (see nextHop()).
+      * \param  destinationIds  Ids of the destination modules (all the modules if empty)
+      * \param  arcWeight       weight of the arcs (the number of arcs if empty), called concurrently
+      * \param  threadsNb       number of threads computing the table (the number of hardware threads if 0)
+      *
+      * The table is computed once, from the snapshot of the graph, and is kept until cleanupSimulator(): it must so be
+      * computed after initiateSimulator().
+      */
+    void computeRoutingTable(const std::vector<ModuleId>& destinationIds = std::vector<ModuleId>(),
+        const SimulationRoutingTable::ArcWeight& arcWeight = SimulationRoutingTable::ArcWeight(), unsigned threadsNb = 0);
+
+    /**
+      * \brief  Returns the routing table, computed by computeRoutingTable()
+      */
+    const SimulationRoutingTable& getRoutingTable() const
+    {
+        return m_routingTable;
+    }
+
+    /**
+      * \brief  Returns, in constant time, the neighbour of a module on a shortest path to the given destination
+      * \return Id of the neighbour module, or invalidModuleId if the module is the destination, can not reach it, or if
+      *         the destination is not in the routing table
+      */
+    ModuleId nextHop(const ModuleId moduleId, const ModuleId destinationId) const
+    {
+        CompiledSimulationGraph::VertexIndex hop = m_routingTable.nextHop(m_compiledSimulationGraph.index(moduleId), m_compiledSimulationGraph.index(destinationId));
+        return hop == CompiledSimulationGraph::IllegalVertexIndex ? invalidModuleId : m_compiledSimulationGraph.vertexId(hop);
+    }
+
 protected:
     /**
       * \brief
@@ -149,18 +274,78 @@ protected:
     void postProcessSimulation(unsigned currentSimulationId);
 
 private:
+    /**
+      * \brief  State of a run of the simulation: of the whole graph, or of one of its components
+      */
+    struct SimulationRun {
+        std::vector<CompiledSimulationGraph::VertexIndex> modules; ///< Indexes of the modules in the snapshot
+        SimulationTime currentTime;
+        ModuleId processedModule;
+        tSimulationEventQueue eventsQueue;
+        SimulationStage stage;
+        Random generator; ///< Generator returned by Random::Generate() while the events of a component are simulated
+        unsigned long long scheduledEventsNb; ///< Events scheduled so far, ranking the simultaneous events
+
+        SimulationRun();
+    };
+
     DESimulator();
 
+    /**
+      * \brief  Returns the run of the calling thread: the run of a component while components are simulated, the run
+      *         of the whole graph else
+      */
+    SimulationRun& currentRun()
+    {
+        return m_threadRun ? *m_threadRun : m_mainRun;
+    }
+
+    const SimulationRun& currentRun() const
+    {
+        return m_threadRun ? *m_threadRun : m_mainRun;
+    }
+
+    /**
+      * \brief  Runs a replication of each component, with the given number of threads
+      */
+    void simulateComponents(const SimulationTime& maxSimTime, unsigned currentSimulationId, unsigned threadsNb);
+
+    /**
+      * \brief  Gives each component the generator of its substream, for the current replication
+      */
+    void setComponentsGenerators();
+
+    /**
+      * \brief  Sets the generator of the component of the given module to the calling thread
+      */
+    void useComponentGenerator(const ModuleId moduleId);
+
+    /**
+      * \brief  Returns the module of the given Id, which handles an event
+      * \throw  std::runtime_error if there is no such module in the simulation graph
+      */
+    SimulationModule* eventModule(const ModuleId moduleId) const;
+
+    /**
+      * \brief  Checks that an event of a module is handled by the run of its component
+      * \throw  std::runtime_error if the module is in another component
+      */
+    void checkEventComponent(const ModuleId moduleId) const;
+
     static DESimulator* m_simulator;
+    static thread_local SimulationRun* m_threadRun;
 
     //  Real simulator data
     SimulationPattern m_simulationPattern;
-    SimulationTime m_simulationCurrentTime;
-    ModuleId m_simulationCurrentProcessedModule;
-    tSimulationEventQueue m_simulationEventsQueue;
+    SimulationRun m_mainRun;
+    std::vector<SimulationRun> m_componentRuns;
+    std::vector<unsigned long> m_modulesComponents; ///< Component of each module, by index in the snapshot
     SimulationGraph* m_simulationGraph;
-
-    SimulationStage m_currentSimulationStage;
+    CompiledSimulationGraph m_compiledSimulationGraph;
+    SimulationRoutingTable m_routingTable;
+    unsigned m_currentReplication;
+    bool m_antitheticReplications;
+    unsigned m_componentsThreadsNb;
 };
 
 #endif // DESIMULATOR_H
@@ -0,0 +1,431 @@
+#ifndef DENSEIDMAP_H
+#define DENSEIDMAP_H
+
+#include "OpenAddressingMap.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
+
+/**
+  * \brief  Associative container of elements keyed by an Id, stored in a vector indexed by the Id while the Ids are dense.
+  *
+  * Lookups are a subtraction and an indexing, and iteration goes through the elements in increasing order of their Ids,
+  * like a std::map. The vector spans from the lowest to the highest Id inserted, and grows geometrically at both ends,
+  * so that the Ids can be inserted in any order. As for a vector, inserting an element invalidates the iterators and
+  * the references to the elements.
+  *
+  * When the Ids become sparse (they span more than sparseSpanFactor times the elements, and more than minSparseSpan
+  * Ids), e.g. GraphML numeric ids or user Ids of very different magnitudes, the elements move to an ordered map, still
+  * found in constant time through a hash table of their Ids, until the container is cleared.
+  *
+  * Only the part of the interface of std::map used by the graphs is provided.
+  */
+template <typename T>
+class DenseIdMap {
+public: // Types
+    typedef unsigned long key_type;
+    typedef T mapped_type;
+    typedef std::pair<unsigned long, T> value_type;
+    typedef std::size_t size_type;
+
+    /**
+      * \brief  Smallest span of Ids for which the Ids can be considered sparse
+      */
+    static const size_type minSparseSpan = 4096;
+
+    /**
+      * \brief  Number of Ids spanned by element above which the Ids are considered sparse
+      */
+    static const size_type sparseSpanFactor = 4;
+
+private:
+    struct Slot {
+        Slot()
+            : value()
+            , used(false)
+        {
+        }
+        value_type value;
+        bool used;
+    };
+    typedef std::vector<Slot> SlotSet;
+    typedef std::map<unsigned long, value_type> SparseElements;
+    typedef OpenAddressingMap<unsigned long, typename SparseElements::iterator> SparseIndex;
+
+    template <class Value, class Map, class SparseIterator>
+    class BaseIterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename DenseIdMap::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Value* pointer;
+        typedef Value& reference;
+
+        explicit BaseIterator(Map* map = 0, size_type position = 0)
+            : m_map(map)
+            , m_position(position)
+            , m_sparseIt()
+        {
+            skipUnused();
+        }
+
+        BaseIterator(Map* map, SparseIterator sparseIt)
+            : m_map(map)
+            , m_position(0)
+            , m_sparseIt(sparseIt)
+        {
+        }
+
+        // Conversion from iterator to const_iterator
+        template <class OtherValue, class OtherMap, class OtherSparseIterator>
+        BaseIterator(const BaseIterator<OtherValue, OtherMap, OtherSparseIterator>& other)
+            : m_map(other.m_map)
+            , m_position(other.m_position)
+            , m_sparseIt(other.m_sparseIt)
+        {
+        }
+
+        reference operator*() const
+        {
+            return m_map->m_sparse ? m_sparseIt->second : m_map->m_slots[m_position].value;
+        }
+
+        pointer operator->() const
+        {
+            return &operator*();
+        }
+
+        BaseIterator& operator++()
+        {
+            if (m_map->m_sparse)
+                ++m_sparseIt;
+            else {
+                ++m_position;
+                skipUnused();
+            }
+            return *this;
+        }
+
+        BaseIterator operator++(int)
+        {
+            BaseIterator previous(*this);
+            ++*this;
+            return previous;
+        }
+
+        template <class OtherValue, class OtherMap, class OtherSparseIterator>
+        bool operator==(const BaseIterator<OtherValue, OtherMap, OtherSparseIterator>& other) const
+        {
+            return m_map && m_map->m_sparse ? m_sparseIt == other.m_sparseIt : m_position == other.m_position;
+        }
+
+        template <class OtherValue, class OtherMap, class OtherSparseIterator>
+        bool operator!=(const BaseIterator<OtherValue, OtherMap, OtherSparseIterator>& other) const
+        {
+            return !operator==(other);
+        }
+
+    private:
+        template <class, class, class>
+        friend class BaseIterator;
+        friend class DenseIdMap;
+
+        void skipUnused()
+        {
+            if (m_map && !m_map->m_sparse)
+                while (m_position < m_map->m_slots.size() && !m_map->m_slots[m_position].used)
+                    ++m_position;
+        }
+
+        Map* m_map;
+        size_type m_position;
+        SparseIterator m_sparseIt;
+    };
+
+public: // Iterators types
+    typedef BaseIterator<value_type, DenseIdMap, typename SparseElements::iterator> iterator;
+    typedef BaseIterator<const value_type, const DenseIdMap, typename SparseElements::const_iterator> const_iterator;
+
+public: // Methods
+    /**
+      * \brief  Default constructor, builds an empty map
+      */
+    DenseIdMap()
+        : m_slots()
+        , m_firstId(0)
+        , m_lowestId(0)
+        , m_highestId(0)
+        , m_size(0)
+        , m_sparse(false)
+        , m_sparseElements()
+        , m_sparseIndex()
+    {
+    }
+
+    /**
+      * \brief  Copy constructor (the hash table of sparse Ids is rebuilt, for the elements of the copy)
+      */
+    DenseIdMap(const DenseIdMap& other)
+        : m_slots(other.m_slots)
+        , m_firstId(other.m_firstId)
+        , m_lowestId(other.m_lowestId)
+        , m_highestId(other.m_highestId)
+        , m_size(other.m_size)
+        , m_sparse(other.m_sparse)
+        , m_sparseElements(other.m_sparseElements)
+        , m_sparseIndex()
+    {
+        indexSparseElements();
+    }
+
+    DenseIdMap& operator=(const DenseIdMap& other)
+    {
+        DenseIdMap copy(other);
+        swap(copy);
+        return *this;
+    }
+
+    /**
+      * \brief  Exchanges the elements of the maps (the iterators of sparse elements follow their element)
+      */
+    void swap(DenseIdMap& other)
+    {
+        m_slots.swap(other.m_slots);
+        std::swap(m_firstId, other.m_firstId);
+        std::swap(m_lowestId, other.m_lowestId);
+        std::swap(m_highestId, other.m_highestId);
+        std::swap(m_size, other.m_size);
+        std::swap(m_sparse, other.m_sparse);
+        m_sparseElements.swap(other.m_sparseElements);
+        std::swap(m_sparseIndex, other.m_sparseIndex);
+    }
+
+    iterator begin()
+    {
+        return m_sparse ? iterator(this, m_sparseElements.begin()) : iterator(this, 0);
+    }
+
+    const_iterator begin() const
+    {
+        return m_sparse ? const_iterator(this, m_sparseElements.begin()) : const_iterator(this, 0);
+    }
+
+    iterator end()
+    {
+        return m_sparse ? iterator(this, m_sparseElements.end()) : iterator(this, m_slots.size());
+    }
+
+    const_iterator end() const
+    {
+        return m_sparse ? const_iterator(this, m_sparseElements.end()) : const_iterator(this, m_slots.size());
+    }
+
+    size_type size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /**
+      * \brief  Returns true if the elements are in the ordered map of sparse Ids
+      */
+    bool isSparse() const
+    {
+        return m_sparse;
+    }
+
+    void clear()
+    {
+        SlotSet().swap(m_slots);
+        m_firstId = 0;
+        m_lowestId = 0;
+        m_highestId = 0;
+        m_size = 0;
+        m_sparse = false;
+        m_sparseElements.clear();
+        m_sparseIndex.clear();
+    }
+
+    iterator find(const unsigned long id)
+    {
+        if (m_sparse) {
+            typename SparseIndex::const_iterator indexIt = m_sparseIndex.find(id);
+            return iterator(this, indexIt == m_sparseIndex.end() ? m_sparseElements.end() : indexIt->second);
+        }
+        return iterator(this, findSlot(id));
+    }
+
+    const_iterator find(const unsigned long id) const
+    {
+        if (m_sparse) {
+            typename SparseIndex::const_iterator indexIt = m_sparseIndex.find(id);
+            return const_iterator(this, indexIt == m_sparseIndex.end() ? m_sparseElements.end() : typename SparseElements::const_iterator(indexIt->second));
+        }
+        return const_iterator(this, findSlot(id));
+    }
+
+    size_type count(const unsigned long id) const
+    {
+        if (m_sparse)
+            return m_sparseIndex.count(id);
+        return findSlot(id) == m_slots.size() ? 0 : 1;
+    }
+
+    /**
+      * \brief  Inserts the element if its Id is not in the map yet
+      * \return The iterator to the element of the Id, and true if it was inserted
+      */
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return insertElement(end(), value);
+    }
+
+    /**
+      * \brief  Inserts the element if its Id is not in the map yet, as std::map::insert(hint, value). The hint is only
+      *         used by sparse Ids, which are inserted in constant time just before it.
+      * \return The iterator to the element of the Id
+      */
+    iterator insert(const_iterator hint, const value_type& value)
+    {
+        return insertElement(hint, value).first;
+    }
+
+    /**
+      * \brief  Erases the element at the given position, which must be valid
+      */
+    void erase(const_iterator position)
+    {
+        if (m_sparse) {
+            m_sparseIndex.erase(position->first);
+            m_sparseElements.erase(position.m_sparseIt);
+        } else
+            m_slots[position.m_position] = Slot();
+        --m_size;
+    }
+
+    /**
+      * \brief  Erases the element of the given Id
+      * \return The number of erased elements (0 or 1)
+      */
+    size_type erase(const unsigned long id)
+    {
+        const_iterator position = find(id);
+        if (position == end())
+            return 0;
+        erase(position);
+        return 1;
+    }
+
+private:
+    /**
+      * \brief  Inserts the element if its Id is not in the map yet, before hint if the Ids are sparse
+      */
+    std::pair<iterator, bool> insertElement(const_iterator hint, const value_type& value)
+    {
+        const unsigned long id = value.first;
+        if (m_size == 0 && !m_sparse) {
+            m_slots.clear();
+            m_firstId = m_lowestId = m_highestId = id;
+        }
+
+        if (!m_sparse) {
+            // Span of the Ids with the new one (ignoring the erased Ids)
+            const unsigned long lowestId = std::min(m_lowestId, id), highestId = std::max(m_highestId, id);
+            const unsigned long span = highestId - lowestId + 1;
+            if (span > minSparseSpan && span / sparseSpanFactor > m_size) {
+                useSparseElements();
+                hint = end();
+            } else {
+                m_lowestId = lowestId;
+                m_highestId = highestId;
+            }
+        }
+        if (m_sparse) {
+            typename SparseIndex::const_iterator indexIt = m_sparseIndex.find(id);
+            if (indexIt != m_sparseIndex.end())
+                return std::pair<iterator, bool>(iterator(this, indexIt->second), false);
+            typename SparseElements::iterator elementIt = m_sparseElements.emplace_hint(hint.m_sparseIt, id, value);
+            m_sparseIndex.insert(typename SparseIndex::value_type(id, elementIt));
+            ++m_size;
+            return std::pair<iterator, bool>(iterator(this, elementIt), true);
+        }
+
+        if (id < m_firstId) {
+            // Room added before the first Id as much as the slots already there, so that inserting Ids in decreasing
+            // order is done in amortized constant time, as in increasing order
+            const unsigned long frontSlots = std::min(m_firstId, std::max<unsigned long>(m_firstId - id, m_slots.size()));
+            SlotSet slots(frontSlots + m_slots.size());
+            std::move(m_slots.begin(), m_slots.end(), slots.begin() + frontSlots);
+            m_slots.swap(slots);
+            m_firstId -= frontSlots;
+        } else if (id - m_firstId >= m_slots.size())
+            m_slots.resize(id - m_firstId + 1);
+
+        Slot& slot = m_slots[id - m_firstId];
+        if (slot.used)
+            return std::pair<iterator, bool>(iterator(this, id - m_firstId), false);
+        slot.value = value;
+        slot.used = true;
+        ++m_size;
+        return std::pair<iterator, bool>(iterator(this, id - m_firstId), true);
+    }
+
+    /**
+      * \brief  Moves the elements from the vector of dense Ids to the ordered map of sparse Ids
+      */
+    void useSparseElements()
+    {
+        for (Slot& slot : m_slots)
+            if (slot.used)
+                m_sparseElements.emplace_hint(m_sparseElements.end(), slot.value.first, std::move(slot.value));
+        SlotSet().swap(m_slots);
+        m_sparse = true;
+        indexSparseElements();
+    }
+
+    /**
+      * \brief  Builds the hash table of the sparse Ids
+      */
+    void indexSparseElements()
+    {
+        m_sparseIndex.clear();
+        m_sparseIndex.reserve(m_sparseElements.size());
+        for (typename SparseElements::iterator it = m_sparseElements.begin(); it != m_sparseElements.end(); ++it)
+            m_sparseIndex.insert(typename SparseIndex::value_type(it->first, it));
+    }
+
+    /**
+      * \brief  Returns the position of the Id, or m_slots.size() if the Id is not in the vector of dense Ids
+      */
+    size_type findSlot(const unsigned long id) const
+    {
+        if (id < m_firstId || id - m_firstId >= m_slots.size() || !m_slots[id - m_firstId].used)
+            return m_slots.size();
+        return id - m_firstId;
+    }
+
+    SlotSet m_slots;
+    unsigned long m_firstId;
+    unsigned long m_lowestId;
+    unsigned long m_highestId;
+    size_type m_size;
+    bool m_sparse;
+    SparseElements m_sparseElements;
+    SparseIndex m_sparseIndex;
+};
+
+template <typename T>
+const typename DenseIdMap<T>::size_type DenseIdMap<T>::minSparseSpan;
+
+template <typename T>
+const typename DenseIdMap<T>::size_type DenseIdMap<T>::sparseSpanFactor;
+
+#endif // DENSEIDMAP_H
@@ -8,23 +8,187 @@
 #ifndef GENERICGRAPH_H
 #define GENERICGRAPH_H
 
+#include "CompiledGraph.h"
+#include "DenseIdMap.h"
+#include "GraphMLReader.h"
+#include "OpenAddressingMap.h"
+#include "PathFinder.h"
 #include "UniqueIDGenerator.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <cstddef>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+/**
+  * \brief  Read-only view of the elements of a container of a graph, iterated without copy
+  *
+  * Key gives the element read from an iterator of the container (an Id, or an arc Id). A view is invalidated by any
+  * change of the graph, as the iterators of the container.
+  */
+template <class Iterator, class Key>
+class GraphRange {
+public:
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename Key::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type* pointer;
+        typedef value_type reference;
+
+        const_iterator(Iterator it = Iterator(), Key key = Key())
+            : m_it(it)
+            , m_key(key)
+        {
+        }
+
+        value_type operator*() const
+        {
+            return m_key(m_it);
+        }
+
+        const_iterator& operator++()
+        {
+            ++m_it;
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator previous(*this);
+            ++m_it;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const
+        {
+            return m_it == other.m_it;
+        }
+
+        bool operator!=(const const_iterator& other) const
+        {
+            return m_it != other.m_it;
+        }
+
+    private:
+        Iterator m_it;
+        Key m_key;
+    };
+
+    /**
+      * \brief  Builds the view of [first, last), which holds size elements (an empty view by default)
+      */
+    GraphRange(Iterator first = Iterator(), Iterator last = Iterator(), unsigned long size = 0, Key key = Key())
+        : m_first(first, key)
+        , m_last(last, key)
+        , m_size(size)
+    {
+    }
+
+    const_iterator begin() const
+    {
+        return m_first;
+    }
+
+    const_iterator end() const
+    {
+        return m_last;
+    }
+
+    unsigned long size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+private:
+    const_iterator m_first;
+    const_iterator m_last;
+    unsigned long m_size;
+};
+
+/**
+  * \brief  Storage of the vertices of GenericGraph in ordered maps (the default storage)
+  *
+  * A storage gives the containers of the graph: VertexIndex, from the vertices to their Ids, and VertexTable, from the
+  * Ids to the data of the vertices, which must be iterated in increasing order of the Ids.
+  */
+struct OrderedGraphStorage {
+    template <typename V, class CompareV>
+    struct VertexIndex {
+        typedef std::map<V, unsigned long, CompareV> type;
+    };
+    template <typename VertexData>
+    struct VertexTable {
+        typedef std::map<unsigned long, VertexData> type;
+    };
+};
+
+/**
+  * \brief  Equality of vertices deduced from their order, so that a hashed storage finds the same vertices as an ordered one
+  */
+template <class CompareV>
+struct EquivalentVertices {
+    template <typename V>
+    bool operator()(const V& vertex1, const V& vertex2) const
+    {
+        CompareV compare;
+        return !compare(vertex1, vertex2) && !compare(vertex2, vertex1);
+    }
+};
+
+/**
+  * \brief  Hash of the vertices by std::hash, default of HashedGraphStorage
+  */
+struct StdVertexHash {
+    template <typename V>
+    std::size_t operator()(const V& vertex) const
+    {
+        return std::hash<V>()(vertex);
+    }
+};
+
+/**
+  * \brief  Storage of the vertices of GenericGraph for fast lookups
+  *
+  * The vertices are found by an open addressing hash table (HashV must give the same hash to the vertices equivalent
+  * for CompareV), and the Ids by a DenseIdMap: a vector indexed by the Ids while they are dense, as the ones generated,
+  * or an ordered map indexed by a hash table when they are sparse. Lookups are so in constant time.
+  */
+template <class HashV = StdVertexHash>
+struct HashedGraphStorage {
+    template <typename V, class CompareV>
+    struct VertexIndex {
+        typedef OpenAddressingMap<V, unsigned long, HashV, EquivalentVertices<CompareV>> type;
+    };
+    template <typename VertexData>
+    struct VertexTable {
+        typedef DenseIdMap<VertexData> type;
+    };
+};
+
 /**
   * \brief
   */
-template <typename V, typename A, bool DirectedGraph = true, class CompareV = std::less<V>>
+template <typename V, typename A, bool DirectedGraph = true, class CompareV = std::less<V>, class Storage = OrderedGraphStorage>
 class GenericGraph {
 public: // Types and consts
     typedef unsigned long VertexID;
@@ -37,6 +201,136 @@ public: // Types and consts
 
     typedef std::vector<VertexID> VertexIDPath;
 
+    /**
+      * \brief  Weight of an arc in shortest paths, from its data
+      */
+    typedef typename PathFinder<V, A>::ArcWeight ArcWeight;
+
+    /**
+      * \brief  Builds the vertex of a GraphML node, from its id and data
+      *
+      * vertexId is set to the Id given to the vertex: the node id when it is a number, IllegalVertexID else (for an Id
+      * generated by the graph). It can be changed by the loader, e.g. to the Id of the built object.
+      */
+    typedef std::function<V(const std::string& nodeId, const GraphMLReader::Attributes& data, VertexID& vertexId)> VertexLoader;
+
+    /**
+      * \brief  Builds the arc of a GraphML edge, from its data
+      */
+    typedef std::function<A(const VertexID tailId, const VertexID headId, const GraphMLReader::Attributes& data)> ArcLoader;
+
+    /**
+      * \brief  Releases a vertex built by a VertexLoader, when the loading of the graph fails (e.g. deletes a built object)
+      */
+    typedef std::function<void(const V& vertex)> VertexReleaser;
+
+    /**
+      * \brief  Vertex given in bulk to build(): its Id, and its data
+      */
+    typedef std::pair<VertexID, V> VertexEntry;
+
+    /**
+      * \brief  Arc given in bulk to build(): the Ids of its tail and head, and its data
+      */
+    struct ArcEntry {
+        VertexID tailId;
+        VertexID headId;
+        A arc;
+    };
+
+    /**
+      * \brief  Builds the vertex of an Id found in an edge list
+      */
+    typedef std::function<V(const VertexID vertexId)> EdgeListVertexLoader;
+
+    /**
+      * \brief  Builds the arc of a line of an edge list, from the rest of the line
+      */
+    typedef std::function<A(const VertexID tailId, const VertexID headId, const std::string& data)> EdgeListArcLoader;
+
+private: // Containers types
+    typedef typename Storage::template VertexIndex<V, CompareV>::type Vertex2VertexID;
+    typedef std::map<VertexID, A> SuccessorsSet;
+    // Arcs of a vertex, shared by the copies of the graph until one of them changes them
+    struct Adjacency {
+        SuccessorsSet vertexSuccessors;
+        VertexIDSet vertexPredecessors;
+    };
+    struct VertexData {
+        typename Vertex2VertexID::iterator vertexRef;
+        std::shared_ptr<Adjacency> adjacency;
+
+        const SuccessorsSet& successors() const
+        {
+            return adjacency->vertexSuccessors;
+        }
+
+        const VertexIDSet& predecessors() const
+        {
+            return adjacency->vertexPredecessors;
+        }
+
+        // Arcs to change, copied first if another graph shares them
+        Adjacency& mutableAdjacency()
+        {
+            if (adjacency.use_count() != 1)
+                adjacency = std::make_shared<Adjacency>(*adjacency);
+            else
+                std::atomic_thread_fence(std::memory_order_acquire); // see the releases of the other owners
+            return *adjacency;
+        }
+    };
+    typedef typename Storage::template VertexTable<VertexData>::type VerticeDataSet;
+
+    // Vertices and arcs of a graph, shared by its copies until one of them changes
+    struct Content {
+        Vertex2VertexID verticesData;
+        VerticeDataSet verticesArcs;
+        unsigned long arcsNumber;
+
+        Content()
+            : verticesData()
+            , verticesArcs()
+            , arcsNumber(0)
+        {
+        }
+    };
+
+    // Elements read from the iterators of the containers by the views
+    struct MapKey {
+        typedef VertexID value_type;
+        template <class Iterator>
+        VertexID operator()(const Iterator& it) const
+        {
+            return it->first;
+        }
+    };
+    struct SetKey {
+        typedef VertexID value_type;
+        VertexID operator()(const typename VertexIDSet::const_iterator& it) const
+        {
+            return *it;
+        }
+    };
+    struct ArcKey {
+        typedef ArcID value_type;
+        ArcKey(VertexID tailId = IllegalVertexID)
+            : tail(tailId)
+        {
+        }
+        ArcID operator()(const typename SuccessorsSet::const_iterator& it) const
+        {
+            return ArcID(tail, it->first);
+        }
+        VertexID tail;
+    };
+
+public: // Views types
+    typedef GraphRange<typename VerticeDataSet::const_iterator, MapKey> VertexIDRange;
+    typedef GraphRange<typename SuccessorsSet::const_iterator, MapKey> SuccessorIDRange;
+    typedef GraphRange<typename VertexIDSet::const_iterator, SetKey> PredecessorIDRange;
+    typedef GraphRange<typename SuccessorsSet::const_iterator, ArcKey> ArcIDRange;
+
 public: // Methods
     /**
       * \brief  Default constructor
@@ -45,7 +339,12 @@ public: // Methods
     GenericGraph(const char* graphName = 0);
 
     /**
-      * \brief  Copy constructor
+      * \brief  Copy constructor, in constant time: the copy shares the vertices and arcs of other until one of them
+      *         changes
+      *
+      * The first change of a graph sharing its content copies the table of its vertices, but not their arcs: only the
+      * arcs of the vertices changed are copied, when they are changed. Copies can so be changed by different threads,
+      * the Ids of the vertices added being generated atomically (see UniqueIDGenerator).
       */
     GenericGraph(const GenericGraph& other);
 
@@ -55,12 +354,12 @@ public: // Methods
     virtual ~GenericGraph();
 
     /**
-      * \brief  Assign operator
+      * \brief  Assign operator, sharing the content of other as the copy constructor
       */
     GenericGraph& operator=(const GenericGraph& other);
 
     /**
-      * \brief  Duplication operator
+      * \brief  Duplication operator, sharing the content of the graph as the copy constructor
       */
     GenericGraph* dup();
 
@@ -129,6 +428,20 @@ public: // Methods
       */
     virtual ArcID add(const ArcID& arcId, const A& newArc, bool addVertexIfMissing = false);
 
+    /**
+      * \brief  Replaces the content of the graph by the given vertices and arcs, all built at once
+      * \param  vertices    the vertices, with their Ids. They are sorted in place, by Id.
+      * \param  arcs        the arcs between the vertices. They are sorted in place, by tail and head Ids. When an arc is
+      *                     given several times, its first data is kept.
+      * \throw  std::invalid_argument if an Id is illegal or given twice, if two vertices are equivalent, or if an arc has
+      *         a vertex not given. The graph is then unchanged.
+      *
+      * add() looks up both vertices of each arc, and inserts it at any place of their containers. Here, the arrays are
+      * sorted once, and the containers are filled in order, each insertion at their end: large generated topologies
+      * are built in a fraction of the time.
+      */
+    virtual void build(std::vector<VertexEntry>& vertices, std::vector<ArcEntry>& arcs);
+
     // Getters methods
     /**
       * \brief
@@ -286,6 +599,27 @@ public: // Methods
       */
     virtual unsigned long predecessorsNb(const V& vertex) const;
 
+    // Views, iterating the graph without copy (invalidated by any change of the graph)
+    /**
+      * \brief  Returns the Ids of all the vertices, in increasing order
+      */
+    VertexIDRange verticesRange() const;
+
+    /**
+      * \brief  Returns the Ids of the successors of a vertex, in increasing order (empty if there is no such vertex)
+      */
+    SuccessorIDRange successorsRange(const VertexID vertexId) const;
+
+    /**
+      * \brief  Returns the Ids of the predecessors of a vertex, in increasing order (empty if there is no such vertex)
+      */
+    PredecessorIDRange predecessorsRange(const VertexID vertexId) const;
+
+    /**
+      * \brief  Returns the Ids of the arcs leaving a vertex, sorted by head (empty if there is no such vertex)
+      */
+    ArcIDRange arcsRange(const VertexID vertexId) const;
+
     // Setters methods
     /**
       * \brief
@@ -378,20 +712,31 @@ public: // Methods
       */
     virtual bool remove(const V& vertex1, const V& vertex2);
 
+    /**
+      * \brief  Returns an immutable snapshot of the graph, in compressed sparse row form
+      *
+      * The snapshot stores the vertices and arcs in contiguous arrays, for the fast iterations of simulations (see
+      * CompiledGraph). It does not follow later changes of the graph.
+      */
+    virtual CompiledGraph<V, A> compile() const;
+
     // Path related methods
     /**
-      * \brief
-      * \param
-      * \return
+      * \brief  Returns a shortest path from a vertex to another
+      * \param  arcWeight   weight of the arcs (the path with the fewest arcs if empty)
+      * \return the Ids of the vertices of the path, from source to destination, or an empty path if the destination can
+      *         not be reached
+      * \throw  std::invalid_argument if a vertex is not in the graph, or if an arc has a negative weight
+      *
+      * The graph is compiled for the search (see PathFinder). To find many paths, or to forward particles, search the
+      * snapshot with a PathFinder, or compute a NextHopTable, instead.
       */
-    // virtual VertexIDPath  shortestPath(const VertexID sourceVertexId, const VertexID destVertexId);
+    virtual VertexIDPath shortestPath(const VertexID sourceVertexId, const VertexID destVertexId, const ArcWeight& arcWeight = ArcWeight()) const;
 
     /**
-      * \brief
-      * \param
-      * \return
+      * \brief  Returns a shortest path from a vertex to another (see shortestPath(const VertexID, const VertexID, ...))
       */
-    //virtual VertexIDPath  shortestPath(const V & sourceVertex, const V & destVertex);
+    virtual VertexIDPath shortestPath(const V& sourceVertex, const V& destVertex, const ArcWeight& arcWeight = ArcWeight()) const;
 
     // Load/save related methods
     /**
@@ -409,77 +754,106 @@ public: // Methods
     virtual bool save(const char* writeFileName) const;
 
     /**
-      * \brief
-      * \param
+      * \brief  Saves the snapshot of the graph (see compile()) in a binary file, to be mapped by CompiledGraph::map()
+      * \return true if saving process did not encounter errors, false else.
+      *
+      * Unlike GraphML files, binary files keep the vertices and arcs data, which must be trivially copyable and not
+      * pointers, and are used without parsing. They are only read on machines of the same byte order and word size.
+      * This method is not virtual, so that graphs of other vertices and arcs (as the simulation graphs, of module
+      * pointers) can still be instantiated, while not compiling for them.
+      */
+    bool saveBinary(const char* writeFileName) const;
+
+    /**
+      * \brief  Replaces the content of the graph by the one of a GraphML stream
+      * \param  vertexLoader    builds the vertex of each node
+      * \param  arcLoader       builds the arc of each edge (default built arcs if empty)
+      * \param  errorMessage    set to the description of the error, if any
+      * \param  vertexReleaser  releases the vertices built by vertexLoader if the loading fails (nothing done if empty)
       * \return true if loading process did not encounter errors, false else.
+      *
+      * The stream is read in a single pass (see GraphMLReader): the vertex of each node is built as soon as it is read,
+      * and the graph is built at once from all its vertices and edges (see build()), in any order. Undirected edges
+      * give an arc in each direction. The numeric node ids are reserved as they are read, and the Ids of the nodes
+      * left without Id by the loader are generated at the end, so that they never collide with them; Ids given by the
+      * loader that collide are reported as duplicate nodes. A single graph is loaded per stream. On errors (including
+      * exceptions of the loaders), the vertices built are released and the graph is left unchanged.
       */
-    //virtual bool  load(std::istream & ist);
+    virtual bool load(std::istream& ist, const VertexLoader& vertexLoader, const ArcLoader& arcLoader = ArcLoader(), std::string* errorMessage = NULL, const VertexReleaser& vertexReleaser = VertexReleaser());
 
     /**
-      * \brief
-      * \param
+      * \brief  Replaces the content of the graph by the one of a GraphML file (see load(std::istream&, ...))
       * \return true if loading process did not encounter errors, false else.
       */
-    //virtual bool  load(const char * readFileName);
+    virtual bool load(const char* readFileName, const VertexLoader& vertexLoader, const ArcLoader& arcLoader = ArcLoader(), std::string* errorMessage = NULL, const VertexReleaser& vertexReleaser = VertexReleaser());
+
+    /**
+      * \brief  Replaces the content of the graph by the one of an edge list stream
+      * \param  vertexLoader    builds the vertex of each Id found
+      * \param  arcLoader       builds the arc of each line, from the rest of the line (default built arcs if empty)
+      * \param  errorMessage    set to the description of the error, if any
+      * \param  vertexReleaser  releases the vertices built by vertexLoader if the loading fails (nothing done if empty)
+      * \return true if loading process did not encounter errors, false else.
+      *
+      * Each line holds an arc: the Ids of its tail and head, separated by blanks, and optionally its data. Empty lines,
+      * and lines beginning with '#', are skipped. The graph is built at once from the whole list (see build()). On
+      * errors (including exceptions of the loaders), the vertices built are released and the graph is left unchanged,
+      * as by load().
+      */
+    virtual bool loadEdgeList(std::istream& ist, const EdgeListVertexLoader& vertexLoader, const EdgeListArcLoader& arcLoader = EdgeListArcLoader(), std::string* errorMessage = NULL, const VertexReleaser& vertexReleaser = VertexReleaser());
+
+    /**
+      * \brief  Replaces the content of the graph by the one of an edge list file (see loadEdgeList(std::istream&, ...))
+      * \return true if loading process did not encounter errors, false else.
+      */
+    virtual bool loadEdgeList(const char* readFileName, const EdgeListVertexLoader& vertexLoader, const EdgeListArcLoader& arcLoader = EdgeListArcLoader(), std::string* errorMessage = NULL, const VertexReleaser& vertexReleaser = VertexReleaser());
 
 private:
-    // Types definitions
-    typedef std::map<V, VertexID, CompareV> Vertex2VertexID;
-    typedef std::map<VertexID, A> SuccessorsSet;
-    struct VertexData {
-        typename Vertex2VertexID::iterator vertexRef;
-        SuccessorsSet vertexSuccessors;
-        VertexIDSet vertexPredecessors;
-    };
-    typedef std::map<VertexID, VertexData> VerticeDataSet;
+    /**
+      * \brief  Gives this graph its own content before it is changed, if it shares it with copies
+      */
+    void detach();
 
     // Attributs declarations
     bool m_directed;
-    unsigned long m_arcsNumber;
-    Vertex2VertexID m_verticesData;
-    VerticeDataSet m_verticesArcs;
+    std::shared_ptr<Content> m_content;
     char* m_graphName;
 };
 
 // Assignation of static attributs values
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-const typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexID GenericGraph<V, A, DirectedGraph, CompareV>::IllegalVertexID = ~(VertexID)(0);
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+const typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::VertexID GenericGraph<V, A, DirectedGraph, CompareV, Storage>::IllegalVertexID = ~(VertexID)(0);
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-const typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcID GenericGraph<V, A, DirectedGraph, CompareV>::IllegalArcID = GenericGraph<V, A, DirectedGraph, CompareV>::ArcID(IllegalVertexID, IllegalVertexID);
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+const typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::ArcID GenericGraph<V, A, DirectedGraph, CompareV, Storage>::IllegalArcID = GenericGraph<V, A, DirectedGraph, CompareV, Storage>::ArcID(IllegalVertexID, IllegalVertexID);
 
 // Constructor
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-GenericGraph<V, A, DirectedGraph, CompareV>::GenericGraph(const char* graphName)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+GenericGraph<V, A, DirectedGraph, CompareV, Storage>::GenericGraph(const char* graphName)
     : m_directed(DirectedGraph)
-    , m_arcsNumber(0)
-    , m_verticesData()
-    , m_verticesArcs()
+    , m_content(std::make_shared<Content>())
     , m_graphName(0)
 {
     setName(graphName);
 }
 
 // Copy Constructor
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-GenericGraph<V, A, DirectedGraph, CompareV>::GenericGraph(const GenericGraph<V, A, DirectedGraph, CompareV>& other)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+GenericGraph<V, A, DirectedGraph, CompareV, Storage>::GenericGraph(const GenericGraph<V, A, DirectedGraph, CompareV, Storage>& other)
     : m_directed(DirectedGraph)
-    , m_arcsNumber(0)
-    , m_verticesData()
-    , m_verticesArcs()
+    , m_content(other.m_content)
     , m_graphName(0)
 {
-    operator=(other);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-const char* GenericGraph<V, A, DirectedGraph, CompareV>::name() const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+const char* GenericGraph<V, A, DirectedGraph, CompareV, Storage>::name() const
 {
     return m_graphName;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-void GenericGraph<V, A, DirectedGraph, CompareV>::setName(const char* graphName)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+void GenericGraph<V, A, DirectedGraph, CompareV, Storage>::setName(const char* graphName)
 {
     if (m_graphName) {
         delete[] m_graphName;
@@ -492,67 +866,71 @@ void GenericGraph<V, A, DirectedGraph, CompareV>::setName(const char* graphName)
 }
 
 // Assign operator
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-GenericGraph<V, A, DirectedGraph, CompareV>& GenericGraph<V, A, DirectedGraph, CompareV>::operator=(const GenericGraph<V, A, DirectedGraph, CompareV>& other)
-{
-    if (this != &other) {
-        clear();
-        typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcIDSet arcsSet = other.arcs();
-        for (typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcIDSet::const_iterator arcIt = arcsSet.begin(); arcIt != arcsSet.end(); arcIt++)
-            add(*arcIt, other.arc(*arcIt), true);
-
-        typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexIDSet verticesSet = other.vertices();
-        for (typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexIDSet::const_iterator vertexIt = verticesSet.begin(); vertexIt != verticesSet.end(); vertexIt++)
-            setVertex(*vertexIt, other.vertex(*vertexIt));
-    }
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+GenericGraph<V, A, DirectedGraph, CompareV, Storage>& GenericGraph<V, A, DirectedGraph, CompareV, Storage>::operator=(const GenericGraph<V, A, DirectedGraph, CompareV, Storage>& other)
+{
+    // Shared until one of the graphs changes (see detach())
+    m_content = other.m_content;
     return *this;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-GenericGraph<V, A, DirectedGraph, CompareV>* GenericGraph<V, A, DirectedGraph, CompareV>::dup()
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+GenericGraph<V, A, DirectedGraph, CompareV, Storage>* GenericGraph<V, A, DirectedGraph, CompareV, Storage>::dup()
 {
-    return (new GenericGraph<V, A, DirectedGraph, CompareV>(*this));
+    return (new GenericGraph<V, A, DirectedGraph, CompareV, Storage>(*this));
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-void GenericGraph<V, A, DirectedGraph, CompareV>::clear()
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+void GenericGraph<V, A, DirectedGraph, CompareV, Storage>::clear()
 {
-    m_verticesData.clear();
-    for (typename VerticeDataSet::iterator it = m_verticesArcs.begin(); it != m_verticesArcs.end();) // Parse all vertices data ...
-    {
-        it->second.vertexSuccessors.clear();
-        it->second.vertexPredecessors.clear();
-        m_verticesArcs.erase(it++);
+    // The arcs are freed with the last graph sharing them
+    m_content = std::make_shared<Content>();
+}
+
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+void GenericGraph<V, A, DirectedGraph, CompareV, Storage>::detach()
+{
+    if (m_content.use_count() == 1) {
+        std::atomic_thread_fence(std::memory_order_acquire); // see the releases of the copies
+        return;
     }
-    m_verticesArcs.clear();
-    m_arcsNumber = 0;
+
+    // Only the table of the vertices is copied: their arcs are still shared, until each of them changes
+    std::shared_ptr<Content> content = std::make_shared<Content>();
+    for (typename VerticeDataSet::const_iterator it = m_content->verticesArcs.begin(); it != m_content->verticesArcs.end(); it++) {
+        VertexData newVertexData;
+        newVertexData.vertexRef = content->verticesData.insert(std::pair<V, VertexID>(it->second.vertexRef->first, it->first)).first;
+        newVertexData.adjacency = it->second.adjacency;
+        content->verticesArcs.insert(content->verticesArcs.end(), std::pair<VertexID, VertexData>(it->first, newVertexData));
+    }
+    content->arcsNumber = m_content->arcsNumber;
+    m_content = content;
 }
 
 // Destructor
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-GenericGraph<V, A, DirectedGraph, CompareV>::~GenericGraph()
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+GenericGraph<V, A, DirectedGraph, CompareV, Storage>::~GenericGraph()
 {
-    clear();
     if (m_graphName)
         delete[] m_graphName;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexID GenericGraph<V, A, DirectedGraph, CompareV>::add(const V& newVertex, const VertexID newVertexId)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::VertexID GenericGraph<V, A, DirectedGraph, CompareV, Storage>::add(const V& newVertex, const VertexID newVertexId)
 {
+    detach();
     if (newVertexId == IllegalVertexID) // invalid vertex id
     {
-        typename Vertex2VertexID::iterator vertexIt = m_verticesData.find(newVertex);
+        typename Vertex2VertexID::iterator vertexIt = m_content->verticesData.find(newVertex);
         // if the vertex does not exist, insert it with an id generated automatically
-        if (vertexIt == m_verticesData.end()) // If the vertex does not exist , ...
+        if (vertexIt == m_content->verticesData.end()) // If the vertex does not exist , ...
         {
             VertexID insertId = UniqueIDGenerator<VertexID>::Generator()->newId();
             VertexData newVertexData;
-            newVertexData.vertexSuccessors.clear();
-            newVertexData.vertexPredecessors.clear();
+            newVertexData.adjacency = std::make_shared<Adjacency>();
             // Insert the new vertex with a new Id, and set the returned iterator in the vertexRef attribute
-            newVertexData.vertexRef = m_verticesData.insert(std::pair<V, VertexID>(newVertex, insertId)).first;
-            m_verticesArcs.insert(std::pair<VertexID, VertexData>(insertId, newVertexData));
+            newVertexData.vertexRef = m_content->verticesData.insert(std::pair<V, VertexID>(newVertex, insertId)).first;
+            m_content->verticesArcs.insert(std::pair<VertexID, VertexData>(insertId, newVertexData));
             return insertId;
         } else // it is already there, return it's ID
             return vertexIt->second;
@@ -560,36 +938,35 @@ typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexID GenericGraph<V, A
     } else // valid vertex id
     {
         // check the existance of the vertex id
-        if (m_verticesArcs.find(newVertexId) != m_verticesArcs.end()) {
+        if (m_content->verticesArcs.find(newVertexId) != m_content->verticesArcs.end()) {
             // if it exists, set the vertex data for this vertex id
             setVertex(newVertexId, newVertex);
             return newVertexId;
         } else {
             // if it does not exist: insert with the given information
             VertexData newVertexData;
-            newVertexData.vertexSuccessors.clear();
-            newVertexData.vertexPredecessors.clear();
+            newVertexData.adjacency = std::make_shared<Adjacency>();
             // Insert the new vertex with the given id Id, and set the returned iterator in the vertexRef attribute
-            newVertexData.vertexRef = m_verticesData.insert(std::pair<V, VertexID>(newVertex, newVertexId)).first;
-            m_verticesArcs.insert(std::pair<VertexID, VertexData>(newVertexId, newVertexData));
+            newVertexData.vertexRef = m_content->verticesData.insert(std::pair<V, VertexID>(newVertex, newVertexId)).first;
+            m_content->verticesArcs.insert(std::pair<VertexID, VertexData>(newVertexId, newVertexData));
             return newVertexId;
         }
     }
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcID GenericGraph<V, A, DirectedGraph, CompareV>::add(const V& vertex1, const V& vertex2, bool addVertexIfMissing)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::ArcID GenericGraph<V, A, DirectedGraph, CompareV, Storage>::add(const V& vertex1, const V& vertex2, bool addVertexIfMissing)
 {
     A defaultArc;
     return add(vertex1, vertex2, defaultArc, addVertexIfMissing);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcID GenericGraph<V, A, DirectedGraph, CompareV>::add(const V& vertex1, const V& vertex2, const A& newArc, bool addVertexIfMissing)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::ArcID GenericGraph<V, A, DirectedGraph, CompareV, Storage>::add(const V& vertex1, const V& vertex2, const A& newArc, bool addVertexIfMissing)
 {
     VertexID vertex1Id, vertex2Id;
-    typename Vertex2VertexID::iterator vertex1DataIt = m_verticesData.find(vertex1);
-    if (vertex1DataIt == m_verticesData.end()) {
+    typename Vertex2VertexID::iterator vertex1DataIt = m_content->verticesData.find(vertex1);
+    if (vertex1DataIt == m_content->verticesData.end()) {
         if (addVertexIfMissing)
             vertex1Id = add(vertex1);
         else
@@ -597,8 +974,8 @@ typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcID GenericGraph<V, A, D
     } else
         vertex1Id = vertex1DataIt->second;
 
-    typename Vertex2VertexID::iterator vertex2DataIt = m_verticesData.find(vertex2);
-    if (vertex2DataIt == m_verticesData.end()) {
+    typename Vertex2VertexID::iterator vertex2DataIt = m_content->verticesData.find(vertex2);
+    if (vertex2DataIt == m_content->verticesData.end()) {
         if (addVertexIfMissing)
             vertex2Id = add(vertex2);
         else
@@ -609,73 +986,159 @@ typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcID GenericGraph<V, A, D
     return add(vertex1Id, vertex2Id, newArc);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcID GenericGraph<V, A, DirectedGraph, CompareV>::add(const VertexID vertex1Id, const VertexID vertex2Id, bool addVertexIfMissing)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::ArcID GenericGraph<V, A, DirectedGraph, CompareV, Storage>::add(const VertexID vertex1Id, const VertexID vertex2Id, bool addVertexIfMissing)
 {
     A defaultArc;
     return add(vertex1Id, vertex2Id, defaultArc, addVertexIfMissing);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcID GenericGraph<V, A, DirectedGraph, CompareV>::add(const VertexID vertex1Id, const VertexID vertex2Id, const A& newArc, bool addVertexIfMissing)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::ArcID GenericGraph<V, A, DirectedGraph, CompareV, Storage>::add(const VertexID vertex1Id, const VertexID vertex2Id, const A& newArc, bool addVertexIfMissing)
 {
-    typename VerticeDataSet::iterator vertex1It = m_verticesArcs.find(vertex1Id);
-    if (vertex1It == m_verticesArcs.end()) {
+    detach();
+    typename VerticeDataSet::iterator vertex1It = m_content->verticesArcs.find(vertex1Id);
+    if (vertex1It == m_content->verticesArcs.end()) {
         if (addVertexIfMissing) {
             V defaultVertex;
             add(defaultVertex, vertex1Id);
-            vertex1It = m_verticesArcs.find(vertex1Id);
         } else
             return IllegalArcID;
     }
-    typename VerticeDataSet::iterator vertex2It = m_verticesArcs.find(vertex2Id);
-    if (vertex2It == m_verticesArcs.end()) {
+    typename VerticeDataSet::iterator vertex2It = m_content->verticesArcs.find(vertex2Id);
+    if (vertex2It == m_content->verticesArcs.end()) {
         if (addVertexIfMissing) {
             V defaultVertex;
             add(defaultVertex, vertex2Id);
-            vertex2It = m_verticesArcs.find(vertex2Id);
         } else
             return IllegalArcID;
     }
+    // Found after the insertions, which may invalidate the iterators of some storages
+    vertex1It = m_content->verticesArcs.find(vertex1Id);
+    vertex2It = m_content->verticesArcs.find(vertex2Id);
 
     // Every thing is right (vertices are inserted) proceed with the insertion of the arc
-    vertex1It->second.vertexSuccessors.insert(std::pair<VertexID, A>(vertex2Id, newArc));
-    vertex2It->second.vertexPredecessors.insert(vertex1Id);
+    vertex1It->second.mutableAdjacency().vertexSuccessors.insert(std::pair<VertexID, A>(vertex2Id, newArc));
+    vertex2It->second.mutableAdjacency().vertexPredecessors.insert(vertex1Id);
 
-    m_arcsNumber++;
+    m_content->arcsNumber++;
 
     // Finally, return the inserted arc references
     return ArcID(vertex1Id, vertex2Id);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcID GenericGraph<V, A, DirectedGraph, CompareV>::add(const ArcID& arcId, bool addVertexIfMissing)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::ArcID GenericGraph<V, A, DirectedGraph, CompareV, Storage>::add(const ArcID& arcId, bool addVertexIfMissing)
 {
     A defaultArc;
     return add(arcId.first, arcId.second, defaultArc, addVertexIfMissing);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcID GenericGraph<V, A, DirectedGraph, CompareV>::add(const ArcID& arcId, const A& newArc, bool addVertexIfMissing)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::ArcID GenericGraph<V, A, DirectedGraph, CompareV, Storage>::add(const ArcID& arcId, const A& newArc, bool addVertexIfMissing)
 {
     return add(arcId.first, arcId.second, newArc, addVertexIfMissing);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexID GenericGraph<V, A, DirectedGraph, CompareV>::vertex(const V& vertex) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+void GenericGraph<V, A, DirectedGraph, CompareV, Storage>::build(std::vector<VertexEntry>& vertices, std::vector<ArcEntry>& arcs)
+{
+    // Everything is checked before the graph is changed
+    std::sort(vertices.begin(), vertices.end(), [](const VertexEntry& vertex1, const VertexEntry& vertex2) {
+        return vertex1.first < vertex2.first;
+    });
+    for (unsigned long i = 0; i < vertices.size(); ++i)
+        if (vertices[i].first == IllegalVertexID || (i > 0 && vertices[i].first == vertices[i - 1].first)) {
+            std::ostringstream exceptionStream;
+            exceptionStream << __PRETTY_FUNCTION__ << ": Illegal or duplicate vertex Id " << vertices[i].first << ".";
+            throw std::invalid_argument(exceptionStream.str());
+        }
+
+    CompareV compare;
+    std::vector<unsigned long> order(vertices.size());
+    for (unsigned long i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&vertices, &compare](unsigned long position1, unsigned long position2) {
+        return compare(vertices[position1].second, vertices[position2].second);
+    });
+    for (unsigned long i = 1; i < order.size(); ++i)
+        if (!compare(vertices[order[i - 1]].second, vertices[order[i]].second)) {
+            std::ostringstream exceptionStream;
+            exceptionStream << __PRETTY_FUNCTION__ << ": Equivalent vertices of Ids " << vertices[order[i - 1]].first << " and " << vertices[order[i]].first << ".";
+            throw std::invalid_argument(exceptionStream.str());
+        }
+
+    // Stable sort, so that the first of identical arcs comes first
+    std::stable_sort(arcs.begin(), arcs.end(), [](const ArcEntry& arc1, const ArcEntry& arc2) {
+        return arc1.tailId < arc2.tailId || (arc1.tailId == arc2.tailId && arc1.headId < arc2.headId);
+    });
+
+    // Positions of the vertices found in a table when their Ids are dense (as the generated ones), by dichotomy else
+    const unsigned long verticesNb = vertices.size();
+    const VertexID firstId = vertices.empty() ? 0 : vertices.front().first;
+    std::vector<unsigned long> positions;
+    if (!vertices.empty() && vertices.back().first - firstId < 4 * verticesNb) {
+        positions.assign(vertices.back().first - firstId + 1, verticesNb);
+        for (unsigned long i = 0; i < verticesNb; ++i)
+            positions[vertices[i].first - firstId] = i;
+    }
+    auto position = [&vertices, &positions, firstId, verticesNb](const VertexID vertexId) -> unsigned long {
+        if (!positions.empty())
+            return vertexId < firstId || vertexId - firstId >= positions.size() ? verticesNb : positions[vertexId - firstId];
+        unsigned long vertexPosition = std::lower_bound(vertices.begin(), vertices.end(), vertexId, [](const VertexEntry& vertex, const VertexID id) {
+            return vertex.first < id;
+        }) - vertices.begin();
+        return vertexPosition < verticesNb && vertices[vertexPosition].first == vertexId ? vertexPosition : verticesNb;
+    };
+    for (const ArcEntry& arc : arcs)
+        if (position(arc.tailId) == verticesNb || position(arc.headId) == verticesNb) {
+            std::ostringstream exceptionStream;
+            exceptionStream << __PRETTY_FUNCTION__ << ": Arc " << arc.tailId << "->" << arc.headId << " of an unknown vertex.";
+            throw std::invalid_argument(exceptionStream.str());
+        }
+
+    // Vertices inserted in increasing Ids, then arcs in increasing tails and heads: each container is filled at its end
+    clear();
+    for (const VertexEntry& vertex : vertices) {
+        VertexData newVertexData;
+        newVertexData.vertexRef = m_content->verticesData.insert(std::pair<V, VertexID>(vertex.second, vertex.first)).first;
+        newVertexData.adjacency = std::make_shared<Adjacency>();
+        m_content->verticesArcs.insert(m_content->verticesArcs.end(), std::pair<VertexID, VertexData>(vertex.first, newVertexData));
+    }
+
+    // Taken after the insertions, which may move the data of some storages
+    std::vector<VertexData*> verticesData;
+    verticesData.reserve(verticesNb);
+    for (typename VerticeDataSet::iterator it = m_content->verticesArcs.begin(); it != m_content->verticesArcs.end(); it++)
+        verticesData.push_back(&it->second);
+
+    for (unsigned long i = 0; i < arcs.size(); ++i) {
+        const ArcEntry& arc = arcs[i];
+        if (i > 0 && arc.tailId == arcs[i - 1].tailId && arc.headId == arcs[i - 1].headId)
+            continue;
+        SuccessorsSet& successors = verticesData[position(arc.tailId)]->adjacency->vertexSuccessors;
+        successors.insert(successors.end(), std::pair<VertexID, A>(arc.headId, arc.arc));
+        VertexIDSet& predecessors = verticesData[position(arc.headId)]->adjacency->vertexPredecessors;
+        predecessors.insert(predecessors.end(), arc.tailId);
+        m_content->arcsNumber++;
+    }
+}
+
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::VertexID GenericGraph<V, A, DirectedGraph, CompareV, Storage>::vertex(const V& vertex) const
 {
-    typename Vertex2VertexID::const_iterator vertexDataIt = m_verticesData.find(vertex);
-    if (vertexDataIt == m_verticesData.end())
+    typename Vertex2VertexID::const_iterator vertexDataIt = m_content->verticesData.find(vertex);
+    if (vertexDataIt == m_content->verticesData.end())
         return IllegalVertexID;
 
     return vertexDataIt->second;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-const V& GenericGraph<V, A, DirectedGraph, CompareV>::vertex(const VertexID vertexId) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+const V& GenericGraph<V, A, DirectedGraph, CompareV, Storage>::vertex(const VertexID vertexId) const
 {
-    typename VerticeDataSet::const_iterator vertexIt = m_verticesArcs.find(vertexId);
-    if (vertexIt == m_verticesArcs.end()) {
+    typename VerticeDataSet::const_iterator vertexIt = m_content->verticesArcs.find(vertexId);
+    if (vertexIt == m_content->verticesArcs.end()) {
         std::ostringstream exceptionStream;
         exceptionStream << __PRETTY_FUNCTION__ << ": Unable to find vertex with vertex Id " << vertexId;
         throw std::invalid_argument(exceptionStream.str());
@@ -684,377 +1147,467 @@ const V& GenericGraph<V, A, DirectedGraph, CompareV>::vertex(const VertexID vert
     return vertexIt->second.vertexRef->first;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcID GenericGraph<V, A, DirectedGraph, CompareV>::arc(const V& vertex1, const V& vertex2) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::ArcID GenericGraph<V, A, DirectedGraph, CompareV, Storage>::arc(const V& vertex1, const V& vertex2) const
 {
-    typename Vertex2VertexID::const_iterator vertex1DataIt = m_verticesData.find(vertex1);
-    if (vertex1DataIt == m_verticesData.end())
+    typename Vertex2VertexID::const_iterator vertex1DataIt = m_content->verticesData.find(vertex1);
+    if (vertex1DataIt == m_content->verticesData.end())
         return IllegalArcID;
 
-    typename Vertex2VertexID::const_iterator vertex2DataIt = m_verticesData.find(vertex2);
-    if (vertex2DataIt == m_verticesData.end())
+    typename Vertex2VertexID::const_iterator vertex2DataIt = m_content->verticesData.find(vertex2);
+    if (vertex2DataIt == m_content->verticesData.end())
         return IllegalArcID;
 
     return arc(vertex1DataIt->second, vertex2DataIt->second);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcID GenericGraph<V, A, DirectedGraph, CompareV>::arc(const VertexID vertex1Id, const VertexID vertex2Id) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::ArcID GenericGraph<V, A, DirectedGraph, CompareV, Storage>::arc(const VertexID vertex1Id, const VertexID vertex2Id) const
 {
-    typename VerticeDataSet::const_iterator vertex1It = m_verticesArcs.find(vertex1Id);
-    if (vertex1It == m_verticesArcs.end())
+    typename VerticeDataSet::const_iterator vertex1It = m_content->verticesArcs.find(vertex1Id);
+    if (vertex1It == m_content->verticesArcs.end())
         return IllegalArcID;
 
-    typename VerticeDataSet::const_iterator vertex2It = m_verticesArcs.find(vertex2Id);
-    if (vertex2It == m_verticesArcs.end())
+    typename VerticeDataSet::const_iterator vertex2It = m_content->verticesArcs.find(vertex2Id);
+    if (vertex2It == m_content->verticesArcs.end())
         return IllegalArcID;
 
-    if (vertex1It->second.vertexSuccessors.find(vertex2Id) == vertex1It->second.vertexSuccessors.end())
+    if (vertex1It->second.successors().find(vertex2Id) == vertex1It->second.successors().end())
         // this arc does not exist
         return IllegalArcID;
     else
         return ArcID(vertex1Id, vertex2Id);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-A GenericGraph<V, A, DirectedGraph, CompareV>::arc(const ArcID& arcId) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+A GenericGraph<V, A, DirectedGraph, CompareV, Storage>::arc(const ArcID& arcId) const
 {
-    typename VerticeDataSet::const_iterator firstVertexIt = m_verticesArcs.find(arcId.first);
-    if (firstVertexIt == m_verticesArcs.end()) {
+    typename VerticeDataSet::const_iterator firstVertexIt = m_content->verticesArcs.find(arcId.first);
+    if (firstVertexIt == m_content->verticesArcs.end()) {
         std::ostringstream exceptionStream;
         exceptionStream << __PRETTY_FUNCTION__ << ": Unable to find arc tail vertex in the graph (" << arcId.first << ")";
         throw std::invalid_argument(exceptionStream.str());
     }
 
-    typename VerticeDataSet::const_iterator secondVertexIt = m_verticesArcs.find(arcId.second);
-    if (secondVertexIt == m_verticesArcs.end()) {
+    typename VerticeDataSet::const_iterator secondVertexIt = m_content->verticesArcs.find(arcId.second);
+    if (secondVertexIt == m_content->verticesArcs.end()) {
         std::ostringstream exceptionStream;
         exceptionStream << __PRETTY_FUNCTION__ << ": Unable to find arc head vertex in the graph (" << arcId.second << ")";
         throw std::invalid_argument(exceptionStream.str());
     }
 
-    if (firstVertexIt->second.vertexSuccessors.find(arcId.second)
-        == firstVertexIt->second.vertexSuccessors.end()) // this arc does not exist
+    if (firstVertexIt->second.successors().find(arcId.second)
+        == firstVertexIt->second.successors().end()) // this arc does not exist
     {
         std::ostringstream exceptionStream;
         exceptionStream << __PRETTY_FUNCTION__ << ": Unable to find arc vertex in the graph (" << arcId.first << "->" << arcId.second << ")";
         throw std::invalid_argument(exceptionStream.str());
     }
 
-    return firstVertexIt->second.vertexSuccessors.find(arcId.second)->second;
+    return firstVertexIt->second.successors().find(arcId.second)->second;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexID GenericGraph<V, A, DirectedGraph, CompareV>::arcTail(const ArcID& arcId) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::VertexID GenericGraph<V, A, DirectedGraph, CompareV, Storage>::arcTail(const ArcID& arcId) const
 {
     return arcId.first;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexID GenericGraph<V, A, DirectedGraph, CompareV>::arcHead(const ArcID& arcId) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::VertexID GenericGraph<V, A, DirectedGraph, CompareV, Storage>::arcHead(const ArcID& arcId) const
 {
     return arcId.second;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexIDSet GenericGraph<V, A, DirectedGraph, CompareV>::vertices() const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::VertexIDSet GenericGraph<V, A, DirectedGraph, CompareV, Storage>::vertices() const
 {
     VertexIDSet verticesSet;
-    for (typename VerticeDataSet::const_iterator it = m_verticesArcs.begin(); it != m_verticesArcs.end(); it++)
+    for (typename VerticeDataSet::const_iterator it = m_content->verticesArcs.begin(); it != m_content->verticesArcs.end(); it++)
         verticesSet.insert(it->first);
     return verticesSet;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcIDSet GenericGraph<V, A, DirectedGraph, CompareV>::arcs() const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::ArcIDSet GenericGraph<V, A, DirectedGraph, CompareV, Storage>::arcs() const
 {
     ArcIDSet arcsSet;
-    for (typename VerticeDataSet::const_iterator it = m_verticesArcs.begin(); it != m_verticesArcs.end(); it++) // Parse all vertices ...
-        for (typename SuccessorsSet::const_iterator succit = it->second.vertexSuccessors.begin(); succit != it->second.vertexSuccessors.end(); succit++) // parse all successors of each vertex
+    for (typename VerticeDataSet::const_iterator it = m_content->verticesArcs.begin(); it != m_content->verticesArcs.end(); it++) // Parse all vertices ...
+        for (typename SuccessorsSet::const_iterator succit = it->second.successors().begin(); succit != it->second.successors().end(); succit++) // parse all successors of each vertex
             arcsSet.insert(ArcID(it->first, succit->first)); // add the obtained arc to the set.
     return arcsSet;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcIDSet GenericGraph<V, A, DirectedGraph, CompareV>::arcs(const VertexID vertexId) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::ArcIDSet GenericGraph<V, A, DirectedGraph, CompareV, Storage>::arcs(const VertexID vertexId) const
 {
     ArcIDSet arcsSet;
-    typename VerticeDataSet::const_iterator vertexIt = m_verticesArcs.find(vertexId);
-    if (vertexIt != m_verticesArcs.end())
-        for (typename SuccessorsSet::const_iterator succit = vertexIt->second.vertexSuccessors.begin(); succit != vertexIt->second.vertexSuccessors.end(); succit++) // parse all successors of each vertex
+    typename VerticeDataSet::const_iterator vertexIt = m_content->verticesArcs.find(vertexId);
+    if (vertexIt != m_content->verticesArcs.end())
+        for (typename SuccessorsSet::const_iterator succit = vertexIt->second.successors().begin(); succit != vertexIt->second.successors().end(); succit++) // parse all successors of each vertex
             arcsSet.insert(ArcID(vertexId, succit->first)); // add the obtained arc to the set.
     return arcsSet;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::ArcIDSet GenericGraph<V, A, DirectedGraph, CompareV>::arcs(const V& vertex) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::ArcIDSet GenericGraph<V, A, DirectedGraph, CompareV, Storage>::arcs(const V& vertex) const
 {
-    if (m_verticesData.find(vertex) != m_verticesData.end())
-        return arcs(m_verticesData.find(vertex)->second);
+    if (m_content->verticesData.find(vertex) != m_content->verticesData.end())
+        return arcs(m_content->verticesData.find(vertex)->second);
     else
         return ArcIDSet();
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexIDSet GenericGraph<V, A, DirectedGraph, CompareV>::successors(const VertexID vertexId) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::VertexIDSet GenericGraph<V, A, DirectedGraph, CompareV, Storage>::successors(const VertexID vertexId) const
 {
     VertexIDSet verticesSet;
-    typename VerticeDataSet::const_iterator vertexIt = m_verticesArcs.find(vertexId);
-    if (vertexIt != m_verticesArcs.end())
-        for (typename SuccessorsSet::const_iterator succit = vertexIt->second.vertexSuccessors.begin(); succit != vertexIt->second.vertexSuccessors.end(); succit++) // parse all successors of each vertex
+    typename VerticeDataSet::const_iterator vertexIt = m_content->verticesArcs.find(vertexId);
+    if (vertexIt != m_content->verticesArcs.end())
+        for (typename SuccessorsSet::const_iterator succit = vertexIt->second.successors().begin(); succit != vertexIt->second.successors().end(); succit++) // parse all successors of each vertex
             verticesSet.insert(succit->first); // add the obtained arc to the set.
     return verticesSet;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexIDSet GenericGraph<V, A, DirectedGraph, CompareV>::successors(const V& vertex) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::VertexIDSet GenericGraph<V, A, DirectedGraph, CompareV, Storage>::successors(const V& vertex) const
 {
-    if (m_verticesData.find(vertex) != m_verticesData.end())
-        return successors(m_verticesData.find(vertex)->second);
+    if (m_content->verticesData.find(vertex) != m_content->verticesData.end())
+        return successors(m_content->verticesData.find(vertex)->second);
     else
         return VertexIDSet();
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexIDSet GenericGraph<V, A, DirectedGraph, CompareV>::predecessors(const VertexID vertexId) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::VertexIDSet GenericGraph<V, A, DirectedGraph, CompareV, Storage>::predecessors(const VertexID vertexId) const
 {
-    typename VerticeDataSet::const_iterator vertexIt = m_verticesArcs.find(vertexId);
-    if (vertexIt != m_verticesArcs.end())
-        return vertexIt->second.vertexPredecessors;
+    typename VerticeDataSet::const_iterator vertexIt = m_content->verticesArcs.find(vertexId);
+    if (vertexIt != m_content->verticesArcs.end())
+        return vertexIt->second.predecessors();
     else
         return VertexIDSet();
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexIDSet GenericGraph<V, A, DirectedGraph, CompareV>::predecessors(const V& vertex) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::VertexIDSet GenericGraph<V, A, DirectedGraph, CompareV, Storage>::predecessors(const V& vertex) const
 {
-    if (m_verticesData.find(vertex) != m_verticesData.end())
-        return predecessors(m_verticesData.find(vertex)->second);
+    if (m_content->verticesData.find(vertex) != m_content->verticesData.end())
+        return predecessors(m_content->verticesData.find(vertex)->second);
     else
         return VertexIDSet();
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-unsigned long GenericGraph<V, A, DirectedGraph, CompareV>::verticesNb() const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+unsigned long GenericGraph<V, A, DirectedGraph, CompareV, Storage>::verticesNb() const
+{
+    return m_content->verticesData.size();
+}
+
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+unsigned long GenericGraph<V, A, DirectedGraph, CompareV, Storage>::arcsNb() const
 {
-    return m_verticesData.size();
+    return m_content->arcsNumber;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-unsigned long GenericGraph<V, A, DirectedGraph, CompareV>::arcsNb() const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+unsigned long GenericGraph<V, A, DirectedGraph, CompareV, Storage>::arcsNb(const VertexID vertexId) const
 {
-    return m_arcsNumber;
+    return successorsNb(vertexId);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-unsigned long GenericGraph<V, A, DirectedGraph, CompareV>::arcsNb(const VertexID vertexId) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+unsigned long GenericGraph<V, A, DirectedGraph, CompareV, Storage>::arcsNb(const V& vertex) const
 {
-    return arcs(vertexId).size();
+    return successorsNb(vertex);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-unsigned long GenericGraph<V, A, DirectedGraph, CompareV>::arcsNb(const V& vertex) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+unsigned long GenericGraph<V, A, DirectedGraph, CompareV, Storage>::successorsNb(const VertexID vertexId) const
 {
-    return arcs(vertex).size();
+    typename VerticeDataSet::const_iterator vertexIt = m_content->verticesArcs.find(vertexId);
+    return vertexIt != m_content->verticesArcs.end() ? vertexIt->second.successors().size() : 0;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-unsigned long GenericGraph<V, A, DirectedGraph, CompareV>::successorsNb(const VertexID vertexId) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+unsigned long GenericGraph<V, A, DirectedGraph, CompareV, Storage>::successorsNb(const V& vertex) const
 {
-    return successors(vertexId).size();
+    typename Vertex2VertexID::const_iterator vertexDataIt = m_content->verticesData.find(vertex);
+    return vertexDataIt != m_content->verticesData.end() ? successorsNb(vertexDataIt->second) : 0;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-unsigned long GenericGraph<V, A, DirectedGraph, CompareV>::successorsNb(const V& vertex) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+unsigned long GenericGraph<V, A, DirectedGraph, CompareV, Storage>::predecessorsNb(const VertexID vertexId) const
 {
-    return successors(vertex).size();
+    typename VerticeDataSet::const_iterator vertexIt = m_content->verticesArcs.find(vertexId);
+    return vertexIt != m_content->verticesArcs.end() ? vertexIt->second.predecessors().size() : 0;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-unsigned long GenericGraph<V, A, DirectedGraph, CompareV>::predecessorsNb(const VertexID vertexId) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+unsigned long GenericGraph<V, A, DirectedGraph, CompareV, Storage>::predecessorsNb(const V& vertex) const
 {
-    return predecessors(vertexId).size();
+    typename Vertex2VertexID::const_iterator vertexDataIt = m_content->verticesData.find(vertex);
+    return vertexDataIt != m_content->verticesData.end() ? predecessorsNb(vertexDataIt->second) : 0;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-unsigned long GenericGraph<V, A, DirectedGraph, CompareV>::predecessorsNb(const V& vertex) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::VertexIDRange GenericGraph<V, A, DirectedGraph, CompareV, Storage>::verticesRange() const
 {
-    return predecessors(vertex).size();
+    return VertexIDRange(m_content->verticesArcs.begin(), m_content->verticesArcs.end(), m_content->verticesArcs.size());
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-void GenericGraph<V, A, DirectedGraph, CompareV>::setVertex(const VertexID vertexId, const V& vertexData)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::SuccessorIDRange GenericGraph<V, A, DirectedGraph, CompareV, Storage>::successorsRange(const VertexID vertexId) const
 {
-    typename VerticeDataSet::iterator vertexIt = m_verticesArcs.find(vertexId);
-    if (vertexIt == m_verticesArcs.end())
+    typename VerticeDataSet::const_iterator vertexIt = m_content->verticesArcs.find(vertexId);
+    if (vertexIt == m_content->verticesArcs.end())
+        return SuccessorIDRange();
+    const SuccessorsSet& successorsSet = vertexIt->second.successors();
+    return SuccessorIDRange(successorsSet.begin(), successorsSet.end(), successorsSet.size());
+}
+
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::PredecessorIDRange GenericGraph<V, A, DirectedGraph, CompareV, Storage>::predecessorsRange(const VertexID vertexId) const
+{
+    typename VerticeDataSet::const_iterator vertexIt = m_content->verticesArcs.find(vertexId);
+    if (vertexIt == m_content->verticesArcs.end())
+        return PredecessorIDRange();
+    const VertexIDSet& predecessorsSet = vertexIt->second.predecessors();
+    return PredecessorIDRange(predecessorsSet.begin(), predecessorsSet.end(), predecessorsSet.size());
+}
+
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::ArcIDRange GenericGraph<V, A, DirectedGraph, CompareV, Storage>::arcsRange(const VertexID vertexId) const
+{
+    typename VerticeDataSet::const_iterator vertexIt = m_content->verticesArcs.find(vertexId);
+    if (vertexIt == m_content->verticesArcs.end())
+        return ArcIDRange();
+    const SuccessorsSet& successorsSet = vertexIt->second.successors();
+    return ArcIDRange(successorsSet.begin(), successorsSet.end(), successorsSet.size(), ArcKey(vertexId));
+}
+
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+void GenericGraph<V, A, DirectedGraph, CompareV, Storage>::setVertex(const VertexID vertexId, const V& vertexData)
+{
+    if (!m_content->verticesArcs.count(vertexId))
         return; // nothing to do, as the Id is not valid
 
+    detach();
+    typename VerticeDataSet::iterator vertexIt = m_content->verticesArcs.find(vertexId);
+
     // Remove the association between old vertex data and vertex id
-    m_verticesData.erase(vertexIt->second.vertexRef);
+    m_content->verticesData.erase(vertexIt->second.vertexRef);
 
     // Set another association between new vertex data and vertex id
-    vertexIt->second.vertexRef = m_verticesData.insert(std::pair<V, VertexID>(vertexData, vertexId)).first;
+    vertexIt->second.vertexRef = m_content->verticesData.insert(std::pair<V, VertexID>(vertexData, vertexId)).first;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-void GenericGraph<V, A, DirectedGraph, CompareV>::setArc(const ArcID& arcId, const A& arcData)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+void GenericGraph<V, A, DirectedGraph, CompareV, Storage>::setArc(const ArcID& arcId, const A& arcData)
 {
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool GenericGraph<V, A, DirectedGraph, CompareV>::isEmpty() const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::isEmpty() const
 {
-    return m_verticesArcs.empty();
+    return m_content->verticesArcs.empty();
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool GenericGraph<V, A, DirectedGraph, CompareV>::exists(const V& vertex) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::exists(const V& vertex) const
 {
-    return (m_verticesData.find(vertex) != m_verticesData.end());
+    return (m_content->verticesData.find(vertex) != m_content->verticesData.end());
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool GenericGraph<V, A, DirectedGraph, CompareV>::exists(const VertexID vertexId) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::exists(const VertexID vertexId) const
 {
-    return (m_verticesArcs.find(vertexId) != m_verticesArcs.end());
+    return (m_content->verticesArcs.find(vertexId) != m_content->verticesArcs.end());
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool GenericGraph<V, A, DirectedGraph, CompareV>::exists(const V& vertex1, const V& vertex2) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::exists(const V& vertex1, const V& vertex2) const
 {
     return (arc(vertex1, vertex2) != IllegalArcID);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool GenericGraph<V, A, DirectedGraph, CompareV>::exists(const VertexID vertex1Id, const VertexID vertex2Id) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::exists(const VertexID vertex1Id, const VertexID vertex2Id) const
 {
     return (arc(vertex1Id, vertex2Id) != IllegalArcID);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool GenericGraph<V, A, DirectedGraph, CompareV>::exists(const ArcID& arcId) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::exists(const ArcID& arcId) const
 {
-    typename VerticeDataSet::const_iterator firstVertexIt = m_verticesArcs.find(arcId.first);
-    if (firstVertexIt == m_verticesArcs.end())
+    typename VerticeDataSet::const_iterator firstVertexIt = m_content->verticesArcs.find(arcId.first);
+    if (firstVertexIt == m_content->verticesArcs.end())
         return false;
 
-    typename VerticeDataSet::const_iterator secondVertexIt = m_verticesArcs.find(arcId.second);
-    if (secondVertexIt == m_verticesArcs.end())
+    typename VerticeDataSet::const_iterator secondVertexIt = m_content->verticesArcs.find(arcId.second);
+    if (secondVertexIt == m_content->verticesArcs.end())
         return false;
 
-    return (firstVertexIt->second.vertexSuccessors.find(arcId.second) != firstVertexIt->second.vertexSuccessors.end());
+    return (firstVertexIt->second.successors().find(arcId.second) != firstVertexIt->second.successors().end());
 }
 
 // Removal methods
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool GenericGraph<V, A, DirectedGraph, CompareV>::remove(const V& vertex)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::remove(const V& vertex)
 {
-    typename Vertex2VertexID::iterator vertexDataIt = m_verticesData.find(vertex);
-    if (vertexDataIt == m_verticesData.end())
+    typename Vertex2VertexID::iterator vertexDataIt = m_content->verticesData.find(vertex);
+    if (vertexDataIt == m_content->verticesData.end())
         return false;
 
     return remove(vertexDataIt->second);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool GenericGraph<V, A, DirectedGraph, CompareV>::remove(const VertexID vertexId)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::remove(const VertexID vertexId)
 {
-    typename VerticeDataSet::iterator vertexIt = m_verticesArcs.find(vertexId);
-    if (vertexIt == m_verticesArcs.end())
+    if (!m_content->verticesArcs.count(vertexId))
         return false;
 
+    detach();
+    typename VerticeDataSet::iterator vertexIt = m_content->verticesArcs.find(vertexId);
+
+    // Held while its neighbours are changed, as they may share it (loops) or copy it
+    std::shared_ptr<const Adjacency> adjacency = vertexIt->second.adjacency;
+
     // Remove this vertex of successors lists of all his predecessors
-    for (typename VertexIDSet::const_iterator predit = vertexIt->second.vertexPredecessors.begin();
-         predit != vertexIt->second.vertexPredecessors.end(); predit++)
-        m_verticesArcs.find(*predit)->second.vertexSuccessors.erase(vertexId);
-    // Update arcs number before remove the arcs
-    m_arcsNumber -= vertexIt->second.vertexPredecessors.size();
-    vertexIt->second.vertexPredecessors.clear();
+    for (typename VertexIDSet::const_iterator predit = adjacency->vertexPredecessors.begin();
+         predit != adjacency->vertexPredecessors.end(); predit++)
+        if (*predit != vertexId)
+            m_content->verticesArcs.find(*predit)->second.mutableAdjacency().vertexSuccessors.erase(vertexId);
 
     // Remove this vertex of predecessors lists of all his successors
-    for (typename SuccessorsSet::const_iterator succit = vertexIt->second.vertexSuccessors.begin();
-         succit != vertexIt->second.vertexSuccessors.end(); succit++)
-        m_verticesArcs.find(succit->first)->second.vertexPredecessors.erase(vertexId);
-    // Update arcs number before remove the arcs
-    m_arcsNumber -= vertexIt->second.vertexSuccessors.size();
-    vertexIt->second.vertexSuccessors.clear();
+    for (typename SuccessorsSet::const_iterator succit = adjacency->vertexSuccessors.begin();
+         succit != adjacency->vertexSuccessors.end(); succit++)
+        if (succit->first != vertexId)
+            m_content->verticesArcs.find(succit->first)->second.mutableAdjacency().vertexPredecessors.erase(vertexId);
+
+    // Update arcs number, a loop being both a successor and a predecessor
+    m_content->arcsNumber -= adjacency->vertexPredecessors.size() + adjacency->vertexSuccessors.size() - adjacency->vertexSuccessors.count(vertexId);
 
     // Remove the vertex from both data structures
-    m_verticesData.erase(vertexIt->second.vertexRef);
-    m_verticesArcs.erase(vertexIt);
+    m_content->verticesData.erase(vertexIt->second.vertexRef);
+    m_content->verticesArcs.erase(vertexIt);
 
     return true;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool GenericGraph<V, A, DirectedGraph, CompareV>::remove(const ArcID& arcId)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::remove(const ArcID& arcId)
 {
-    typename VerticeDataSet::const_iterator firstVertexIt = m_verticesArcs.find(arcId.first);
-    if (firstVertexIt == m_verticesArcs.end())
+    typename VerticeDataSet::const_iterator firstVertexIt = m_content->verticesArcs.find(arcId.first);
+    if (firstVertexIt == m_content->verticesArcs.end())
         return false;
 
-    typename VerticeDataSet::const_iterator secondVertexIt = m_verticesArcs.find(arcId.second);
-    if (secondVertexIt == m_verticesArcs.end())
+    typename VerticeDataSet::const_iterator secondVertexIt = m_content->verticesArcs.find(arcId.second);
+    if (secondVertexIt == m_content->verticesArcs.end())
         return false;
 
     return remove(firstVertexIt->first, secondVertexIt->first);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool GenericGraph<V, A, DirectedGraph, CompareV>::remove(const V& vertex1, const V& vertex2)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::remove(const V& vertex1, const V& vertex2)
 {
-    typename Vertex2VertexID::iterator vertex1DataIt = m_verticesData.find(vertex1);
-    if (vertex1DataIt == m_verticesData.end())
+    typename Vertex2VertexID::iterator vertex1DataIt = m_content->verticesData.find(vertex1);
+    if (vertex1DataIt == m_content->verticesData.end())
         return false;
 
-    typename Vertex2VertexID::iterator vertex2DataIt = m_verticesData.find(vertex2);
-    if (vertex2DataIt == m_verticesData.end())
+    typename Vertex2VertexID::iterator vertex2DataIt = m_content->verticesData.find(vertex2);
+    if (vertex2DataIt == m_content->verticesData.end())
         return false;
 
     return remove(vertex1DataIt->first, vertex2DataIt->first);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool GenericGraph<V, A, DirectedGraph, CompareV>::remove(const VertexID vertex1Id, const VertexID vertex2Id)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::remove(const VertexID vertex1Id, const VertexID vertex2Id)
 {
-    typename VerticeDataSet::iterator vertex1It = m_verticesArcs.find(vertex1Id);
-    if (vertex1It == m_verticesArcs.end())
+    typename VerticeDataSet::const_iterator vertex1It = m_content->verticesArcs.find(vertex1Id);
+    if (vertex1It == m_content->verticesArcs.end())
         return false;
 
-    typename VerticeDataSet::iterator vertex2It = m_verticesArcs.find(vertex2Id);
-    if (vertex2It == m_verticesArcs.end())
+    typename VerticeDataSet::const_iterator vertex2It = m_content->verticesArcs.find(vertex2Id);
+    if (vertex2It == m_content->verticesArcs.end())
         return false;
 
-    typename SuccessorsSet::iterator arcIt = vertex1It->second.vertexSuccessors.find(vertex2Id);
-    if (arcIt == vertex1It->second.vertexSuccessors.end()) // There no such arc
+    if (vertex1It->second.successors().find(vertex2Id) == vertex1It->second.successors().end()) // There no such arc
         return false;
 
+    // Only the arcs of both vertices are copied, if shared with copies of the graph
+    detach();
     // Remove vertex2Id from successors of vertex1Id, and ...
-    vertex1It->second.vertexSuccessors.erase(arcIt);
+    m_content->verticesArcs.find(vertex1Id)->second.mutableAdjacency().vertexSuccessors.erase(vertex2Id);
     // ... vertex1Id from predecessors of vertex2Id, and ...
-    vertex2It->second.vertexPredecessors.erase(vertex1Id);
+    m_content->verticesArcs.find(vertex2Id)->second.mutableAdjacency().vertexPredecessors.erase(vertex1Id);
     // ... update arcs number, and ...
-    --m_arcsNumber;
+    --m_content->arcsNumber;
     // ... tell that we suppressed the arc
     return true;
 }
 
-/*
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexIDPath  GenericGraph<V, A, DirectedGraph, CompareV>::shortestPath(const VertexID sourceVertexId, const VertexID destVertexId)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+CompiledGraph<V, A> GenericGraph<V, A, DirectedGraph, CompareV, Storage>::compile() const
 {
-    // TODO
+    std::vector<VertexID> vertexIds;
+    std::vector<V> vertices;
+    vertexIds.reserve(m_content->verticesArcs.size());
+    vertices.reserve(m_content->verticesArcs.size());
+    for (typename VerticeDataSet::const_iterator it = m_content->verticesArcs.begin(); it != m_content->verticesArcs.end(); it++) {
+        vertexIds.push_back(it->first);
+        vertices.push_back(it->second.vertexRef->first);
+    }
+
+    // Vertices and successors are sorted by Id, so are the successors indexes
+    std::vector<unsigned long> successorsOffsets(1, 0);
+    std::vector<unsigned long> successors;
+    std::vector<A> arcs;
+    successorsOffsets.reserve(m_content->verticesArcs.size() + 1);
+    successors.reserve(m_content->arcsNumber);
+    arcs.reserve(m_content->arcsNumber);
+    for (typename VerticeDataSet::const_iterator it = m_content->verticesArcs.begin(); it != m_content->verticesArcs.end(); it++) {
+        for (typename SuccessorsSet::const_iterator succit = it->second.successors().begin(); succit != it->second.successors().end(); succit++) {
+            successors.push_back(std::lower_bound(vertexIds.begin(), vertexIds.end(), succit->first) - vertexIds.begin());
+            arcs.push_back(succit->second);
+        }
+        successorsOffsets.push_back(successors.size());
+    }
+
+    CompiledGraph<V, A> compiledGraph;
+    compiledGraph.assign(vertexIds, vertices, successorsOffsets, successors, arcs);
+    return compiledGraph;
+}
+
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::VertexIDPath GenericGraph<V, A, DirectedGraph, CompareV, Storage>::shortestPath(const VertexID sourceVertexId, const VertexID destVertexId, const ArcWeight& arcWeight) const
+{
+    if (!exists(sourceVertexId) || !exists(destVertexId)) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Unable to find vertex with vertex Id " << (exists(sourceVertexId) ? destVertexId : sourceVertexId);
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    CompiledGraph<V, A> compiledGraph = compile();
+    PathFinder<V, A> pathFinder(compiledGraph, arcWeight);
+    std::vector<unsigned long> indexesPath;
+    VertexIDPath path;
+    if (pathFinder.shortestPath(compiledGraph.index(sourceVertexId), compiledGraph.index(destVertexId), indexesPath))
+        for (unsigned long index : indexesPath)
+            path.push_back(compiledGraph.vertexId(index));
+    return path;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-typename GenericGraph<V, A, DirectedGraph, CompareV>::VertexIDPath  GenericGraph<V, A, DirectedGraph, CompareV>::shortestPath(const V & sourceVertex, const V & destVertex)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+typename GenericGraph<V, A, DirectedGraph, CompareV, Storage>::VertexIDPath GenericGraph<V, A, DirectedGraph, CompareV, Storage>::shortestPath(const V& sourceVertex, const V& destVertex, const ArcWeight& arcWeight) const
 {
-    // TODO
+    return shortestPath(vertex(sourceVertex), vertex(destVertex), arcWeight);
 }
-//*/
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool GenericGraph<V, A, DirectedGraph, CompareV>::save(const char* writeFileName) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::save(const char* writeFileName) const
 {
     std::fstream outFile;
     outFile.open(writeFileName, std::ios_base::out | std::ios_base::trunc);
@@ -1067,8 +1620,14 @@ bool GenericGraph<V, A, DirectedGraph, CompareV>::save(const char* writeFileName
     return success;
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool GenericGraph<V, A, DirectedGraph, CompareV>::save(std::ostream& ost) const
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::saveBinary(const char* writeFileName) const
+{
+    return compile().save(writeFileName);
+}
+
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::save(std::ostream& ost) const
 {
     std::string indentStr[5] = {
         "",
@@ -1096,13 +1655,13 @@ bool GenericGraph<V, A, DirectedGraph, CompareV>::save(std::ostream& ost) const
     ++indentLevel;
 
     // Parse each vertex, and write its data
-    for (typename VerticeDataSet::const_iterator it = m_verticesArcs.begin(); it != m_verticesArcs.end(); it++)
+    for (typename VerticeDataSet::const_iterator it = m_content->verticesArcs.begin(); it != m_content->verticesArcs.end(); it++)
         ost << indentStr[indentLevel]
             << "<node id=\"" << it->first << "\"/>" << std::endl;
 
     // Parse each successor of each vertex, and write the data of this arc
-    for (typename VerticeDataSet::const_iterator it = m_verticesArcs.begin(); it != m_verticesArcs.end(); it++)
-        for (typename SuccessorsSet::const_iterator succit = it->second.vertexSuccessors.begin(); succit != it->second.vertexSuccessors.end(); succit++)
+    for (typename VerticeDataSet::const_iterator it = m_content->verticesArcs.begin(); it != m_content->verticesArcs.end(); it++)
+        for (typename SuccessorsSet::const_iterator succit = it->second.successors().begin(); succit != it->second.successors().end(); succit++)
             ost << indentStr[indentLevel]
                 << "<edge source=\"" << it->first
                 << "\" target=\"" << succit->first << "\"/>" << std::endl;
@@ -1118,18 +1677,247 @@ bool GenericGraph<V, A, DirectedGraph, CompareV>::save(std::ostream& ost) const
     return true;
 }
 
-/*
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool  GenericGraph<V, A, DirectedGraph, CompareV>::load(const char *readFileName)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::load(const char* readFileName, const VertexLoader& vertexLoader, const ArcLoader& arcLoader, std::string* errorMessage, const VertexReleaser& vertexReleaser)
+{
+    std::ifstream inFile(readFileName);
+    if (!inFile.is_open()) {
+        if (errorMessage)
+            *errorMessage = std::string("Unable to open ") + readFileName + ".";
+        return false;
+    }
+    return load(inFile, vertexLoader, arcLoader, errorMessage, vertexReleaser);
+}
+
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::load(std::istream& ist, const VertexLoader& vertexLoader, const ArcLoader& arcLoader, std::string* errorMessage, const VertexReleaser& vertexReleaser)
+{
+    if (!vertexLoader) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": No vertex loader given.";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    // Builds the vertex of each node as soon as it is read, and keeps the edges until all the vertices are known
+    class Loader : public GraphMLReader::Handler {
+    public:
+        struct Edge {
+            std::string source;
+            std::string target;
+            bool directed;
+            GraphMLReader::Attributes data;
+        };
+
+        Loader(const VertexLoader& vertexLoader)
+            : vertices()
+            , positions()
+            , edges()
+            , name()
+            , error()
+            , m_vertexLoader(vertexLoader)
+            , m_idGenerator(UniqueIDGenerator<VertexID>::Generator())
+            , m_givenIds()
+            , m_graphsNb(0)
+        {
+        }
+
+        virtual void graph(const std::string& id, bool)
+        {
+            if (m_graphsNb++ > 0)
+                error = "Several graphs in the stream.";
+            else if (id != "_NONAME_")
+                name = id;
+        }
+
+        virtual void node(const std::string& id, const GraphMLReader::Attributes& data)
+        {
+            if (!error.empty())
+                return;
+            // A numeric id is reserved before its vertex is built, so that no Id generated afterwards takes it
+            VertexID vertexId = nodeNumber(id);
+            if (vertexId != IllegalVertexID)
+                m_idGenerator->reserve(vertexId);
+            V vertex = m_vertexLoader(id, data, vertexId);
+            vertices.push_back(VertexEntry(vertexId, vertex));
+            if (!positions.insert(std::make_pair(id, vertices.size() - 1)).second || (vertexId != IllegalVertexID && !m_givenIds.insert(vertexId).second))
+                error = "Duplicate node " + id + ".";
+            else if (vertexId != IllegalVertexID)
+                m_idGenerator->reserve(vertexId);
+        }
+
+        virtual void edge(const std::string& source, const std::string& target, bool directed, const GraphMLReader::Attributes& data)
+        {
+            if (error.empty())
+                edges.push_back(Edge { source, target, directed, data });
+        }
+
+        std::vector<VertexEntry> vertices;
+        std::unordered_map<std::string, unsigned long> positions; ///< Position of the vertex of each node id
+        std::vector<Edge> edges;
+        std::string name;
+        std::string error;
+
+    private:
+        // Id of a numeric node id, IllegalVertexID for the other ids
+        static VertexID nodeNumber(const std::string& id)
+        {
+            if (id.empty() || id.size() > 19 || id.find_first_not_of("0123456789") != std::string::npos)
+                return IllegalVertexID;
+            return strtoul(id.c_str(), NULL, 10);
+        }
+
+        const VertexLoader& m_vertexLoader;
+        UniqueIDGenerator<VertexID>* m_idGenerator;
+        std::unordered_set<VertexID> m_givenIds;
+        unsigned m_graphsNb;
+    };
+
+    Loader loader(vertexLoader);
+    GraphMLReader reader(ist);
+    std::string error;
+    std::vector<ArcEntry> arcs;
+    try {
+        if (!reader.read(loader))
+            error = reader.error();
+        else
+            error = loader.error;
+
+        // Generated once all the numeric ids are reserved, so that they never collide
+        if (error.empty())
+            for (VertexEntry& vertex : loader.vertices)
+                if (vertex.first == IllegalVertexID)
+                    vertex.first = UniqueIDGenerator<VertexID>::Generator()->newId();
+
+        arcs.reserve(loader.edges.size());
+        for (typename std::vector<typename Loader::Edge>::const_iterator it = loader.edges.begin(); error.empty() && it != loader.edges.end(); it++) {
+            typename std::unordered_map<std::string, unsigned long>::const_iterator tail = loader.positions.find(it->source), head = loader.positions.find(it->target);
+            if (tail == loader.positions.end() || head == loader.positions.end()) {
+                error = "Edge " + it->source + "->" + it->target + " between unknown nodes.";
+                break;
+            }
+            const VertexID tailId = loader.vertices[tail->second].first, headId = loader.vertices[head->second].first;
+            A newArc = arcLoader ? arcLoader(tailId, headId, it->data) : A();
+            arcs.push_back(ArcEntry { tailId, headId, newArc });
+            if (!it->directed && tailId != headId)
+                arcs.push_back(ArcEntry { headId, tailId, newArc });
+        }
+
+        if (error.empty())
+            try {
+                build(loader.vertices, arcs);
+            } catch (const std::invalid_argument& exception) {
+                // Vertices equivalent for CompareV
+                error = exception.what();
+            }
+    } catch (...) {
+        if (vertexReleaser)
+            for (const VertexEntry& vertex : loader.vertices)
+                vertexReleaser(vertex.second);
+        throw;
+    }
+
+    if (error.empty()) {
+        if (!loader.name.empty())
+            setName(loader.name.c_str());
+        return true;
+    }
+    if (vertexReleaser)
+        for (const VertexEntry& vertex : loader.vertices)
+            vertexReleaser(vertex.second);
+    if (errorMessage)
+        *errorMessage = error;
+    return false;
+}
+
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::loadEdgeList(const char* readFileName, const EdgeListVertexLoader& vertexLoader, const EdgeListArcLoader& arcLoader, std::string* errorMessage, const VertexReleaser& vertexReleaser)
 {
-    // \todo Implement graph loading from xml file method
+    std::ifstream inFile(readFileName);
+    if (!inFile.is_open()) {
+        if (errorMessage)
+            *errorMessage = std::string("Unable to open ") + readFileName + ".";
+        return false;
+    }
+    return loadEdgeList(inFile, vertexLoader, arcLoader, errorMessage, vertexReleaser);
 }
 
-template <typename V, typename A, bool DirectedGraph, class CompareV>
-bool  GenericGraph<V, A, DirectedGraph, CompareV>::load(std::ostream &ost)
+template <typename V, typename A, bool DirectedGraph, class CompareV, class Storage>
+bool GenericGraph<V, A, DirectedGraph, CompareV, Storage>::loadEdgeList(std::istream& ist, const EdgeListVertexLoader& vertexLoader, const EdgeListArcLoader& arcLoader, std::string* errorMessage, const VertexReleaser& vertexReleaser)
 {
-    // \todo Implement graph loading from xml file method
+    if (!vertexLoader) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": No vertex loader given.";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    std::vector<ArcEntry> arcs;
+    std::vector<VertexID> vertexIds;
+    std::string line;
+    for (unsigned long lineNb = 1; std::getline(ist, line); ++lineNb) {
+        const char* first = line.c_str();
+        while (*first == ' ' || *first == '\t' || *first == '\r')
+            ++first;
+        if (*first == '\0' || *first == '#')
+            continue;
+
+        // Two Ids, each followed by a blank or by the end of the line
+        VertexID ids[2];
+        const char* last = first;
+        for (VertexID& id : ids) {
+            while (*last == ' ' || *last == '\t')
+                ++last;
+            char* idEnd;
+            id = (*last >= '0' && *last <= '9') ? std::strtoul(last, &idEnd, 10) : IllegalVertexID;
+            if (id == IllegalVertexID || (*idEnd != '\0' && *idEnd != ' ' && *idEnd != '\t' && *idEnd != '\r')) {
+                if (errorMessage) {
+                    std::ostringstream errorStream;
+                    errorStream << "Line " << lineNb << ": expected the Ids of the tail and head of an arc.";
+                    *errorMessage = errorStream.str();
+                }
+                return false;
+            }
+            last = idEnd;
+        }
+        while (*last == ' ' || *last == '\t')
+            ++last;
+
+        std::string data(last);
+        if (!data.empty() && data.back() == '\r')
+            data.pop_back();
+        arcs.push_back(ArcEntry { ids[0], ids[1], arcLoader ? arcLoader(ids[0], ids[1], data) : A() });
+        vertexIds.push_back(ids[0]);
+        vertexIds.push_back(ids[1]);
+    }
+
+    std::sort(vertexIds.begin(), vertexIds.end());
+    vertexIds.erase(std::unique(vertexIds.begin(), vertexIds.end()), vertexIds.end());
+    std::vector<VertexEntry> vertices;
+    vertices.reserve(vertexIds.size());
+    std::string error;
+    try {
+        for (VertexID vertexId : vertexIds)
+            vertices.push_back(VertexEntry(vertexId, vertexLoader(vertexId)));
+        try {
+            build(vertices, arcs);
+        } catch (const std::invalid_argument& exception) {
+            // Vertices equivalent for CompareV
+            error = exception.what();
+        }
+    } catch (...) {
+        if (vertexReleaser)
+            for (const VertexEntry& vertex : vertices)
+                vertexReleaser(vertex.second);
+        throw;
+    }
+
+    if (error.empty())
+        return true;
+    if (vertexReleaser)
+        for (const VertexEntry& vertex : vertices)
+            vertexReleaser(vertex.second);
+    if (errorMessage)
+        *errorMessage = error;
+    return false;
 }
-//*/
 
 #endif // GENERICGRAPH_H
@@ -0,0 +1,314 @@
+#ifndef GRAPHALGORITHMS_H
+#define GRAPHALGORITHMS_H
+
+#include "CompiledGraph.h"
+#include "ParallelTasks.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+/**
+  * \brief  Multi-threaded algorithms on graph snapshots (see CompiledGraph), for large topologies.
+  *
+  * The graph is explored by frontiers: all the vertices of a frontier are expanded at the same time by the threads,
+  * which claim the vertices they find with atomic flags, so that each vertex is found by a single thread. Small
+  * frontiers (under parallelFrontierSize vertices) are expanded by the calling thread alone, so that graphs of large
+  * diameter do not pay a thread creation at each step.
+  *
+  * The number of threads is the number of hardware threads when it is 0 (see ParallelTasks). The distances and the
+  * components found do not depend on it; the parents chosen by breadthFirstSearch() do (see its caveat).
+  */
+template <typename V, typename A>
+class GraphAlgorithms {
+public: // Types and consts
+    typedef CompiledGraph<V, A> Graph;
+    typedef typename Graph::VertexIndex VertexIndex;
+    static const unsigned long Unreached; // = ~(unsigned long)(0);
+    static const unsigned long parallelFrontierSize = 4096;
+
+public: // Methods
+    /**
+      * \brief  Breadth-first search from a vertex
+      * \param  distances   set to the number of arcs from source to each vertex, by index (Unreached if there is no
+      *                     path)
+      * \param  parents     set to the vertex from which each vertex is reached (IllegalVertexIndex for source and the
+      *                     vertices not reached). Among the vertices of the previous frontier, the one that reaches a
+      *                     vertex first depends on the threads.
+      * \throw  std::invalid_argument if source is out of the graph
+      */
+    static void breadthFirstSearch(const Graph& graph, const VertexIndex source, std::vector<unsigned long>& distances,
+        std::vector<VertexIndex>& parents, unsigned threadsNb = 0);
+
+    /**
+      * \brief  Finds the strongly connected components of the graph
+      * \param  components  set to the number of the component of each vertex, by index. Components are numbered from
+      *                     0, in the order of their first vertex.
+      * \return the number of components
+      *
+      * The vertices without predecessors or without successors are first removed in parallel, each being a component
+      * alone, until there are no more of them. The component of the vertex with the most arcs left (usually the giant
+      * component of large networks) is then found by two parallel searches, along the arcs and in reverse; the other
+      * components are found by Tarjan's algorithm.
+      */
+    static unsigned long stronglyConnectedComponents(const Graph& graph, std::vector<unsigned long>& components, unsigned threadsNb = 0);
+
+    /**
+      * \brief  Finds the weakly connected components of the graph, the arcs being followed in both directions
+      * \param  components  set to the number of the component of each vertex, by index. Components are numbered from
+      *                     0, in the order of their first vertex.
+      * \return the number of components
+      *
+      * The components are found by the calling thread, in a time linear in the size of the graph.
+      */
+    static unsigned long weaklyConnectedComponents(const Graph& graph, std::vector<unsigned long>& components);
+
+private:
+    typedef std::unique_ptr<std::atomic<unsigned char>[]> Flags;
+
+    static const unsigned long chunkSize = 256; // Vertices of a frontier taken at once by a thread
+
+    /**
+      * \brief  Replaces the frontier by the vertices found by expand(vertex, found) from each of its vertices
+      */
+    template <class Expand>
+    static void expandFrontier(std::vector<VertexIndex>& frontier, std::vector<std::vector<VertexIndex>>& threadFrontiers,
+        unsigned threadsNb, const Expand& expand);
+
+    /**
+      * \brief  Explores the graph from source (along the arcs, or in reverse), calling visit(vertex, parent, distance)
+      *         once for each vertex reached. Vertices already claimed are not entered.
+      */
+    template <class Visit>
+    static void traverse(const Graph& graph, const VertexIndex source, bool backward, std::atomic<unsigned char>* claimed,
+        unsigned threadsNb, const Visit& visit);
+};
+
+template <typename V, typename A>
+const unsigned long GraphAlgorithms<V, A>::Unreached = ~(unsigned long)(0);
+
+template <typename V, typename A>
+const unsigned long GraphAlgorithms<V, A>::parallelFrontierSize;
+
+template <typename V, typename A>
+const unsigned long GraphAlgorithms<V, A>::chunkSize;
+
+template <typename V, typename A>
+template <class Expand>
+void GraphAlgorithms<V, A>::expandFrontier(std::vector<VertexIndex>& frontier, std::vector<std::vector<VertexIndex>>& threadFrontiers,
+    unsigned threadsNb, const Expand& expand)
+{
+    const unsigned frontierThreadsNb = frontier.size() < parallelFrontierSize ? 1 : threadsNb;
+    threadFrontiers.resize(std::max<size_t>(threadFrontiers.size(), frontierThreadsNb));
+    std::atomic<unsigned long> nextChunk(0);
+    ParallelTasks::run(frontierThreadsNb, [&](unsigned threadIndex) {
+        std::vector<VertexIndex>& found = threadFrontiers[threadIndex];
+        found.clear();
+        unsigned long first;
+        while ((first = nextChunk.fetch_add(chunkSize)) < frontier.size()) {
+            const unsigned long last = std::min<unsigned long>(first + chunkSize, frontier.size());
+            for (unsigned long position = first; position < last; ++position)
+                expand(frontier[position], found);
+        }
+    });
+
+    frontier.clear();
+    for (unsigned threadIndex = 0; threadIndex < frontierThreadsNb; ++threadIndex)
+        frontier.insert(frontier.end(), threadFrontiers[threadIndex].begin(), threadFrontiers[threadIndex].end());
+}
+
+template <typename V, typename A>
+template <class Visit>
+void GraphAlgorithms<V, A>::traverse(const Graph& graph, const VertexIndex source, bool backward, std::atomic<unsigned char>* claimed,
+    unsigned threadsNb, const Visit& visit)
+{
+    std::vector<VertexIndex> frontier(1, source);
+    std::vector<std::vector<VertexIndex>> threadFrontiers;
+    claimed[source].store(1, std::memory_order_relaxed);
+    visit(source, Graph::IllegalVertexIndex, 0);
+    for (unsigned long distance = 1; !frontier.empty(); ++distance)
+        expandFrontier(frontier, threadFrontiers, threadsNb, [&](const VertexIndex vertex, std::vector<VertexIndex>& found) {
+            for (VertexIndex neighbour : backward ? graph.predecessors(vertex) : graph.successors(vertex))
+                if (claimed[neighbour].load(std::memory_order_relaxed) == 0 && claimed[neighbour].exchange(1, std::memory_order_relaxed) == 0) {
+                    visit(neighbour, vertex, distance);
+                    found.push_back(neighbour);
+                }
+        });
+}
+
+template <typename V, typename A>
+void GraphAlgorithms<V, A>::breadthFirstSearch(const Graph& graph, const VertexIndex source, std::vector<unsigned long>& distances,
+    std::vector<VertexIndex>& parents, unsigned threadsNb)
+{
+    const unsigned long n = graph.verticesNb();
+    if (source >= n) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Vertex index " << source << " out of the " << n << " vertices.";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    distances.assign(n, Unreached);
+    parents.assign(n, Graph::IllegalVertexIndex);
+    Flags claimed(new std::atomic<unsigned char>[n]);
+    for (VertexIndex vertex = 0; vertex < n; ++vertex)
+        claimed[vertex].store(0, std::memory_order_relaxed);
+
+    // Each vertex is visited by the only thread that claimed it
+    traverse(graph, source, false, claimed.get(), ParallelTasks::threadsNb(threadsNb), [&distances, &parents](const VertexIndex vertex, const VertexIndex parent, unsigned long distance) {
+        distances[vertex] = distance;
+        parents[vertex] = parent;
+    });
+}
+
+template <typename V, typename A>
+unsigned long GraphAlgorithms<V, A>::stronglyConnectedComponents(const Graph& graph, std::vector<unsigned long>& components, unsigned threadsNb)
+{
+    const unsigned long n = graph.verticesNb();
+    threadsNb = ParallelTasks::threadsNb(threadsNb);
+
+    // Until the end, the component of a vertex is given by the index of one of its vertices
+    components.assign(n, Unreached);
+    Flags removed(new std::atomic<unsigned char>[n]);
+    std::unique_ptr<std::atomic<unsigned long>[]> predecessorsNb(new std::atomic<unsigned long>[n]);
+    std::unique_ptr<std::atomic<unsigned long>[]> successorsNb(new std::atomic<unsigned long>[n]);
+    std::vector<VertexIndex> frontier;
+    std::vector<std::vector<VertexIndex>> threadFrontiers;
+    for (VertexIndex vertex = 0; vertex < n; ++vertex) {
+        predecessorsNb[vertex].store(graph.predecessorsNb(vertex), std::memory_order_relaxed);
+        successorsNb[vertex].store(graph.successorsNb(vertex), std::memory_order_relaxed);
+        const bool trimmed = graph.predecessorsNb(vertex) == 0 || graph.successorsNb(vertex) == 0;
+        removed[vertex].store(trimmed, std::memory_order_relaxed);
+        if (trimmed)
+            frontier.push_back(vertex);
+    }
+
+    // Trimming: a vertex without predecessors or successors left is a component alone
+    while (!frontier.empty())
+        expandFrontier(frontier, threadFrontiers, threadsNb, [&](const VertexIndex vertex, std::vector<VertexIndex>& found) {
+            components[vertex] = vertex;
+            for (VertexIndex successor : graph.successors(vertex))
+                if (predecessorsNb[successor].fetch_sub(1, std::memory_order_relaxed) == 1 && removed[successor].exchange(1, std::memory_order_relaxed) == 0)
+                    found.push_back(successor);
+            for (VertexIndex predecessor : graph.predecessors(vertex))
+                if (successorsNb[predecessor].fetch_sub(1, std::memory_order_relaxed) == 1 && removed[predecessor].exchange(1, std::memory_order_relaxed) == 0)
+                    found.push_back(predecessor);
+        });
+
+    // Component of the vertex with the most arcs left: the vertices reached from it, that reach it in reverse
+    VertexIndex pivot = Graph::IllegalVertexIndex;
+    double pivotDegree = -1;
+    for (VertexIndex vertex = 0; vertex < n; ++vertex) {
+        double degree = (double)predecessorsNb[vertex].load(std::memory_order_relaxed) * successorsNb[vertex].load(std::memory_order_relaxed);
+        if (!removed[vertex].load(std::memory_order_relaxed) && degree > pivotDegree) {
+            pivot = vertex;
+            pivotDegree = degree;
+        }
+    }
+    if (pivot != Graph::IllegalVertexIndex) {
+        std::vector<unsigned char> reached(n, 0);
+        Flags claimed(new std::atomic<unsigned char>[n]);
+        for (VertexIndex vertex = 0; vertex < n; ++vertex)
+            claimed[vertex].store(removed[vertex].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        traverse(graph, pivot, false, claimed.get(), threadsNb, [&reached](const VertexIndex vertex, const VertexIndex, unsigned long) {
+            reached[vertex] = 1;
+        });
+
+        for (VertexIndex vertex = 0; vertex < n; ++vertex)
+            claimed[vertex].store(!reached[vertex], std::memory_order_relaxed);
+        traverse(graph, pivot, true, claimed.get(), threadsNb, [&components, pivot](const VertexIndex vertex, const VertexIndex, unsigned long) {
+            components[vertex] = pivot;
+        });
+        for (VertexIndex vertex = 0; vertex < n; ++vertex)
+            if (components[vertex] == pivot)
+                removed[vertex].store(1, std::memory_order_relaxed);
+    }
+
+    // Tarjan's algorithm on the vertices left, without recursion
+    std::vector<unsigned long> orders(n, Unreached), lowLinks(n, 0);
+    std::vector<unsigned char> onStack(n, 0);
+    std::vector<VertexIndex> stack;
+    std::vector<std::pair<VertexIndex, unsigned long>> calls; // Vertex, and position of its next successor
+    unsigned long order = 0;
+    for (VertexIndex root = 0; root < n; ++root) {
+        if (removed[root].load(std::memory_order_relaxed) || orders[root] != Unreached)
+            continue;
+        orders[root] = lowLinks[root] = order++;
+        stack.push_back(root);
+        onStack[root] = 1;
+        calls.push_back(std::make_pair(root, 0));
+        while (!calls.empty()) {
+            const VertexIndex vertex = calls.back().first;
+            typename Graph::IndexRange successors = graph.successors(vertex);
+            if (calls.back().second < successors.size()) {
+                const VertexIndex successor = successors[calls.back().second++];
+                if (removed[successor].load(std::memory_order_relaxed))
+                    continue;
+                if (orders[successor] == Unreached) {
+                    orders[successor] = lowLinks[successor] = order++;
+                    stack.push_back(successor);
+                    onStack[successor] = 1;
+                    calls.push_back(std::make_pair(successor, 0));
+                } else if (onStack[successor])
+                    lowLinks[vertex] = std::min(lowLinks[vertex], orders[successor]);
+                continue;
+            }
+
+            calls.pop_back();
+            if (!calls.empty())
+                lowLinks[calls.back().first] = std::min(lowLinks[calls.back().first], lowLinks[vertex]);
+            if (lowLinks[vertex] == orders[vertex]) {
+                VertexIndex member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    onStack[member] = 0;
+                    components[member] = vertex;
+                } while (member != vertex);
+            }
+        }
+    }
+
+    // Components numbered in the order of their first vertex
+    std::vector<unsigned long> numbers(n, Unreached);
+    unsigned long componentsNb = 0;
+    for (VertexIndex vertex = 0; vertex < n; ++vertex) {
+        unsigned long& number = numbers[components[vertex]];
+        if (number == Unreached)
+            number = componentsNb++;
+        components[vertex] = number;
+    }
+    return componentsNb;
+}
+
+template <typename V, typename A>
+unsigned long GraphAlgorithms<V, A>::weaklyConnectedComponents(const Graph& graph, std::vector<unsigned long>& components)
+{
+    const unsigned long n = graph.verticesNb();
+    components.assign(n, Unreached);
+    unsigned long componentsNb = 0;
+    std::vector<VertexIndex> queue;
+    for (VertexIndex first = 0; first < n; ++first) {
+        if (components[first] != Unreached)
+            continue;
+
+        // Breadth-first search along the arcs and in reverse
+        queue.assign(1, first);
+        components[first] = componentsNb;
+        for (unsigned long position = 0; position < queue.size(); ++position) {
+            const VertexIndex vertex = queue[position];
+            for (typename Graph::IndexRange neighbours : { graph.successors(vertex), graph.predecessors(vertex) })
+                for (VertexIndex neighbour : neighbours)
+                    if (components[neighbour] == Unreached) {
+                        components[neighbour] = componentsNb;
+                        queue.push_back(neighbour);
+                    }
+        }
+        ++componentsNb;
+    }
+    return componentsNb;
+}
+
+#endif // GRAPHALGORITHMS_H
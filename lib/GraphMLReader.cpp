@@ -0,0 +1,373 @@
+#include "GraphMLReader.h"
+
+#include <cstring>
+#include <sstream>
+
+namespace {
+const int endOfFile = std::char_traits<char>::eof();
+
+bool isSpace(int c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isNameChar(int c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '.'
+        || c == ':' || c >= 0x80;
+}
+
+/**
+  * \brief  Returns the name without its namespace prefix
+  */
+std::string localName(const std::string& name)
+{
+    std::string::size_type colon = name.find(':');
+    return colon == std::string::npos ? name : name.substr(colon + 1);
+}
+
+/**
+  * \brief  Appends the UTF-8 encoding of the given code point
+  */
+void appendUtf8(std::string& text, unsigned long code)
+{
+    if (code < 0x80)
+        text += (char)code;
+    else if (code < 0x800) {
+        text += (char)(0xC0 | (code >> 6));
+        text += (char)(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        text += (char)(0xE0 | (code >> 12));
+        text += (char)(0x80 | ((code >> 6) & 0x3F));
+        text += (char)(0x80 | (code & 0x3F));
+    } else {
+        text += (char)(0xF0 | (code >> 18));
+        text += (char)(0x80 | ((code >> 12) & 0x3F));
+        text += (char)(0x80 | ((code >> 6) & 0x3F));
+        text += (char)(0x80 | (code & 0x3F));
+    }
+}
+}
+
+GraphMLReader::GraphMLReader(std::istream& ist)
+    : m_buffer(ist.rdbuf())
+    , m_line(1)
+    , m_error()
+    , m_keys()
+    , m_directed(true)
+    , m_inGraph(false)
+    , m_graphsNb(0)
+    , m_element(NoElement)
+    , m_elementId()
+    , m_source()
+    , m_target()
+    , m_edgeDirection(-1)
+    , m_data()
+    , m_openElements()
+    , m_tagName()
+    , m_tagAttributes()
+    , m_text()
+    , m_collectText(false)
+    , m_dataKey()
+    , m_currentKey(NULL)
+    , m_inDefault(false)
+{
+}
+
+int GraphMLReader::get()
+{
+    int c = m_buffer->sbumpc();
+    if (c == '\n')
+        ++m_line;
+    return c;
+}
+
+bool GraphMLReader::skipUntil(const char* end, std::string* text)
+{
+    const std::string::size_type length = strlen(end);
+    std::string window;
+    int c;
+    while ((c = get()) != endOfFile) {
+        window += (char)c;
+        if (window.size() > length)
+            window.erase(0, 1);
+        if (text)
+            *text += (char)c;
+        if (window == end) {
+            if (text)
+                text->resize(text->size() - length);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GraphMLReader::readName(std::string& name)
+{
+    name.clear();
+    while (isNameChar(m_buffer->sgetc()))
+        name += (char)get();
+    return !name.empty();
+}
+
+bool GraphMLReader::appendText(std::string& text, int c)
+{
+    if (c != '&') {
+        text += (char)c;
+        return true;
+    }
+
+    std::string entity;
+    while ((c = get()) != ';') {
+        if (c == endOfFile || entity.size() > 10)
+            return fail("Unterminated entity reference");
+        entity += (char)c;
+    }
+    if (entity == "lt")
+        text += '<';
+    else if (entity == "gt")
+        text += '>';
+    else if (entity == "amp")
+        text += '&';
+    else if (entity == "quot")
+        text += '"';
+    else if (entity == "apos")
+        text += '\'';
+    else if (entity.size() > 1 && entity[0] == '#') {
+        char* last;
+        unsigned long code = entity[1] == 'x' ? strtoul(entity.c_str() + 2, &last, 16) : strtoul(entity.c_str() + 1, &last, 10);
+        if (*last != '\0' || code > 0x10FFFF)
+            return fail("Invalid character reference &" + entity + ";");
+        appendUtf8(text, code);
+    } else
+        return fail("Unknown entity &" + entity + ";");
+    return true;
+}
+
+bool GraphMLReader::readTag(std::string& name, TagAttributes& attributes, bool& empty)
+{
+    empty = false;
+    attributes.clear();
+    if (!readName(name))
+        return fail("Invalid element name");
+
+    std::string attributeName;
+    while (1) {
+        while (isSpace(m_buffer->sgetc()))
+            get();
+        int c = m_buffer->sgetc();
+        if (c == '>') {
+            get();
+            return true;
+        }
+        if (c == '/') {
+            get();
+            if (get() != '>')
+                return fail("Invalid end of element <" + name + ">");
+            empty = true;
+            return true;
+        }
+
+        if (!readName(attributeName))
+            return fail("Invalid attribute in element <" + name + ">");
+        while (isSpace(m_buffer->sgetc()))
+            get();
+        if (get() != '=')
+            return fail("Missing value of attribute " + attributeName);
+        while (isSpace(m_buffer->sgetc()))
+            get();
+        int quote = get();
+        if (quote != '"' && quote != '\'')
+            return fail("Unquoted value of attribute " + attributeName);
+
+        attributes.push_back(std::pair<std::string, std::string>(localName(attributeName), std::string()));
+        while ((c = get()) != quote) {
+            if (c == endOfFile || c == '<')
+                return fail("Unterminated value of attribute " + attributeName);
+            if (!appendText(attributes.back().second, c))
+                return false;
+        }
+    }
+}
+
+const std::string* GraphMLReader::attribute(const std::string& name) const
+{
+    for (TagAttributes::const_iterator it = m_tagAttributes.begin(); it != m_tagAttributes.end(); it++)
+        if (it->first == name)
+            return &it->second;
+    return NULL;
+}
+
+bool GraphMLReader::read(Handler& handler)
+{
+    int c;
+    while ((c = get()) != endOfFile) {
+        if (c != '<') {
+            // Text is only kept in data and default values
+            if (m_collectText && !appendText(m_text, c))
+                return false;
+            continue;
+        }
+
+        c = m_buffer->sgetc();
+        if (c == '?') {
+            if (!skipUntil("?>"))
+                return fail("Unterminated processing instruction");
+        } else if (c == '!') {
+            get();
+            if (m_buffer->sgetc() == '-') {
+                get();
+                if (get() != '-' || !skipUntil("-->"))
+                    return fail("Invalid comment");
+            } else if (m_buffer->sgetc() == '[') {
+                for (const char* expected = "[CDATA["; *expected; ++expected)
+                    if (get() != *expected)
+                        return fail("Invalid CDATA section");
+                if (!skipUntil("]]>", m_collectText ? &m_text : NULL))
+                    return fail("Unterminated CDATA section");
+            } else {
+                // Document type declaration, with its optional internal subset
+                int depth = 0;
+                while ((c = get()) != '>' || depth > 0) {
+                    if (c == endOfFile)
+                        return fail("Unterminated declaration");
+                    depth += (c == '[') - (c == ']');
+                }
+            }
+        } else if (c == '/') {
+            get();
+            if (!readName(m_tagName))
+                return fail("Invalid end tag");
+            while (isSpace(m_buffer->sgetc()))
+                get();
+            if (get() != '>')
+                return fail("Invalid end tag </" + m_tagName + ">");
+            if (m_openElements.empty() || m_openElements.back() != m_tagName)
+                return fail("Unexpected end tag </" + m_tagName + ">");
+            m_openElements.pop_back();
+            if (!endElement(localName(m_tagName), handler))
+                return false;
+        } else {
+            bool empty;
+            if (!readTag(m_tagName, m_tagAttributes, empty))
+                return false;
+            std::string name = localName(m_tagName);
+            if (!startElement(name, handler))
+                return false;
+            if (empty) {
+                if (!endElement(name, handler))
+                    return false;
+            } else
+                m_openElements.push_back(m_tagName);
+        }
+    }
+
+    if (!m_openElements.empty())
+        return fail("Unexpected end of file in element <" + m_openElements.back() + ">");
+    if (m_graphsNb == 0)
+        return fail("No graph found");
+    return true;
+}
+
+bool GraphMLReader::startElement(const std::string& name, Handler& handler)
+{
+    if (name == "node" || name == "edge") {
+        if (!m_inGraph || m_element != NoElement)
+            return fail("Element <" + name + "> out of a graph");
+        const std::string* id = attribute("id");
+        m_elementId = id ? *id : std::string();
+        m_data.clear();
+        if (name == "node") {
+            if (!id)
+                return fail("Node without id");
+            m_element = NodeElement;
+        } else {
+            const std::string* source = attribute("source");
+            const std::string* target = attribute("target");
+            if (!source || !target)
+                return fail("Edge without source or target");
+            const std::string* directed = attribute("directed");
+            m_source = *source;
+            m_target = *target;
+            m_edgeDirection = directed ? *directed == "true" : -1;
+            m_element = EdgeElement;
+        }
+    } else if (name == "data") {
+        const std::string* key = attribute("key");
+        if (!key)
+            return fail("Data without key");
+        m_dataKey = *key;
+        m_text.clear();
+        m_collectText = true;
+    } else if (name == "graph") {
+        if (m_inGraph)
+            return fail("Nested graphs are not supported");
+        const std::string* id = attribute("id");
+        const std::string* edgeDefault = attribute("edgedefault");
+        m_inGraph = true;
+        m_directed = !edgeDefault || *edgeDefault != "undirected";
+        ++m_graphsNb;
+        handler.graph(id ? *id : std::string(), m_directed);
+    } else if (name == "key") {
+        const std::string* id = attribute("id");
+        if (!id)
+            return fail("Key without id");
+        const std::string* keyName = attribute("attr.name");
+        const std::string* domain = attribute("for");
+        Key& key = m_keys[*id];
+        key.name = keyName ? *keyName : *id;
+        key.domain = domain ? *domain : "all";
+        key.defaultValue.clear();
+        key.hasDefault = false;
+        m_currentKey = &key;
+    } else if (name == "default" && m_currentKey) {
+        m_text.clear();
+        m_collectText = true;
+        m_inDefault = true;
+    } else if (name == "hyperedge")
+        return fail("Hyperedges are not supported");
+    return true;
+}
+
+bool GraphMLReader::endElement(const std::string& name, Handler& handler)
+{
+    if (name == "data" && m_collectText) {
+        m_collectText = false;
+        if (m_element != NoElement) {
+            KeySet::const_iterator key = m_keys.find(m_dataKey);
+            m_data[key != m_keys.end() ? key->second.name : m_dataKey] = m_text;
+        }
+    } else if (name == "node" && m_element == NodeElement) {
+        m_element = NoElement;
+        applyDefaults("node");
+        handler.node(m_elementId, m_data);
+    } else if (name == "edge" && m_element == EdgeElement) {
+        m_element = NoElement;
+        applyDefaults("edge");
+        handler.edge(m_source, m_target, m_edgeDirection < 0 ? m_directed : m_edgeDirection == 1, m_data);
+    } else if (name == "graph")
+        m_inGraph = false;
+    else if (name == "default" && m_inDefault) {
+        m_currentKey->defaultValue = m_text;
+        m_currentKey->hasDefault = true;
+        m_collectText = false;
+        m_inDefault = false;
+    } else if (name == "key")
+        m_currentKey = NULL;
+    return true;
+}
+
+void GraphMLReader::applyDefaults(const char* domain)
+{
+    for (KeySet::const_iterator it = m_keys.begin(); it != m_keys.end(); it++)
+        if (it->second.hasDefault && (it->second.domain == domain || it->second.domain == "all"))
+            m_data.insert(Attributes::value_type(it->second.name, it->second.defaultValue));
+}
+
+bool GraphMLReader::fail(const std::string& message)
+{
+    std::ostringstream errorStream;
+    errorStream << "Line " << m_line << ": " << message << ".";
+    m_error = errorStream.str();
+    return false;
+}
@@ -0,0 +1,127 @@
+#ifndef GRAPHMLREADER_H
+#define GRAPHMLREADER_H
+
+#include <cstddef>
+#include <istream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+  * \brief  Streaming reader of GraphML files.
+  *
+  * The file is read in a single pass, and each node and edge is given to a handler as soon as its element ends, with
+  * its data. Nothing else than the current element is kept (and the declared keys), so that the memory used does not
+  * depend on the size of the graph.
+  *
+  * Data are given by the name of their key (attr.name, or the key id when there is no name), the defaults of the keys
+  * being applied. Nested graphs and hyperedges are not supported; ports are ignored.
+  */
+class GraphMLReader {
+public:
+    /**
+      * \brief  Data of a node or an edge, by key name
+      */
+    typedef std::map<std::string, std::string> Attributes;
+
+    /**
+      * \brief  Receiver of the elements of the graph, in the order of the file
+      */
+    class Handler {
+    public:
+        virtual ~Handler() { }
+
+        /**
+          * \brief  Called at the beginning of the graph
+          */
+        virtual void graph(const std::string&, bool) { }
+
+        /**
+          * \brief  Called for each node
+          */
+        virtual void node(const std::string& id, const Attributes& data) = 0;
+
+        /**
+          * \brief  Called for each edge (directed as given by the edge, or else by the graph)
+          */
+        virtual void edge(const std::string& source, const std::string& target, bool directed, const Attributes& data) = 0;
+    };
+
+    /**
+      * \brief  Constructor, on the stream to read
+      */
+    GraphMLReader(std::istream& ist);
+
+    /**
+      * \brief  Reads the whole stream, calling the handler for each node and edge
+      * \return true if the stream is a valid GraphML graph, false else (see error())
+      *
+      * Exceptions thrown by the handler are not caught.
+      */
+    bool read(Handler& handler);
+
+    /**
+      * \brief  Returns the description of the last error met by read(), with its line
+      */
+    const std::string& error() const
+    {
+        return m_error;
+    }
+
+private:
+    struct Key {
+        std::string name;
+        std::string domain;
+        std::string defaultValue;
+        bool hasDefault;
+    };
+    typedef std::map<std::string, Key> KeySet;
+    typedef std::vector<std::pair<std::string, std::string>> TagAttributes;
+
+    enum ElementKind {
+        NoElement,
+        NodeElement,
+        EdgeElement
+    };
+
+    // Lexical analysis
+    int get();
+    bool skipUntil(const char* end, std::string* text = NULL);
+    bool readName(std::string& name);
+    bool readTag(std::string& name, TagAttributes& attributes, bool& empty);
+    bool appendText(std::string& text, int c);
+    const std::string* attribute(const std::string& name) const;
+
+    // Elements handling
+    bool startElement(const std::string& name, Handler& handler);
+    bool endElement(const std::string& name, Handler& handler);
+    void applyDefaults(const char* domain);
+    bool fail(const std::string& message);
+
+    std::streambuf* m_buffer;
+    unsigned long m_line;
+    std::string m_error;
+
+    KeySet m_keys;
+    bool m_directed;
+    bool m_inGraph;
+    unsigned m_graphsNb;
+    ElementKind m_element;
+    std::string m_elementId;
+    std::string m_source;
+    std::string m_target;
+    int m_edgeDirection;
+    Attributes m_data;
+    std::vector<std::string> m_openElements;
+
+    std::string m_tagName;
+    TagAttributes m_tagAttributes;
+    std::string m_text;
+    bool m_collectText;
+    std::string m_dataKey;
+    Key* m_currentKey;
+    bool m_inDefault;
+};
+
+#endif // GRAPHMLREADER_H
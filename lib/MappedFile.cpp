@@ -0,0 +1,48 @@
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& fileName)
+    : m_fileName(fileName)
+    , m_mapping(MAP_FAILED)
+    , m_mappingLength(0)
+{
+    int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Can not open file \"" << fileName << "\" (" << strerror(errno) << ").";
+        throw std::runtime_error(exceptionStream.str());
+    }
+
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0) {
+        close(fileDescriptor);
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": File \"" << fileName << "\" is empty, or its size can not be read.";
+        throw std::runtime_error(exceptionStream.str());
+    }
+
+    m_mappingLength = fileStatus.st_size;
+    m_mapping = mmap(NULL, m_mappingLength, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+    const int mappingError = errno;
+    // The mapping stays valid once the file is closed
+    close(fileDescriptor);
+    if (m_mapping == MAP_FAILED) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Can not map file \"" << fileName << "\" (" << strerror(mappingError) << ").";
+        throw std::runtime_error(exceptionStream.str());
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    munmap(m_mapping, m_mappingLength);
+}
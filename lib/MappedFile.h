@@ -0,0 +1,60 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+  * \brief  Read-only, memory mapped, file.
+  *
+  * The whole file is mapped in memory, not loaded: its pages are read by the system when they are accessed, and are
+  * shared by all the processes mapping the same file. The mapping lasts as long as the object (the file itself is
+  * closed once mapped).
+  */
+class MappedFile {
+public:
+    /**
+      * \brief  Constructor, maps the given file in memory
+      * \throw  std::runtime_error if the file can not be opened or mapped, or is empty
+      */
+    MappedFile(const std::string& fileName);
+
+    /**
+      * \brief  Destructor, unmaps the file
+      */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+      * \brief  Returns the name of the mapped file
+      */
+    const std::string& fileName() const
+    {
+        return m_fileName;
+    }
+
+    /**
+      * \brief  Returns the content of the file (aligned on a page)
+      */
+    const char* data() const
+    {
+        return static_cast<const char*>(m_mapping);
+    }
+
+    /**
+      * \brief  Returns the size of the file, in bytes
+      */
+    size_t size() const
+    {
+        return m_mappingLength;
+    }
+
+private:
+    std::string m_fileName;
+    void* m_mapping;
+    size_t m_mappingLength;
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,166 @@
+#ifndef NEXTHOPTABLE_H
+#define NEXTHOPTABLE_H
+
+#include "ParallelTasks.h"
+#include "PathFinder.h"
+
+#include <atomic>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+/**
+  * \brief  Routing table of a graph snapshot: the next vertex on a shortest path from any vertex to a set of
+  *         destinations (all the vertices by default), found in constant time.
+  *
+  * The table is computed once, by a search from each destination along the arcs in reverse (see PathFinder), so that
+  * particles are forwarded without any search. It holds 4 bytes per vertex and per destination, in one row per
+  * destination.
+  *
+  * The rows are computed in parallel, each thread taking the next destination left (see ParallelTasks): the weight of
+  * the arcs is so called concurrently, and must be thread-safe. The number of threads is the number of hardware threads
+  * when it is 0.
+  */
+template <typename V, typename A>
+class NextHopTable {
+public: // Types and consts
+    typedef CompiledGraph<V, A> Graph;
+    typedef typename Graph::VertexIndex VertexIndex;
+    typedef typename PathFinder<V, A>::ArcWeight ArcWeight;
+
+public: // Methods
+    /**
+      * \brief  Default constructor, builds an empty table
+      */
+    NextHopTable()
+        : m_verticesNb(0)
+        , m_destinationsNb(0)
+        , m_destinationRows()
+        , m_nextHops()
+    {
+    }
+
+    /**
+      * \brief  Constructor, computes the next vertices towards all the vertices of the snapshot
+      * \param  arcWeight   weight of the arcs (the number of arcs if empty)
+      */
+    NextHopTable(const Graph& graph, const ArcWeight& arcWeight = ArcWeight(), unsigned threadsNb = 0)
+        : NextHopTable()
+    {
+        std::vector<VertexIndex> destinations(graph.verticesNb());
+        for (VertexIndex vertex = 0; vertex < destinations.size(); ++vertex)
+            destinations[vertex] = vertex;
+        compute(graph, destinations, arcWeight, threadsNb);
+    }
+
+    /**
+      * \brief  Constructor, computes the next vertices towards the given destinations only
+      * \param  arcWeight   weight of the arcs (the number of arcs if empty)
+      */
+    NextHopTable(const Graph& graph, const std::vector<VertexIndex>& destinations, const ArcWeight& arcWeight = ArcWeight(), unsigned threadsNb = 0)
+        : NextHopTable()
+    {
+        compute(graph, destinations, arcWeight, threadsNb);
+    }
+
+    /**
+      * \brief  Returns the next vertex on a shortest path from vertex to destination, or IllegalVertexIndex if the
+      *         destination is reached, can not be reached, or is not a destination of the table
+      */
+    VertexIndex nextHop(const VertexIndex vertex, const VertexIndex destination) const
+    {
+        if (vertex >= m_verticesNb || destination >= m_verticesNb || m_destinationRows[destination] == IllegalHop)
+            return Graph::IllegalVertexIndex;
+        uint32_t hop = m_nextHops[(unsigned long)m_destinationRows[destination] * m_verticesNb + vertex];
+        return hop == IllegalHop ? Graph::IllegalVertexIndex : hop;
+    }
+
+    /**
+      * \brief  Returns true if the given vertex is a destination of the table
+      */
+    bool isDestination(const VertexIndex destination) const
+    {
+        return destination < m_verticesNb && m_destinationRows[destination] != IllegalHop;
+    }
+
+    unsigned long verticesNb() const
+    {
+        return m_verticesNb;
+    }
+
+    unsigned long destinationsNb() const
+    {
+        return m_destinationsNb;
+    }
+
+    bool isEmpty() const
+    {
+        return m_destinationsNb == 0;
+    }
+
+    /**
+      * \brief  Removes all the destinations
+      */
+    void clear()
+    {
+        NextHopTable emptyTable;
+        std::swap(*this, emptyTable);
+    }
+
+private:
+    static const uint32_t IllegalHop = ~(uint32_t)(0);
+
+    void compute(const Graph& graph, const std::vector<VertexIndex>& destinations, const ArcWeight& arcWeight, unsigned threadsNb);
+
+    unsigned long m_verticesNb;
+    unsigned long m_destinationsNb;
+    std::vector<uint32_t> m_destinationRows;
+    std::vector<uint32_t> m_nextHops;
+};
+
+template <typename V, typename A>
+const uint32_t NextHopTable<V, A>::IllegalHop;
+
+template <typename V, typename A>
+void NextHopTable<V, A>::compute(const Graph& graph, const std::vector<VertexIndex>& destinations, const ArcWeight& arcWeight, unsigned threadsNb)
+{
+    if (graph.verticesNb() >= IllegalHop) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Too many vertices (" << graph.verticesNb() << ") for a next-hop table.";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    m_verticesNb = graph.verticesNb();
+    m_destinationRows.assign(m_verticesNb, IllegalHop);
+    m_destinationsNb = 0;
+    std::vector<VertexIndex> rowDestinations;
+    for (VertexIndex destination : destinations) {
+        if (destination >= m_verticesNb) {
+            std::ostringstream exceptionStream;
+            exceptionStream << __PRETTY_FUNCTION__ << ": Destination index " << destination << " out of the " << m_verticesNb << " vertices.";
+            throw std::invalid_argument(exceptionStream.str());
+        }
+        if (m_destinationRows[destination] == IllegalHop) {
+            m_destinationRows[destination] = m_destinationsNb++;
+            rowDestinations.push_back(destination);
+        }
+    }
+
+    // Each thread fills whole rows, with its own path finder
+    m_nextHops.resize(m_destinationsNb * m_verticesNb);
+    std::atomic<unsigned long> nextRow(0);
+    ParallelTasks::run(std::min<unsigned long>(ParallelTasks::threadsNb(threadsNb), m_destinationsNb), [&](unsigned) {
+        PathFinder<V, A> pathFinder(graph, arcWeight);
+        std::vector<VertexIndex> nextHops;
+        unsigned long row;
+        while ((row = nextRow++) < m_destinationsNb) {
+            pathFinder.nextHops(rowDestinations[row], nextHops);
+            uint32_t* rowHops = m_nextHops.data() + row * m_verticesNb;
+            for (VertexIndex vertex = 0; vertex < m_verticesNb; ++vertex)
+                rowHops[vertex] = nextHops[vertex] == Graph::IllegalVertexIndex ? IllegalHop : (uint32_t)nextHops[vertex];
+        }
+    });
+}
+
+#endif // NEXTHOPTABLE_H
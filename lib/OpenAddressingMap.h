@@ -0,0 +1,331 @@
+#ifndef OPENADDRESSINGMAP_H
+#define OPENADDRESSINGMAP_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/**
+  * \brief  Associative container of unique keys, indexed by a hash table with open addressing (linear probing).
+  *
+  * The elements are stored apart from the table, and never moved: iterators and references stay valid until their
+  * element is erased, even when the table grows. Iteration goes through the elements in their order of first insertion
+  * (erased places being reused). Keys are equal when Equal returns true, and must then have the same hash.
+  *
+  * Only the part of the interface of std::map used by the graphs is provided.
+  */
+template <typename K, typename T, class Hash = std::hash<K>, class Equal = std::equal_to<K>>
+class OpenAddressingMap {
+public: // Types
+    typedef K key_type;
+    typedef T mapped_type;
+    typedef std::pair<K, T> value_type;
+    typedef std::size_t size_type;
+
+private:
+    struct Node {
+        Node(const value_type& nodeValue)
+            : value(nodeValue)
+            , used(true)
+        {
+        }
+        value_type value;
+        bool used;
+    };
+    typedef std::deque<Node> NodeSet;
+
+    // Slots of the table hold the node position + 1, or one of these markers
+    static const size_type EmptySlot = 0;
+    static const size_type ErasedSlot = ~(size_type)(0);
+
+    template <class Value, class Map>
+    class BaseIterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename OpenAddressingMap::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Value* pointer;
+        typedef Value& reference;
+
+        explicit BaseIterator(Map* map = 0, size_type position = 0)
+            : m_map(map)
+            , m_position(position)
+        {
+            skipUnused();
+        }
+
+        // Conversion from iterator to const_iterator
+        template <class OtherValue, class OtherMap>
+        BaseIterator(const BaseIterator<OtherValue, OtherMap>& other)
+            : m_map(other.m_map)
+            , m_position(other.m_position)
+        {
+        }
+
+        reference operator*() const
+        {
+            return m_map->m_nodes[m_position].value;
+        }
+
+        pointer operator->() const
+        {
+            return &m_map->m_nodes[m_position].value;
+        }
+
+        BaseIterator& operator++()
+        {
+            ++m_position;
+            skipUnused();
+            return *this;
+        }
+
+        BaseIterator operator++(int)
+        {
+            BaseIterator previous(*this);
+            ++*this;
+            return previous;
+        }
+
+        template <class OtherValue, class OtherMap>
+        bool operator==(const BaseIterator<OtherValue, OtherMap>& other) const
+        {
+            return m_position == other.m_position;
+        }
+
+        template <class OtherValue, class OtherMap>
+        bool operator!=(const BaseIterator<OtherValue, OtherMap>& other) const
+        {
+            return m_position != other.m_position;
+        }
+
+    private:
+        template <class, class>
+        friend class BaseIterator;
+        friend class OpenAddressingMap;
+
+        void skipUnused()
+        {
+            if (m_map)
+                while (m_position < m_map->m_nodes.size() && !m_map->m_nodes[m_position].used)
+                    ++m_position;
+        }
+
+        Map* m_map;
+        size_type m_position;
+    };
+
+public: // Iterators types
+    typedef BaseIterator<value_type, OpenAddressingMap> iterator;
+    typedef BaseIterator<const value_type, const OpenAddressingMap> const_iterator;
+
+public: // Methods
+    /**
+      * \brief  Default constructor, builds an empty map
+      */
+    OpenAddressingMap()
+        : m_nodes()
+        , m_freeNodes()
+        , m_slots()
+        , m_size(0)
+        , m_usedSlots(0)
+        , m_hash()
+        , m_equal()
+    {
+    }
+
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    iterator end()
+    {
+        return iterator(this, m_nodes.size());
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, m_nodes.size());
+    }
+
+    size_type size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    void clear()
+    {
+        m_nodes.clear();
+        m_freeNodes.clear();
+        m_slots.clear();
+        m_size = 0;
+        m_usedSlots = 0;
+    }
+
+    /**
+      * \brief  Reserves the table for the given number of elements, so that it is not rebuilt while inserting them
+      */
+    void reserve(size_type elementsNb)
+    {
+        if (2 * elementsNb > m_slots.size())
+            rehash(2 * elementsNb);
+    }
+
+    iterator find(const K& key)
+    {
+        return iterator(this, findNode(key));
+    }
+
+    const_iterator find(const K& key) const
+    {
+        return const_iterator(this, findNode(key));
+    }
+
+    size_type count(const K& key) const
+    {
+        return findNode(key) == m_nodes.size() ? 0 : 1;
+    }
+
+    /**
+      * \brief  Inserts the element if its key is not in the map yet
+      * \return The iterator to the element of the key, and true if it was inserted
+      */
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        size_type position = findNode(value.first);
+        if (position != m_nodes.size())
+            return std::pair<iterator, bool>(iterator(this, position), false);
+
+        // The table is kept at most half used (erased slots included)
+        if (2 * (m_usedSlots + 1) > m_slots.size())
+            rehash(2 * (m_size + 1));
+
+        if (m_freeNodes.empty()) {
+            position = m_nodes.size();
+            m_nodes.push_back(Node(value));
+        } else {
+            position = m_freeNodes.back();
+            m_freeNodes.pop_back();
+            m_nodes[position] = Node(value);
+        }
+        size_type slot = firstSlot(value.first, m_slots.size());
+        while (m_slots[slot] != EmptySlot && m_slots[slot] != ErasedSlot)
+            slot = (slot + 1) & (m_slots.size() - 1);
+        if (m_slots[slot] == EmptySlot)
+            ++m_usedSlots;
+        m_slots[slot] = position + 1;
+        ++m_size;
+        return std::pair<iterator, bool>(iterator(this, position), true);
+    }
+
+    /**
+      * \brief  Erases the element at the given position, which must be valid
+      */
+    void erase(const_iterator position)
+    {
+        size_type slot = findSlot(m_nodes[position.m_position].value.first);
+        m_slots[slot] = ErasedSlot;
+        m_nodes[position.m_position].used = false;
+        m_freeNodes.push_back(position.m_position);
+        --m_size;
+    }
+
+    /**
+      * \brief  Erases the element of the given key
+      * \return The number of erased elements (0 or 1)
+      */
+    size_type erase(const K& key)
+    {
+        const_iterator position = find(key);
+        if (position == end())
+            return 0;
+        erase(position);
+        return 1;
+    }
+
+private:
+    /**
+      * \brief  Returns the first slot probed for the key, in a table of slotsNb slots
+      *
+      * The hash is mixed first, as hashes of pointers or of consecutive Ids differ in a few bits only.
+      */
+    size_type firstSlot(const K& key, size_type slotsNb) const
+    {
+        std::size_t hash = m_hash(key) * (std::size_t)(0x9E3779B97F4A7C15ULL);
+        return (hash ^ (hash >> 29)) & (slotsNb - 1);
+    }
+
+    /**
+      * \brief  Returns the slot of the key, or m_slots.size() if the key is not in the map
+      */
+    size_type findSlot(const K& key) const
+    {
+        if (m_slots.empty())
+            return m_slots.size();
+        size_type mask = m_slots.size() - 1;
+        for (size_type slot = firstSlot(key, m_slots.size());; slot = (slot + 1) & mask) {
+            if (m_slots[slot] == EmptySlot)
+                return m_slots.size();
+            if (m_slots[slot] != ErasedSlot && m_equal(m_nodes[m_slots[slot] - 1].value.first, key))
+                return slot;
+        }
+    }
+
+    /**
+      * \brief  Returns the position of the node of the key, or m_nodes.size() if the key is not in the map
+      */
+    size_type findNode(const K& key) const
+    {
+        size_type slot = findSlot(key);
+        return slot == m_slots.size() ? m_nodes.size() : m_slots[slot] - 1;
+    }
+
+    /**
+      * \brief  Rebuilds the table with at least the given number of slots (a power of 2), dropping the erased slots
+      */
+    void rehash(size_type slotsNb)
+    {
+        size_type newSize = 16;
+        while (newSize < slotsNb)
+            newSize *= 2;
+        m_slots.assign(newSize, EmptySlot);
+        for (size_type position = 0; position < m_nodes.size(); ++position) {
+            if (!m_nodes[position].used)
+                continue;
+            size_type slot = firstSlot(m_nodes[position].value.first, newSize);
+            while (m_slots[slot] != EmptySlot)
+                slot = (slot + 1) & (newSize - 1);
+            m_slots[slot] = position + 1;
+        }
+        m_usedSlots = m_size;
+    }
+
+    NodeSet m_nodes;
+    std::vector<size_type> m_freeNodes;
+    std::vector<size_type> m_slots;
+    size_type m_size;
+    size_type m_usedSlots;
+    Hash m_hash;
+    Equal m_equal;
+};
+
+template <typename K, typename T, class Hash, class Equal>
+const typename OpenAddressingMap<K, T, Hash, Equal>::size_type OpenAddressingMap<K, T, Hash, Equal>::EmptySlot;
+
+template <typename K, typename T, class Hash, class Equal>
+const typename OpenAddressingMap<K, T, Hash, Equal>::size_type OpenAddressingMap<K, T, Hash, Equal>::ErasedSlot;
+
+#endif // OPENADDRESSINGMAP_H
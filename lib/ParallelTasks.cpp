@@ -0,0 +1,11 @@
+#include "ParallelTasks.h"
+
+unsigned ParallelTasks::threadsNb(unsigned requestedThreadsNb)
+{
+    if (requestedThreadsNb > 0)
+        return requestedThreadsNb;
+
+    // hardware_concurrency() is 0 when it is not known
+    unsigned hardwareThreadsNb = std::thread::hardware_concurrency();
+    return hardwareThreadsNb > 0 ? hardwareThreadsNb : 1;
+}
@@ -0,0 +1,66 @@
+#ifndef PARALLELTASKS_H
+#define PARALLELTASKS_H
+
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+/**
+  * \brief  Runs the same work on several threads, for the parallel algorithms of the library.
+  *
+  * The work is a function of the index of the thread running it, from 0 to the number of threads - 1, that shares
+  * the job with the others (e.g. by slices of an array, or by taking items from an atomic counter). The calling thread
+  * runs the work of index 0, so that a single thread costs no thread creation. Works must not wait for each other:
+  * when no more threads can be created, the remaining works are run in turn by the calling thread.
+  */
+class ParallelTasks {
+public:
+    /**
+      * \brief  Returns the number of threads to use: the requested one, or the number of hardware threads if 0
+      */
+    static unsigned threadsNb(unsigned requestedThreadsNb = 0);
+
+    /**
+      * \brief  Runs work(threadIndex) on threadsNb threads, and waits for all of them
+      *
+      * If works throw, the first exception caught is thrown again once all the threads are finished.
+      */
+    template <class Work>
+    static void run(unsigned threadsNb, const Work& work);
+};
+
+template <class Work>
+void ParallelTasks::run(unsigned threadsNb, const Work& work)
+{
+    std::exception_ptr exception;
+    std::mutex exceptionMutex;
+    auto guardedWork = [&work, &exception, &exceptionMutex](unsigned threadIndex) {
+        try {
+            work(threadIndex);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(exceptionMutex);
+            if (!exception)
+                exception = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned threadIndex = 1; threadIndex < threadsNb; ++threadIndex) {
+        try {
+            threads.push_back(std::thread(guardedWork, threadIndex));
+        } catch (const std::system_error&) {
+            // No more threads available: the work is run by the calling thread
+            guardedWork(threadIndex);
+        }
+    }
+    guardedWork(0);
+    for (std::thread& thread : threads)
+        thread.join();
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+#endif // PARALLELTASKS_H
@@ -0,0 +1,229 @@
+#ifndef PATHFINDER_H
+#define PATHFINDER_H
+
+#include "CompiledGraph.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+/**
+  * \brief  Finder of shortest paths in a graph snapshot (see CompiledGraph).
+  *
+  * Paths are the shortest in number of arcs (breadth-first search) when no weight is given, and the shortest in total
+  * weight else (Dijkstra's algorithm, or A* when an estimate of the distance to the destination is given). Weights
+  * must not be negative.
+  *
+  * The arrays of the searches are kept from one search to the next, and are not cleared (a search marks the vertices
+  * it reaches with its own stamp): a search only costs the vertices it explores, so that repeated searches in large
+  * graphs are cheap. The snapshot must outlive the finder.
+  */
+template <typename V, typename A>
+class PathFinder {
+public: // Types
+    typedef CompiledGraph<V, A> Graph;
+    typedef typename Graph::VertexIndex VertexIndex;
+    typedef typename Graph::ArcIndex ArcIndex;
+
+    /**
+      * \brief  Weight of an arc, from its data
+      */
+    typedef std::function<double(const A& arc)> ArcWeight;
+
+    /**
+      * \brief  Lower bound of the distance from a vertex to the destination, for A* searches
+      */
+    typedef std::function<double(const VertexIndex vertex)> Heuristic;
+
+public: // Methods
+    /**
+      * \brief  Constructor, on the snapshot to search, and the weight of its arcs (the number of arcs if empty)
+      */
+    PathFinder(const Graph& graph, const ArcWeight& arcWeight = ArcWeight())
+        : m_graph(&graph)
+        , m_arcWeight(arcWeight)
+        , m_distances(graph.verticesNb(), 0)
+        , m_parents(graph.verticesNb(), Graph::IllegalVertexIndex)
+        , m_stamps(graph.verticesNb(), 0)
+        , m_stamp(0)
+        , m_queue()
+        , m_heap()
+    {
+    }
+
+    /**
+      * \brief  Finds a shortest path from source to destination
+      * \param  path        set to the indexes of the vertices of the path, from source to destination (empty if none)
+      * \param  heuristic   lower bound of the distance to the destination (A* search). It must never overestimate the
+      *                     distance; it is not used by searches without weights.
+      * \return true if destination can be reached from source, false else
+      * \throw  std::invalid_argument if a vertex index is out of the graph, or if an arc has a negative weight
+      */
+    bool shortestPath(const VertexIndex source, const VertexIndex destination, std::vector<VertexIndex>& path, const Heuristic& heuristic = Heuristic());
+
+    /**
+      * \brief  Returns the distance from the source of the last search, or infinity if the vertex was not reached.
+      *
+      * Searches stop as soon as their destination is reached: the distance is so only exact for the vertices of the
+      * path found (and for all the vertices after nextHops()).
+      */
+    double distance(const VertexIndex vertex) const
+    {
+        return isReached(vertex) ? m_distances[vertex] : std::numeric_limits<double>::infinity();
+    }
+
+    /**
+      * \brief  Computes, for each vertex, the next vertex on a shortest path from it to the given destination
+      * \param  nextHops    set to the next vertex of each vertex, by index (IllegalVertexIndex for the destination
+      *                     itself, and for the vertices from which it can not be reached)
+      *
+      * All the vertices are found by a single search from the destination, along the arcs in reverse. distance() then
+      * gives the distance from each vertex to the destination.
+      */
+    void nextHops(const VertexIndex destination, std::vector<VertexIndex>& nextHops);
+
+private:
+    struct HeapEntry {
+        double key;
+        double distance;
+        VertexIndex vertex;
+    };
+
+    struct HeapEntryCmp {
+        bool operator()(const HeapEntry& entry1, const HeapEntry& entry2) const
+        {
+            return entry1.key > entry2.key;
+        }
+    };
+
+    /**
+      * \brief  Explores the graph from origin (along the arcs, or in reverse), until target is reached
+      */
+    void search(const VertexIndex origin, const VertexIndex target, bool backward, const Heuristic& heuristic);
+
+    bool isReached(const VertexIndex vertex) const
+    {
+        return m_stamps[vertex] == m_stamp;
+    }
+
+    void reach(const VertexIndex vertex, double distance, const VertexIndex parent)
+    {
+        m_stamps[vertex] = m_stamp;
+        m_distances[vertex] = distance;
+        m_parents[vertex] = parent;
+    }
+
+    void checkIndex(const VertexIndex vertex) const;
+
+    const Graph* m_graph;
+    ArcWeight m_arcWeight;
+    std::vector<double> m_distances;
+    std::vector<VertexIndex> m_parents;
+    std::vector<unsigned> m_stamps;
+    unsigned m_stamp;
+    std::vector<VertexIndex> m_queue;
+    std::vector<HeapEntry> m_heap;
+};
+
+template <typename V, typename A>
+void PathFinder<V, A>::checkIndex(const VertexIndex vertex) const
+{
+    if (vertex >= m_graph->verticesNb()) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Vertex index " << vertex << " out of the " << m_graph->verticesNb() << " vertices.";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+}
+
+template <typename V, typename A>
+void PathFinder<V, A>::search(const VertexIndex origin, const VertexIndex target, bool backward, const Heuristic& heuristic)
+{
+    // A new stamp forgets the previous search, the stamps are only cleared when they wrap around
+    if (++m_stamp == 0) {
+        std::fill(m_stamps.begin(), m_stamps.end(), 0);
+        m_stamp = 1;
+    }
+    reach(origin, 0, Graph::IllegalVertexIndex);
+
+    if (!m_arcWeight) {
+        m_queue.clear();
+        m_queue.push_back(origin);
+        for (unsigned long position = 0; position < m_queue.size(); ++position) {
+            VertexIndex vertex = m_queue[position];
+            if (vertex == target)
+                return;
+            for (VertexIndex neighbour : backward ? m_graph->predecessors(vertex) : m_graph->successors(vertex))
+                if (!isReached(neighbour)) {
+                    reach(neighbour, m_distances[vertex] + 1, vertex);
+                    m_queue.push_back(neighbour);
+                }
+        }
+        return;
+    }
+
+    // Entries are not updated in the heap: the ones of vertices since reached by a shorter path are skipped
+    m_heap.clear();
+    m_heap.push_back(HeapEntry { heuristic ? heuristic(origin) : 0, 0, origin });
+    while (!m_heap.empty()) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), HeapEntryCmp());
+        HeapEntry entry = m_heap.back();
+        m_heap.pop_back();
+        if (entry.distance > m_distances[entry.vertex])
+            continue;
+        if (entry.vertex == target)
+            return;
+
+        typename Graph::IndexRange neighbours = backward ? m_graph->predecessors(entry.vertex) : m_graph->successors(entry.vertex);
+        typename Graph::IndexRange predecessorArcs = backward ? m_graph->predecessorArcs(entry.vertex) : typename Graph::IndexRange();
+        ArcIndex firstArc = m_graph->successorsOffset(entry.vertex);
+        for (unsigned long position = 0; position < neighbours.size(); ++position) {
+            double weight = m_arcWeight(m_graph->arc(backward ? predecessorArcs[position] : firstArc + position));
+            if (weight < 0) {
+                std::ostringstream exceptionStream;
+                exceptionStream << __PRETTY_FUNCTION__ << ": Negative weight " << weight << " of an arc of vertex " << entry.vertex << ".";
+                throw std::invalid_argument(exceptionStream.str());
+            }
+            VertexIndex neighbour = neighbours[position];
+            double distance = entry.distance + weight;
+            if (!isReached(neighbour) || distance < m_distances[neighbour]) {
+                reach(neighbour, distance, entry.vertex);
+                m_heap.push_back(HeapEntry { heuristic ? distance + heuristic(neighbour) : distance, distance, neighbour });
+                std::push_heap(m_heap.begin(), m_heap.end(), HeapEntryCmp());
+            }
+        }
+    }
+}
+
+template <typename V, typename A>
+bool PathFinder<V, A>::shortestPath(const VertexIndex source, const VertexIndex destination, std::vector<VertexIndex>& path, const Heuristic& heuristic)
+{
+    checkIndex(source);
+    checkIndex(destination);
+    path.clear();
+    search(source, destination, false, heuristic);
+    if (!isReached(destination))
+        return false;
+
+    for (VertexIndex vertex = destination; vertex != Graph::IllegalVertexIndex; vertex = m_parents[vertex])
+        path.push_back(vertex);
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+template <typename V, typename A>
+void PathFinder<V, A>::nextHops(const VertexIndex destination, std::vector<VertexIndex>& nextHops)
+{
+    checkIndex(destination);
+    search(destination, Graph::IllegalVertexIndex, true, Heuristic());
+
+    // In the reverse search, the parent of a vertex is its successor towards the destination
+    nextHops.assign(m_graph->verticesNb(), Graph::IllegalVertexIndex);
+    for (VertexIndex vertex = 0; vertex < nextHops.size(); ++vertex)
+        if (isReached(vertex))
+            nextHops[vertex] = m_parents[vertex];
+}
+
+#endif // PATHFINDER_H
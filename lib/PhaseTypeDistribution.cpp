@@ -0,0 +1,117 @@
+#include "PhaseTypeDistribution.h"
+
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+// Solves a x = b by Gaussian elimination with partial pivoting (a is small, and copied)
+std::vector<double> solve(std::vector<std::vector<double>> a, std::vector<double> b)
+{
+    const unsigned n = b.size();
+    for (unsigned col = 0; col < n; ++col) {
+        unsigned pivot = col;
+        for (unsigned row = col + 1; row < n; ++row)
+            if (fabs(a[row][col]) > fabs(a[pivot][col]))
+                pivot = row;
+        std::swap(a[col], a[pivot]);
+        std::swap(b[col], b[pivot]);
+        for (unsigned row = col + 1; row < n; ++row) {
+            double factor = a[row][col] / a[col][col];
+            for (unsigned k = col; k < n; ++k)
+                a[row][k] -= factor * a[col][k];
+            b[row] -= factor * b[col];
+        }
+    }
+
+    std::vector<double> x(n);
+    for (unsigned row = n; row-- > 0;) {
+        double sum = b[row];
+        for (unsigned k = row + 1; k < n; ++k)
+            sum -= a[row][k] * x[k];
+        x[row] = sum / a[row][row];
+    }
+    return x;
+}
+}
+
+PhaseTypeDistribution::PhaseTypeDistribution(const std::vector<double>& initialProbabilities, const std::vector<std::vector<double>>& subGenerator)
+    : m_initialTable()
+    , m_transitionTables()
+    , m_exitRates()
+    , m_mean(0)
+    , m_variance(0)
+{
+    const unsigned n = initialProbabilities.size();
+    if (n == 0 || subGenerator.size() != n) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": " << n << " initial probabilities given for a sub-generator of "
+                        << subGenerator.size() << " rows.";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    // Initial phase, or immediate absorption with the remaining probability
+    std::vector<double> weights(initialProbabilities);
+    double sum = 0;
+    for (double p : initialProbabilities)
+        sum += p;
+    if (sum > 1 + 1e-12) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Initial probabilities sum to " << sum << ", more than 1.";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+    weights.push_back(sum < 1 ? 1 - sum : 0);
+    m_initialTable.setWeights(weights);
+
+    // Next phase, or absorption, when leaving each phase
+    m_transitionTables.resize(n);
+    m_exitRates.resize(n);
+    std::vector<bool> absorbed(n, false); // Absorption reached from the phase
+    for (unsigned i = 0; i < n; ++i) {
+        if (subGenerator[i].size() != n || !(subGenerator[i][i] < 0)) {
+            std::ostringstream exceptionStream;
+            exceptionStream << __PRETTY_FUNCTION__ << ": Row " << i << " of the sub-generator is invalid.";
+            throw std::invalid_argument(exceptionStream.str());
+        }
+        m_exitRates[i] = -subGenerator[i][i];
+        double absorptionRate = m_exitRates[i];
+        for (unsigned j = 0; j < n; ++j) {
+            weights[j] = i == j ? 0 : subGenerator[i][j];
+            absorptionRate -= weights[j];
+        }
+        // Rounding errors may give a slightly negative absorption rate
+        weights[n] = absorptionRate > 1e-12 * m_exitRates[i] ? absorptionRate : 0;
+        absorbed[i] = weights[n] > 0;
+        m_transitionTables[i].setWeights(weights);
+    }
+
+    // Phases from which absorption is reached, found backwards from the absorbing ones: a closed set of phases would
+    // never be left
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (unsigned i = 0; i < n; ++i)
+            for (unsigned j = 0; j < n && !absorbed[i]; ++j)
+                if (i != j && subGenerator[i][j] > 0 && absorbed[j])
+                    absorbed[i] = changed = true;
+    }
+    for (unsigned i = 0; i < n; ++i)
+        if (!absorbed[i]) {
+            std::ostringstream exceptionStream;
+            exceptionStream << __PRETTY_FUNCTION__ << ": Absorption can not be reached from phase " << i << ".";
+            throw std::invalid_argument(exceptionStream.str());
+        }
+
+    // Moments: E[X] = a (-T)^-1 1, E[X^2] = 2 a (-T)^-2 1
+    std::vector<std::vector<double>> minusT(n, std::vector<double>(n));
+    for (unsigned i = 0; i < n; ++i)
+        for (unsigned j = 0; j < n; ++j)
+            minusT[i][j] = -subGenerator[i][j];
+    std::vector<double> firstMoments = solve(minusT, std::vector<double>(n, 1));
+    std::vector<double> secondMoments = solve(minusT, firstMoments);
+    double secondMoment = 0;
+    for (unsigned i = 0; i < n; ++i) {
+        m_mean += initialProbabilities[i] * firstMoments[i];
+        secondMoment += 2 * initialProbabilities[i] * secondMoments[i];
+    }
+    m_variance = secondMoment - m_mean * m_mean;
+}
@@ -0,0 +1,86 @@
+#ifndef PHASETYPEDISTRIBUTION_H
+#define PHASETYPEDISTRIBUTION_H
+
+#include "AliasTable.h"
+
+#include <vector>
+
+/**
+  * \brief  Continuous phase-type distribution: time until absorption of a continuous time Markov chain.
+  *
+  * The distribution is given by the probabilities of the initial phases, and by the sub-generator T of the chain over
+  * its transient phases: T[i][j] (i != j) is the rate of the transitions from phase i to phase j, and -T[i][i] the exit
+  * rate of phase i. The rate of absorption from phase i is the rest of its exit rate, -sum(T[i][j]).
+  * Erlang, hyperexponential and Coxian distributions are particular phase-type distributions.
+  *
+  * The alias tables of the initial phase and of the transitions out of each phase are built once, so that a value is
+  * drawn (see Random::phaseType()) with one exponential value and one alias table draw per visited phase.
+  */
+class PhaseTypeDistribution {
+public:
+    /**
+      * \brief  Constructor
+      * \param  initialProbabilities    Probability of starting in each phase (the rest is the probability of a null value)
+      * \param  subGenerator            Sub-generator of the Markov chain, a square matrix of phasesNb() rows
+      * \throw  std::invalid_argument if the sizes do not match, the initial probabilities sum to more than 1, a row of
+      *         the sub-generator is invalid, or absorption can not be reached from some phase
+      */
+    PhaseTypeDistribution(const std::vector<double>& initialProbabilities, const std::vector<std::vector<double>>& subGenerator);
+
+    /**
+      * \brief  Returns the number of transient phases
+      */
+    unsigned phasesNb() const
+    {
+        return m_exitRates.size();
+    }
+
+    /**
+      * \brief  Returns the table of the initial phase (index phasesNb() stands for immediate absorption)
+      */
+    const AliasTable& initialTable() const
+    {
+        return m_initialTable;
+    }
+
+    /**
+      * \brief  Returns the table of the phase following the given one (index phasesNb() stands for absorption)
+      */
+    const AliasTable& transitionTable(unsigned phase) const
+    {
+        return m_transitionTables[phase];
+    }
+
+    /**
+      * \brief  Returns the exit rate of the given phase
+      */
+    double exitRate(unsigned phase) const
+    {
+        return m_exitRates[phase];
+    }
+
+    /**
+      * \brief  Returns the mean of the distribution
+      */
+    double mean() const
+    {
+        return m_mean;
+    }
+
+    /**
+      * \brief  Returns the variance of the distribution
+      */
+    double variance() const
+    {
+        return m_variance;
+    }
+
+private:
+    AliasTable m_initialTable;
+    std::vector<AliasTable> m_transitionTables;
+    std::vector<double> m_exitRates;
+    double m_mean;
+    double m_variance;
+};
+
+#endif // PHASETYPEDISTRIBUTION_H
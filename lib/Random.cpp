@@ -1,62 +1,209 @@
 #include "Random.h"
+#include "AliasTable.h"
+#include "PhaseTypeDistribution.h"
 
+#include <algorithm>
 #include <cfloat>
 #include <climits>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+// Number of values handled at once by the bulk generation methods (small enough to stay in L1 cache)
+const size_t bulkChunkSize = 256;
+
+// Converts 64 random bits into a real number of [1,2[, by using 52 of them as mantissa of a double.
+// This conversion has no branch nor integer to floating point conversion, so that it is vectorised by the compiler.
+inline double toUniform12(uint64_t randomBits)
+{
+    uint64_t bits = (randomBits >> 12) | 0x3FF0000000000000ULL;
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Layers of the ziggurats (Marsaglia & Tsang, "The Ziggurat Method for Generating Random Variables", 2000).
+// Layer i covers [0, x[i]] x [f(x[i]), f(x[i+1])], with x decreasing from x[1] = r down to x[zigguratLayersNb] = 0.
+// x[0] is the width of a rectangle having the area of the base layer (rectangle [0,r] x [0,f(r)] plus the tail).
+const unsigned zigguratLayersNb = 256;
+
+struct ZigguratTables {
+    double x[zigguratLayersNb + 1];
+    double f[zigguratLayersNb + 1];
+};
+
+// Normal density (without normalisation constant): f(x) = exp(-x^2/2)
+const double normalZigguratR = 3.6541528853610088;
+const double normalZigguratV = 4.92867323399e-3;
+
+// Exponential density: f(x) = exp(-x)
+const double exponentialZigguratR = 7.69711747013104972;
+const double exponentialZigguratV = 3.9496598225815571993e-3;
+
+ZigguratTables buildNormalZiggurat()
+{
+    ZigguratTables tables;
+    tables.x[0] = normalZigguratV / exp(-normalZigguratR * normalZigguratR / 2);
+    tables.x[1] = normalZigguratR;
+    for (unsigned i = 1; i < zigguratLayersNb - 1; ++i)
+        tables.x[i + 1] = sqrt(-2 * log(normalZigguratV / tables.x[i] + exp(-tables.x[i] * tables.x[i] / 2)));
+    tables.x[zigguratLayersNb] = 0;
+    for (unsigned i = 0; i <= zigguratLayersNb; ++i)
+        tables.f[i] = exp(-tables.x[i] * tables.x[i] / 2);
+    return tables;
+}
+
+ZigguratTables buildExponentialZiggurat()
+{
+    ZigguratTables tables;
+    tables.x[0] = exponentialZigguratV / exp(-exponentialZigguratR);
+    tables.x[1] = exponentialZigguratR;
+    for (unsigned i = 1; i < zigguratLayersNb - 1; ++i)
+        tables.x[i + 1] = -log(exponentialZigguratV / tables.x[i] + exp(-tables.x[i]));
+    tables.x[zigguratLayersNb] = 0;
+    for (unsigned i = 0; i <= zigguratLayersNb; ++i)
+        tables.f[i] = exp(-tables.x[i]);
+    return tables;
+}
+
+const ZigguratTables normalZiggurat = buildNormalZiggurat();
+const ZigguratTables exponentialZiggurat = buildExponentialZiggurat();
+
+// Inverse of the standard Normal distribution function, for p in ]0,1[ (Wichura, "Algorithm AS 241: The percentage
+// points of the Normal distribution", 1988), with a relative accuracy of about 1e-16
+double inverseNormal(double p)
+{
+    double q = p - 0.5;
+    if (fabs(q) <= 0.425) {
+        double r = 0.180625 - q * q;
+        return q * (((((((2.5090809287301226727e+3 * r + 3.3430575583588128105e+4) * r + 6.7265770927008700853e+4) * r
+                                + 4.5921953931549871457e+4) * r + 1.3731693765509461125e+4) * r
+                            + 1.9715909503065514427e+3) * r + 1.3314166789178437745e+2) * r
+                       + 3.3871328727963666080e+0)
+            / (((((((5.2264952788528545610e+3 * r + 2.8729085735721942674e+4) * r + 3.9307895800092710610e+4) * r
+                        + 2.1213794301586595867e+4) * r + 5.3941960214247511077e+3) * r
+                    + 6.8718700749205790830e+2) * r + 4.2313330701600911252e+1) * r
+                + 1.0);
+    }
+
+    double r = sqrt(-log(q < 0 ? p : 1 - p)), value;
+    if (r <= 5) {
+        r -= 1.6;
+        value = (((((((7.74545014278341407640e-4 * r + 2.27238449892691845833e-2) * r + 2.41780725177450611770e-1) * r
+                          + 1.27045825245236838258e+0) * r + 3.64784832476320460504e+0) * r
+                      + 5.76949722146069140550e+0) * r + 4.63033784615654529590e+0) * r
+                    + 1.42343711074968357734e+0)
+            / (((((((1.05075007164441684324e-9 * r + 5.47593808499534494600e-4) * r + 1.51986665636164571966e-2) * r
+                        + 1.48103976427480074590e-1) * r + 6.89767334985100004550e-1) * r
+                    + 1.67638483018380384940e+0) * r + 2.05319162663775882187e+0) * r
+                + 1.0);
+    } else {
+        r -= 5;
+        value = (((((((2.01033439929228813265e-7 * r + 2.71155556874348757815e-5) * r + 1.24266094738807843860e-3) * r
+                          + 2.65321895265761230930e-2) * r + 2.96560571828504891230e-1) * r
+                      + 1.78482653991729133580e+0) * r + 5.46378491116411436990e+0) * r
+                    + 6.65790464350110377720e+0)
+            / (((((((2.04426310338993978564e-15 * r + 1.42151175831644588870e-7) * r + 1.84631831751005468180e-5) * r
+                        + 7.86869131145613259100e-4) * r + 1.48753612908506148525e-2) * r
+                    + 1.36929880922735805310e-1) * r + 5.99832206555887937690e-1) * r
+                + 1.0);
+    }
+    return q < 0 ? -value : value;
+}
+
+// Correction term of Stirling's formula, used by the BTPE algorithm
+inline double stirlingCorrection(double x)
+{
+    double x2 = x * x;
+    return (13680. - (462. - (132. - (99. - 140. / x2) / x2) / x2) / x2) / x / 166320.;
+}
+}
 
 Random* Random::generatorInstance = 0;
+thread_local Random* Random::threadGeneratorInstance = 0;
 
 Random* Random::Generate()
+{
+    if (threadGeneratorInstance)
+        return threadGeneratorInstance;
+    return defaultGenerator();
+}
+
+Random* Random::defaultGenerator()
 {
     if (!generatorInstance)
         generatorInstance = new Random();
     return generatorInstance;
 }
 
-Random::Random()
+void Random::setThreadGenerator(Random* generator)
 {
-    base = ~(unsigned long)0 - 1; // oxff..fe
-    seedsNb = (unsigned long)2096;
-    multiplier = (unsigned long)1047570;
-    carry = (unsigned long)123;
+    threadGeneratorInstance = generator;
+}
 
-    carry = (carry & (base + 1)) % multiplier;
-    seeds = new unsigned long[seedsNb];
-    srand(time(NULL));
-    for (unsigned i = 0; i < seedsNb; ++i) {
-        seeds[i] = (unsigned long)rand() & base;
-        if (seeds[i] == (base + 1))
-            seeds[i] = 1;
-    }
+Random::Random()
+    : m_stream((unsigned long long)time(NULL), 0, defaultStreamId)
+    , m_samplingMode(FastSampling)
+    , m_antithetic(false)
+{
+}
 
-    index = 0; // index of first carry
+Random::Random(unsigned long long seed, unsigned replication, unsigned long streamId)
+    : m_stream(seed, replication, streamId)
+    , m_samplingMode(FastSampling)
+    , m_antithetic(false)
+{
 }
 
 Random::~Random()
 {
-    delete[] seeds;
 }
 
-unsigned long Random::getRand()
+void Random::setSeed(unsigned long long seed)
+{
+    m_stream.setKey(seed, m_stream.replication(), m_stream.streamId());
+}
+
+void Random::setReplication(unsigned replication)
+{
+    m_stream.setKey(m_stream.seed(), replication, m_stream.streamId());
+}
+
+Random Random::substream(const std::string& name) const
+{
+    Random generator(m_stream.seed(), m_stream.replication(), substreamId(name, m_stream.streamId()));
+    generator.setSamplingMode(m_samplingMode);
+    generator.setAntithetic(m_antithetic);
+    return generator;
+}
+
+unsigned long Random::substreamId(const std::string& name, unsigned long streamId)
 {
-    // t    = a * x_n-r +c_n-1
-    // x_n  = (b-1) - t
-    // c_n  = t/b
-    unsigned long long t = multiplier * (unsigned long long)seeds[index] + carry;
-    carry = t / (unsigned long long)base;
-    seeds[index] = (base - 1) - (t & (base | 1));
-    unsigned long result = seeds[index];
-    index = (index + 1) & (seedsNb - 1);
-    return (result);
+    // FNV-1a hash of the stream identifier and of the name
+    uint32_t hash = 2166136261u;
+    for (unsigned i = 0; i < 4; ++i) {
+        hash ^= (uint32_t)(streamId >> (8 * i)) & 0xff;
+        hash *= 16777619u;
+    }
+    for (char c : name) {
+        hash ^= (unsigned char)c;
+        hash *= 16777619u;
+    }
+
+    // Substreams use the upper half of the identifiers, modules Ids stay in the lower one
+    unsigned long id = 0x80000000ul | (hash & 0x7ffffffful);
+    return id == defaultStreamId ? defaultStreamId - 1 : id;
 }
 
 long double Random::uniform(long double a, long double b)
 {
-    long double uniform_0_1 = (long double)getRand() / (long double)(~(unsigned long)0);
+    long double uniform_0_1 = (long double)getRand() / (long double)(~(unsigned long long)0);
     if (uniform_0_1 == 1)
-        uniform_0_1 = (long double)getRand() / (long double)(~(unsigned long)0);
+        uniform_0_1 = (long double)getRand() / (long double)(~(unsigned long long)0);
     return uniform_0_1 * (b - a) + a;
 }
 
@@ -65,13 +212,130 @@ long Random::intuniform(long a, long b)
     return (getRand() % (b - a + 1) + a);
 }
 
+unsigned Random::discrete(const AliasTable& table)
+{
+    if (table.isEmpty()) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Drawing an index from an empty alias table.";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    unsigned long long bits = getRand();
+    unsigned column = (unsigned)(((bits >> 32) * table.size()) >> 32);
+    double u = (bits & 0xffffffff) * (1.0 / 4294967296.0);
+    return u < table.threshold(column) ? column : table.alias(column);
+}
+
 long double Random::exponential(long double lambda)
 {
+    if (m_samplingMode == FastSampling)
+        return standardExponential() / lambda;
+    if (m_samplingMode == InversionSampling)
+        return -log(1 - getOpenUniform()) / lambda;
+
     return -log(uniform(0, 1)) / lambda;
 }
 
+double Random::standardExponential()
+{
+    while (1) {
+        uint64_t randomBits = getRand();
+        unsigned layer = randomBits & (zigguratLayersNb - 1);
+        double x = (toUniform12(randomBits) - 1) * exponentialZiggurat.x[layer];
+
+        // Inside the rectangular part of the layer (most of the cases)
+        if (x < exponentialZiggurat.x[layer + 1])
+            return x;
+
+        // In the tail, which is an exponential distribution shifted by r
+        if (layer == 0)
+            return exponentialZigguratR - log(2 - toUniform12(getRand()));
+
+        // In the wedge between the rectangular part and the density
+        double y = exponentialZiggurat.f[layer + 1]
+            + (exponentialZiggurat.f[layer] - exponentialZiggurat.f[layer + 1]) * (toUniform12(getRand()) - 1);
+        if (y < exp(-x))
+            return x;
+    }
+}
+
+double Random::standardNormal()
+{
+    while (1) {
+        uint64_t randomBits = getRand();
+        unsigned layer = randomBits & (zigguratLayersNb - 1);
+        // Uniform value of [-1,1[, from bits which do not overlap the layer bits
+        double u = 2 * toUniform12(randomBits) - 3;
+        double x = u * normalZiggurat.x[layer];
+
+        // Inside the rectangular part of the layer (most of the cases)
+        if (fabs(x) < normalZiggurat.x[layer + 1])
+            return x;
+
+        // In the tail, sampled with Marsaglia's method
+        if (layer == 0) {
+            double tailX, tailY;
+            do {
+                tailX = -log(2 - toUniform12(getRand())) / normalZigguratR;
+                tailY = -log(2 - toUniform12(getRand()));
+            } while (2 * tailY < tailX * tailX);
+            return u < 0 ? -(normalZigguratR + tailX) : normalZigguratR + tailX;
+        }
+
+        // In the wedge between the rectangular part and the density
+        double y = normalZiggurat.f[layer + 1]
+            + (normalZiggurat.f[layer] - normalZiggurat.f[layer + 1]) * (toUniform12(getRand()) - 1);
+        if (y < exp(-x * x / 2))
+            return x;
+    }
+}
+
+double Random::getUniform()
+{
+    return toUniform12(getRand()) - 1;
+}
+
+double Random::getOpenUniform()
+{
+    // Middle of one of 2^53 intervals: the complement of the random number gives exactly 1-u
+    return ((getRand() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+void Random::getRands(uint64_t* out, size_t n)
+{
+    m_stream.generate(out, n);
+    if (m_antithetic)
+        for (size_t i = 0; i < n; ++i)
+            out[i] = ~out[i];
+}
+
 unsigned Random::poisson(long double lambda)
 {
+    if (m_samplingMode == FastSampling) {
+        if (lambda >= poissonPTRSThreshold)
+            return poissonPTRS(lambda);
+
+        double l = exp(-(double)lambda), p = getUniform();
+        unsigned k = 0;
+        while (p > l) {
+            ++k;
+            p *= getUniform();
+        }
+        return k;
+    }
+
+    if (m_samplingMode == InversionSampling && lambda < inversionThreshold) {
+        // Sequential search of the distribution function
+        double u = getOpenUniform(), px = exp(-(double)lambda), cdf = px;
+        unsigned k = 0;
+        while (u > cdf && px > 0) {
+            ++k;
+            px *= lambda / k;
+            cdf += px;
+        }
+        return k;
+    }
+
     long double l = exp(-lambda), p = uniform(0, 1);
     unsigned k = 0;
     while (p > l) {
@@ -86,16 +350,232 @@ unsigned Random::bernoulli(long double p)
     return (uniform(0, 1) < p ? 1 : 0);
 }
 
+Random::PoissonPTRSConstants::PoissonPTRSConstants()
+    : lambda(0)
+    , logLambda(0)
+    , b(0)
+    , a(0)
+    , logInvAlpha(0)
+    , vr(0)
+{
+}
+
+Random::PoissonPTRSConstants::PoissonPTRSConstants(double lambda)
+    : lambda(lambda)
+    , logLambda(log(lambda))
+    , b(0.931 + 2.53 * sqrt(lambda))
+    , a(-0.059 + 0.02483 * b)
+    , logInvAlpha(log(1.1239 + 1.1328 / (b - 3.4)))
+    , vr(0.9277 - 3.6224 / (b - 2))
+{
+}
+
+unsigned Random::poissonPTRS(double lambda)
+{
+    return poissonPTRS(PoissonPTRSConstants(lambda));
+}
+
+unsigned Random::poissonPTRS(const PoissonPTRSConstants& constants)
+{
+    // Transformed rejection with squeeze (Hoermann, "The transformed rejection method for generating Poisson random
+    // variables", 1993)
+    const double lambda = constants.lambda, a = constants.a, b = constants.b, vr = constants.vr;
+    while (1) {
+        double u = getUniform() - 0.5;
+        double v = getUniform();
+        double us = 0.5 - fabs(u);
+        if (us == 0)
+            continue;
+        long k = (long)floor((2 * a / us + b) * u + lambda + 0.43);
+
+        // Immediate acceptance
+        if (us >= 0.07 && v <= vr)
+            return k;
+
+        if (k < 0 || (us < 0.013 && v > us))
+            continue;
+
+        if (log(v) + constants.logInvAlpha - log(a / (us * us) + b) <= -lambda + k * constants.logLambda - lgamma(k + 1.0))
+            return k;
+    }
+}
+
 unsigned Random::binomial(unsigned n, long double p)
 {
+    if (m_samplingMode == FastSampling || m_samplingMode == InversionSampling) {
+        if (p <= 0)
+            return 0;
+        if (p >= 1)
+            return n;
+
+        // Both algorithms work with the smallest of p and 1-p
+        double r = p <= 0.5 ? p : 1 - p;
+        double inversionLimit = m_samplingMode == InversionSampling ? inversionThreshold : binomialBTPEThreshold;
+        unsigned v = n * r <= inversionLimit ? binomialInversion(n, r) : binomialBTPE(n, r);
+        return p <= 0.5 ? v : n - v;
+    }
+
     unsigned v = 0;
     for (unsigned i = 0; i < n; ++i)
         v += bernoulli(p);
     return v;
 }
 
+unsigned Random::binomialInversion(unsigned n, double p)
+{
+    double q = 1 - p;
+    double qn = exp(n * log(q));
+    double np = n * p;
+    double bound = std::min((double)n, np + 10 * sqrt(np * q + 1));
+
+    unsigned x = 0;
+    double px = qn, u = getUniform();
+    while (u > px) {
+        ++x;
+        if (x > bound) {
+            // Too far in the tail (rounding errors): start again
+            x = 0;
+            px = qn;
+            u = getUniform();
+        } else {
+            u -= px;
+            px = ((n - x + 1) * p * px) / (x * q);
+        }
+    }
+    return x;
+}
+
+Random::BinomialBTPEConstants::BinomialBTPEConstants()
+    : n(0)
+    , p(0)
+    , q(1)
+    , nrq(0)
+    , m(0)
+    , p1(0)
+    , xm(0)
+    , xl(0)
+    , xr(0)
+    , c(0)
+    , lambdaL(0)
+    , lambdaR(0)
+    , p2(0)
+    , p3(0)
+    , p4(0)
+{
+}
+
+Random::BinomialBTPEConstants::BinomialBTPEConstants(unsigned n, double p)
+    : n(n)
+    , p(p)
+    , q(1 - p)
+    , nrq(n * p * q)
+    , m((long)floor(n * p + p))
+    , p1(floor(2.195 * sqrt(nrq) - 4.6 * q) + 0.5)
+    , xm(m + 0.5)
+    , xl(xm - p1)
+    , xr(xm + p1)
+    , c(0.134 + 20.5 / (15.3 + m))
+{
+    double fm = n * p + p;
+    double a = (fm - xl) / (fm - xl * p);
+    lambdaL = a * (1 + a / 2);
+    a = (xr - fm) / (xr * q);
+    lambdaR = a * (1 + a / 2);
+    p2 = p1 * (1 + 2 * c);
+    p3 = p2 + c / lambdaL;
+    p4 = p3 + c / lambdaR;
+}
+
+unsigned Random::binomialBTPE(unsigned n, double p)
+{
+    return binomialBTPE(BinomialBTPEConstants(n, p));
+}
+
+unsigned Random::binomialBTPE(const BinomialBTPEConstants& constants)
+{
+    // Triangle, parallelogram, exponential tails algorithm (Kachitvichyanukul & Schmeiser, "Binomial random variate
+    // generation", 1988). p must not be greater than 0.5.
+    const unsigned n = constants.n;
+    const double p = constants.p, q = constants.q, nrq = constants.nrq;
+    const long m = constants.m;
+    const double p1 = constants.p1, xm = constants.xm, xl = constants.xl, xr = constants.xr, c = constants.c;
+    const double lambdaL = constants.lambdaL, lambdaR = constants.lambdaR;
+    const double p2 = constants.p2, p3 = constants.p3, p4 = constants.p4;
+
+    while (1) {
+        double u = getUniform() * p4;
+        double v = getUniform();
+        long y;
+
+        if (u <= p1) {
+            // Triangular region: immediate acceptance
+            return (unsigned)floor(xm - p1 * v + u);
+        } else if (u <= p2) {
+            // Parallelograms
+            double x = xl + (u - p1) / c;
+            v = v * c + 1 - fabs(m - x + 0.5) / p1;
+            if (v > 1)
+                continue;
+            y = (long)floor(x);
+        } else if (u <= p3) {
+            // Left exponential tail
+            if (v == 0)
+                continue;
+            y = (long)floor(xl + log(v) / lambdaL);
+            if (y < 0)
+                continue;
+            v = v * (u - p2) * lambdaL;
+        } else {
+            // Right exponential tail
+            if (v == 0)
+                continue;
+            y = (long)floor(xr - log(v) / lambdaR);
+            if (y > (long)n)
+                continue;
+            v = v * (u - p3) * lambdaR;
+        }
+
+        long k = labs(y - m);
+        if (k <= 20 || k >= nrq / 2 - 1) {
+            // Explicit evaluation of f(y) / f(m)
+            double s = p / q, aa = s * (n + 1), f = 1;
+            if (m < y) {
+                for (long i = m + 1; i <= y; ++i)
+                    f *= (aa / i - s);
+            } else if (m > y) {
+                for (long i = y + 1; i <= m; ++i)
+                    f /= (aa / i - s);
+            }
+            if (v > f)
+                continue;
+            return (unsigned)y;
+        }
+
+        // Squeezing, with lower and upper bounds of log(f(y) / f(m))
+        double rho = (k / nrq) * ((k * (k / 3.0 + 0.625) + 0.16666666666666666) / nrq + 0.5);
+        double t = -(double)(k * k) / (2 * nrq);
+        double logV = log(v);
+        if (logV < t - rho)
+            return (unsigned)y;
+        if (logV > t + rho)
+            continue;
+
+        // Final acceptance test, using Stirling's formula
+        double x1 = y + 1, f1 = m + 1, z = n + 1 - m, w = n - y + 1;
+        if (logV > xm * log(f1 / x1) + (n - m + 0.5) * log(z / w) + (y - m) * log(w * p / (x1 * q))
+                + stirlingCorrection(f1) + stirlingCorrection(z) + stirlingCorrection(x1) + stirlingCorrection(w))
+            continue;
+        return (unsigned)y;
+    }
+}
+
 long double Random::normal(long double mean, long double stddev)
 {
+    if (m_samplingMode == FastSampling)
+        return mean + stddev * standardNormal();
+    if (m_samplingMode == InversionSampling)
+        return mean + stddev * inverseNormal(getOpenUniform());
+
     long double z = cos(2 * M_PI * uniform(0, 1)) * sqrt(-2 * log(uniform(0, 1)));
     return mean + stddev * z;
 }
@@ -104,6 +584,208 @@ long double Random::lognormal(long double mean, long double stddev)
 {
     long double mean_log = log(mean) - log(1 + (stddev * stddev) / (mean * mean)) / 2;
     long double stddev_log = sqrt(log(1 + (stddev * stddev) / (mean * mean)));
+    if (m_samplingMode == FastSampling)
+        return exp(mean_log + stddev_log * standardNormal());
+    if (m_samplingMode == InversionSampling)
+        return exp(mean_log + stddev_log * inverseNormal(getOpenUniform()));
+
     long double r1 = sqrt(-2 * log(uniform(0, 1))) * sin(2 * M_PI * uniform(0, 1));
     return exp(mean_log + stddev_log * r1);
 }
+
+double Random::standardGamma(double d, double c)
+{
+    // Marsaglia & Tsang, "A simple method for generating gamma variables", 2000
+    while (1) {
+        double x, v;
+        do {
+            x = standardNormal();
+            v = 1 + c * x;
+        } while (v <= 0);
+        v = v * v * v;
+        double u = getOpenUniform();
+
+        // Squeeze, then exact test
+        double x2 = x * x;
+        if (u < 1 - 0.0331 * x2 * x2)
+            return d * v;
+        if (log(u) < 0.5 * x2 + d * (1 - v + log(v)))
+            return d * v;
+    }
+}
+
+long double Random::gamma(long double shape, long double scale)
+{
+    // Shapes below 1 are boosted: Gamma(k) = Gamma(k+1) * U^(1/k)
+    if (shape < 1)
+        return gamma(shape + 1, scale) * pow(getOpenUniform(), 1 / (double)shape);
+
+    double d = shape - 1. / 3;
+    return scale * standardGamma(d, 1 / sqrt(9 * d));
+}
+
+long double Random::weibull(long double shape, long double scale)
+{
+    return scale * pow((double)exponential(1), 1 / (double)shape);
+}
+
+long double Random::pareto(long double shape, long double scale)
+{
+    return scale * exp((double)exponential(1) / shape);
+}
+
+long double Random::erlang(unsigned k, long double lambda)
+{
+    if (k >= erlangGammaThreshold) {
+        double d = k - 1. / 3;
+        return standardGamma(d, 1 / sqrt(9 * d)) / lambda;
+    }
+
+    double product = 1;
+    for (unsigned i = 0; i < k; ++i)
+        product *= getOpenUniform();
+    return -log(product) / lambda;
+}
+
+long double Random::hyperexponential(const AliasTable& branches, const std::vector<double>& rates)
+{
+    return exponential(rates.at(discrete(branches)));
+}
+
+long double Random::phaseType(const PhaseTypeDistribution& distribution)
+{
+    double value = 0;
+    unsigned phase = discrete(distribution.initialTable());
+    while (phase < distribution.phasesNb()) {
+        value += standardExponential() / distribution.exitRate(phase);
+        phase = discrete(distribution.transitionTable(phase));
+    }
+    return value;
+}
+
+void Random::uniform(double* out, size_t n, double a, double b)
+{
+    uint64_t randomBits[bulkChunkSize];
+    const double width = b - a;
+    for (size_t done = 0; done < n; done += bulkChunkSize) {
+        size_t chunkSize = n - done < bulkChunkSize ? n - done : bulkChunkSize;
+        getRands(randomBits, chunkSize);
+        double* chunk = out + done;
+        for (size_t i = 0; i < chunkSize; ++i)
+            chunk[i] = (toUniform12(randomBits[i]) - 1) * width + a;
+    }
+}
+
+void Random::exponential(double* out, size_t n, double lambda)
+{
+    uint64_t randomBits[bulkChunkSize];
+    const double mean = 1 / lambda;
+    if (m_samplingMode == FastSampling) {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = standardExponential() * mean;
+        return;
+    }
+
+    for (size_t done = 0; done < n; done += bulkChunkSize) {
+        size_t chunkSize = n - done < bulkChunkSize ? n - done : bulkChunkSize;
+        getRands(randomBits, chunkSize);
+        double* chunk = out + done;
+        // 2 - [1,2[ gives ]0,1], which is safe for log
+        for (size_t i = 0; i < chunkSize; ++i)
+            chunk[i] = 2 - toUniform12(randomBits[i]);
+        for (size_t i = 0; i < chunkSize; ++i)
+            chunk[i] = -std::log(chunk[i]) * mean;
+    }
+}
+
+void Random::normal(double* out, size_t n, double mean, double stddev)
+{
+    uint64_t randomBits[bulkChunkSize];
+    double radius[bulkChunkSize / 2], angle[bulkChunkSize / 2];
+    if (m_samplingMode == FastSampling) {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = mean + stddev * standardNormal();
+        return;
+    }
+    if (m_samplingMode == InversionSampling) {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = mean + stddev * inverseNormal(getOpenUniform());
+        return;
+    }
+
+    for (size_t done = 0; done < n; done += bulkChunkSize) {
+        size_t chunkSize = n - done < bulkChunkSize ? n - done : bulkChunkSize;
+        size_t pairsNb = (chunkSize + 1) / 2;
+        getRands(randomBits, 2 * pairsNb);
+        for (size_t i = 0; i < pairsNb; ++i) {
+            radius[i] = 2 - toUniform12(randomBits[2 * i]);
+            angle[i] = 2 * M_PI * (toUniform12(randomBits[2 * i + 1]) - 1);
+        }
+        for (size_t i = 0; i < pairsNb; ++i)
+            radius[i] = stddev * std::sqrt(-2 * std::log(radius[i]));
+
+        double* chunk = out + done;
+        for (size_t i = 0; i < chunkSize / 2; ++i) {
+            chunk[2 * i] = mean + radius[i] * std::cos(angle[i]);
+            chunk[2 * i + 1] = mean + radius[i] * std::sin(angle[i]);
+        }
+        if (chunkSize & 1)
+            chunk[chunkSize - 1] = mean + radius[pairsNb - 1] * std::cos(angle[pairsNb - 1]);
+    }
+}
+
+void Random::lognormal(double* out, size_t n, double mean, double stddev)
+{
+    double meanLog = std::log(mean) - std::log(1 + (stddev * stddev) / (mean * mean)) / 2;
+    double stddevLog = std::sqrt(std::log(1 + (stddev * stddev) / (mean * mean)));
+    normal(out, n, meanLog, stddevLog);
+    for (size_t i = 0; i < n; ++i)
+        out[i] = std::exp(out[i]);
+}
+
+void Random::gamma(double* out, size_t n, double shape, double scale)
+{
+    if (shape < 1) {
+        gamma(out, n, shape + 1, scale);
+        const double invShape = 1 / shape;
+        for (size_t i = 0; i < n; ++i)
+            out[i] *= std::pow(getOpenUniform(), invShape);
+        return;
+    }
+
+    const double d = shape - 1. / 3, c = 1 / std::sqrt(9 * d);
+    for (size_t i = 0; i < n; ++i)
+        out[i] = scale * standardGamma(d, c);
+}
+
+void Random::weibull(double* out, size_t n, double shape, double scale)
+{
+    const double invShape = 1 / shape;
+    exponential(out, n, 1);
+    for (size_t i = 0; i < n; ++i)
+        out[i] = scale * std::pow(out[i], invShape);
+}
+
+void Random::pareto(double* out, size_t n, double shape, double scale)
+{
+    const double invShape = 1 / shape;
+    exponential(out, n, 1);
+    for (size_t i = 0; i < n; ++i)
+        out[i] = scale * std::exp(out[i] * invShape);
+}
+
+void Random::erlang(double* out, size_t n, unsigned k, double lambda)
+{
+    if (k >= erlangGammaThreshold) {
+        gamma(out, n, k, 1 / lambda);
+        return;
+    }
+
+    const double mean = 1 / lambda;
+    for (size_t i = 0; i < n; ++i) {
+        double product = 1;
+        for (unsigned j = 0; j < k; ++j)
+            product *= getOpenUniform();
+        out[i] = -std::log(product) * mean;
+    }
+}
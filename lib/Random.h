@@ -1,36 +1,185 @@
 #ifndef RANDOM_H
 #define RANDOM_H
 
+#include "RandomStream.h"
+
+class AliasTable;
+class PhaseTypeDistribution;
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
 /**
-  * \brief  A singleton class providing randomly generated number.
+  * \brief  A class providing randomly generated number.
   *
-  * Invocation of random numbers generations is done with:
+  * Invocation of random numbers generations from the default, process wide, generator is done with:
   *     x = Random::Generate()->Distribution_Name( Distribution_Params );
   * where, Distribution_Name can be one of the following discrete distributions
   * -   bernoulli, to produce values of a Bernoulli distribution (1 with probability p, 0 with probability 1-p)
   * -   intuniform, to produce uniformly distributed integer values in an interval
   * -   binomial, to produce values of a binomial distribution with the given parameters
   * -   poisson, to produce values of a Poisson distribution with the given parameter
+  * -   discrete, to produce indexes of an arbitrary discrete distribution, given by its AliasTable
   * or, one the following continuous distributions
   * -   uniform, to produce uniformly distributed real values in an interval
   * -   exponential, to produce values of an Exponential distribution with the given parameter
   * -   normal, to produce values of a Normal (Gaussian) distribution with the given mean and standard deviation
   * -   lognormal, to produce values of a Log-Normal distribution with the given mean and standard deviation
+  * -   gamma, weibull and pareto, to produce values of these distributions with the given shape and scale
+  * -   erlang, to produce values of an Erlang distribution (sum of k exponential values) in a time independent of k
+  * -   hyperexponential and phaseType, to produce values of phase-type distributions
+  *
+  * The continuous distributions with scalar parameters can also fill whole buffers at once, in double precision:
+  *     Random::Generate()->Distribution_Name( Buffer, Values_Number, Distribution_Params );
+  * which is much faster than drawing the values one by one, when large numbers of values are needed.
+  *
+  * Other generators can be built on their own stream (see RandomStream), identified by a seed, a replication index and
+  * a stream identifier. Every SimulationModule owns such a generator (see SimulationModule::randomGenerator()).
+  * The default generator is seeded with the current time. To reproduce a run, set its seed before simulating:
+  *     Random::Generate()->setSeed(20110726);
+  * Named substreams (see substream()) give independent, reproducible, streams for specific uses.
+  *
+  * Two variance reduction techniques are supported:
+  * -   common random numbers: alternative configurations of a model are compared on the same random numbers, when each
+  *     model input draws from its own named substream (see SimulationModule::inputGenerator()),
+  * -   antithetic variates: an antithetic generator (see setAntithetic()) draws the complements of the values of the
+  *     same generator, e.g. 1-u instead of u for uniform values (see DESimulator::setAntitheticReplications()).
+  * Both work best with InversionSampling, where each sample is a monotone function of a single random value.
   */
 class Random {
 public:
+    /**
+      * \brief  Algorithms used to produce values of Exponential, Normal and Log-Normal distributions
+      */
+    enum SamplingMode {
+        FastSampling, ///< Ziggurat method, in double precision (default)
+        ReferenceSampling, ///< Inversion for Exponential, Box-Muller for Normal and Log-Normal
+        InversionSampling ///< Inversion of the distribution function, one random value per sample (for variance reduction)
+    };
+
     /**
       * \brief  Static, public, method to use when requesting random values from a random variable distribution
       */
     static Random* Generate();
 
     /**
-      * \brief  Destructor
+      * \brief  Returns the default generator, whatever the generator of the calling thread (see setThreadGenerator())
+      */
+    static Random* defaultGenerator();
+
+    /**
+      * \brief  Sets the generator returned by Generate() to the calling thread only, instead of the default generator
+      *         (the default generator again if NULL)
       *
-      * This destructor is implicitly called by
+      * The default generator is not thread-safe: threads drawing values concurrently (see DESimulator) must each have
+      * their own generator. The generator is not owned, and must outlive its use.
+      */
+    static void setThreadGenerator(Random* generator);
+
+    /**
+      * \brief  Constructor of a generator drawing its values from its own stream
+      * \param  seed        Seed shared by all the streams of a simulation
+      * \param  replication Index of the replication using the generator
+      * \param  streamId    Identifier of the stream inside the replication (e.g. the Id of the module using it)
+      */
+    Random(unsigned long long seed, unsigned replication = 0, unsigned long streamId = 0);
+
+    /**
+      * \brief  Destructor
       */
     ~Random();
 
+    /**
+      * \brief  Returns the stream used by the generator, to get its key or move it
+      */
+    RandomStream& stream()
+    {
+        return m_stream;
+    }
+
+    /**
+      * \brief  Returns the stream used by the generator
+      */
+    const RandomStream& stream() const
+    {
+        return m_stream;
+    }
+
+    /**
+      * \brief  Returns the seed of the generator's stream
+      */
+    unsigned long long seed() const
+    {
+        return m_stream.seed();
+    }
+
+    /**
+      * \brief  Returns the replication index of the generator's stream
+      */
+    unsigned replication() const
+    {
+        return m_stream.replication();
+    }
+
+    /**
+      * \brief  Changes the seed of the generator, and moves its stream back to its first value
+      *
+      * The seed of the default generator is shared by all the streams of the simulation (see SimulationModule).
+      */
+    void setSeed(unsigned long long seed);
+
+    /**
+      * \brief  Changes the replication index of the generator, and moves its stream back to its first value
+      */
+    void setReplication(unsigned replication);
+
+    /**
+      * \brief  Returns true if the generator draws the complements of the values of its stream
+      */
+    bool isAntithetic() const
+    {
+        return m_antithetic;
+    }
+
+    /**
+      * \brief  Sets whether the generator draws the complements of the values of its stream (antithetic variates)
+      */
+    void setAntithetic(bool antithetic)
+    {
+        m_antithetic = antithetic;
+    }
+
+    /**
+      * \brief  Returns a generator drawing from the substream of the given name
+      *
+      * The substream has the seed and replication index of the current generator, and a stream identifier derived from
+      * the name and from the current stream identifier. It never overlaps the streams of the modules, nor the stream of
+      * the default generator.
+      */
+    Random substream(const std::string& name) const;
+
+    /**
+      * \brief  Returns the stream identifier of the substream of the given name, of the given stream
+      */
+    static unsigned long substreamId(const std::string& name, unsigned long streamId);
+
+    /**
+      * \brief  Returns the algorithms used by the generator
+      */
+    SamplingMode samplingMode() const
+    {
+        return m_samplingMode;
+    }
+
+    /**
+      * \brief  Sets the algorithms used by the generator
+      */
+    void setSamplingMode(SamplingMode mode)
+    {
+        m_samplingMode = mode;
+    }
+
     // Discrete Distributions
     /**
       * \brief  Produces a random integer number in interval [a,b]
@@ -44,14 +193,31 @@ public:
 
     /**
       * \brief  Produces a random value of distribution Binomial(n, p). It produces the sum of n independent Bernoulli(p) trials
+      *
+      * With FastSampling, the value is obtained by inversion when n*min(p,1-p) is small, and with the BTPE algorithm
+      * (Kachitvichyanukul & Schmeiser) else, in a time independent of n. With InversionSampling, inversion is used as
+      * long as (1-min(p,1-p))^n does not underflow.
       */
     unsigned binomial(unsigned n, long double p);
 
     /**
       * \brief  Produces a random value of Poisson distribution with parameter lambda
+      *
+      * With FastSampling, the value is obtained by multiplication of uniform values when lambda is small, and with the
+      * PTRS algorithm (Hoermann) else, in a time independent of lambda. With InversionSampling, the value is obtained by
+      * sequential search of the distribution function, in a time proportional to lambda, as long as exp(-lambda) does
+      * not underflow.
       */
     unsigned poisson(long double lambda);
 
+    /**
+      * \brief  Produces a random index of the discrete distribution given by the alias table, in constant time
+      *
+      * A single 64 bits value is drawn: its 32 high bits choose the column of the table, and its 32 low bits are
+      * compared to the threshold of the column.
+      */
+    unsigned discrete(const AliasTable& table);
+
     // Continuous Distributions
     /**
       * \brief  Produces a random real number in interval [a,b[
@@ -77,27 +243,191 @@ public:
       */
     long double lognormal(long double mean, long double stddev);
 
+    /**
+      * \brief  Produces a random value of Gamma distribution, with the method of Marsaglia and Tsang
+      * \param  shape   Shape parameter k of the distribution (mean k * scale)
+      * \param  scale   Scale parameter theta of the distribution
+      */
+    long double gamma(long double shape, long double scale);
+
+    /**
+      * \brief  Produces a random value of Weibull distribution, with distribution function 1 - exp(-(x/scale)^shape)
+      */
+    long double weibull(long double shape, long double scale);
+
+    /**
+      * \brief  Produces a random value of Pareto distribution, with distribution function 1 - (scale/x)^shape, x >= scale
+      */
+    long double pareto(long double shape, long double scale);
+
+    /**
+      * \brief  Produces a random value of Erlang distribution: the sum of k values of exponential distribution with parameter lambda
+      *
+      * The value is obtained with a single logarithm of a product of uniform values when k is small, and as a Gamma
+      * value else.
+      */
+    long double erlang(unsigned k, long double lambda);
+
+    /**
+      * \brief  Produces a random value of hyperexponential distribution: the value of an exponential distribution
+      *         chosen among several ones
+      * \param  branches    Alias table of the probabilities of the exponential distributions
+      * \param  rates       Parameter of each exponential distribution
+      */
+    long double hyperexponential(const AliasTable& branches, const std::vector<double>& rates);
+
+    /**
+      * \brief  Produces a random value of the given phase-type distribution
+      */
+    long double phaseType(const PhaseTypeDistribution& distribution);
+
+    /**
+      * \brief  Produces a random value of exponential distribution with parameter 1, with the Ziggurat method
+      */
+    double standardExponential();
+
+    /**
+      * \brief  Produces a random value of Normal distribution with mean 0 and standard deviation 1, with the Ziggurat method
+      */
+    double standardNormal();
+
+    // Bulk generation
+    /**
+      * \brief  Fills out with n random real numbers in interval [a,b[
+      */
+    void uniform(double* out, size_t n, double a, double b);
+
+    /**
+      * \brief  Fills out with n random values of exponential distribution with parameter lambda
+      */
+    void exponential(double* out, size_t n, double lambda);
+
+    /**
+      * \brief  Fills out with n random values of Normal distribution (both values of each Box-Muller pair are used)
+      */
+    void normal(double* out, size_t n, double mean, double stddev);
+
+    /**
+      * \brief  Fills out with n random values of Log-Normal distribution
+      */
+    void lognormal(double* out, size_t n, double mean, double stddev);
+
+    /**
+      * \brief  Fills out with n random values of Gamma distribution
+      */
+    void gamma(double* out, size_t n, double shape, double scale);
+
+    /**
+      * \brief  Fills out with n random values of Weibull distribution
+      */
+    void weibull(double* out, size_t n, double shape, double scale);
+
+    /**
+      * \brief  Fills out with n random values of Pareto distribution
+      */
+    void pareto(double* out, size_t n, double shape, double scale);
+
+    /**
+      * \brief  Fills out with n random values of Erlang distribution
+      */
+    void erlang(double* out, size_t n, unsigned k, double lambda);
+
+    /**
+      * \brief  Identifier of the stream used by the default generator
+      */
+    static const unsigned long defaultStreamId = 0xffffffff;
+
 private:
-    // Private constructors and assignement operator to ensure singleton property
+    friend class RandomSampler;
+
+    // Private default constructor, used to build the default generator
     Random();
-    Random(const Random& other) { }
-    Random& operator=(const Random& other) { return *this; }
+
+    // Thresholds above which the constant time Poisson and Binomial samplers are used
+    static constexpr double poissonPTRSThreshold = 10;
+    static constexpr double binomialBTPEThreshold = 30;
+    // Threshold above which exp(-lambda) underflows, and inversion can not be used for Poisson and Binomial samplers
+    static constexpr double inversionThreshold = 700;
+    // Threshold above which Erlang values are produced as Gamma values
+    static constexpr unsigned erlangGammaThreshold = 16;
 
     /**
       * \brief computes and returns next random number
       */
-    unsigned long getRand();
+    unsigned long long getRand()
+    {
+        return m_antithetic ? ~m_stream.next() : m_stream.next();
+    }
+
+    /**
+      * \brief fills out with the next n random numbers
+      */
+    void getRands(uint64_t* out, size_t n);
+
+    /**
+      * \brief computes and returns next random real number of [0,1[, in double precision
+      */
+    double getUniform();
+
+    /**
+      * \brief computes and returns next random real number of ]0,1[, in double precision, symmetric for antithetic values
+      */
+    double getOpenUniform();
+
+    /**
+      * \brief  Produces a random value of Gamma distribution with shape d + 1/3 >= 1 and scale 1, with c = 1/sqrt(9d)
+      */
+    double standardGamma(double d, double c);
+
+    // Constants of the PTRS Poisson sampler, derived from lambda only
+    struct PoissonPTRSConstants {
+        PoissonPTRSConstants();
+        explicit PoissonPTRSConstants(double lambda);
+
+        double lambda;
+        double logLambda;
+        double b;
+        double a;
+        double logInvAlpha;
+        double vr;
+    };
+
+    // Constants of the BTPE Binomial sampler, derived from n and p only (p not greater than 0.5)
+    struct BinomialBTPEConstants {
+        BinomialBTPEConstants();
+        BinomialBTPEConstants(unsigned n, double p);
+
+        unsigned n;
+        double p;
+        double q;
+        double nrq;
+        long m;
+        double p1;
+        double xm;
+        double xl;
+        double xr;
+        double c;
+        double lambdaL;
+        double lambdaR;
+        double p2;
+        double p3;
+        double p4;
+    };
+
+    // Poisson and Binomial samplers used by FastSampling
+    unsigned poissonPTRS(double lambda);
+    unsigned poissonPTRS(const PoissonPTRSConstants& constants);
+    unsigned binomialInversion(unsigned n, double p);
+    unsigned binomialBTPE(unsigned n, double p);
+    unsigned binomialBTPE(const BinomialBTPEConstants& constants);
 
     // Private attributs
     static Random* generatorInstance;
+    static thread_local Random* threadGeneratorInstance;
 
-    unsigned long base;
-    unsigned seedsNb;
-    unsigned long* seeds;
-    unsigned long multiplier;
-    unsigned long carry;
-
-    unsigned index;
+    RandomStream m_stream;
+    SamplingMode m_samplingMode;
+    bool m_antithetic;
 };
 
 #endif // RANDOM_H
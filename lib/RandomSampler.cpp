@@ -0,0 +1,253 @@
+#include "RandomSampler.h"
+
+#include <cmath>
+
+RandomSampler::RandomSampler(const RandomVariable& variable)
+    : m_variable(variable)
+    , m_sampleFunction(&RandomSampler::sampleUnusable)
+    , m_shift(0)
+    , m_scale(0)
+    , m_lowerBound(0)
+    , m_range(0)
+    , m_inverseShape(0)
+    , m_gammaD(0)
+    , m_gammaC(0)
+    , m_poissonConstants()
+    , m_binomialConstants()
+{
+    switch (m_variable.type()) {
+    case RandomVariable::Uniform:
+        m_shift = m_variable.uniformParameters().lowerBound;
+        m_scale = m_variable.uniformParameters().upperBound - m_shift;
+        m_sampleFunction = &RandomSampler::sampleUniform;
+        break;
+    case RandomVariable::IntUniform:
+        m_lowerBound = m_variable.intUniformParameters().lowerBound;
+        m_range = m_variable.intUniformParameters().upperBound - m_lowerBound + 1;
+        m_sampleFunction = &RandomSampler::sampleIntUniform;
+        break;
+    case RandomVariable::Bernoulli:
+        m_scale = m_variable.bernoulliParameters();
+        m_sampleFunction = &RandomSampler::sampleBernoulli;
+        break;
+    case RandomVariable::Binomial: {
+        // Sample with the smallest of p and 1-p, and mirror the value if needed
+        double p = m_variable.binomialParameters().prob;
+        m_range = m_variable.binomialParameters().nb;
+        m_scale = p <= 0.5 ? p : 1 - p;
+        m_shift = p <= 0.5 ? 0 : 1;
+        if (m_range * m_scale > Random::binomialBTPEThreshold)
+            m_binomialConstants = Random::BinomialBTPEConstants((unsigned)m_range, m_scale);
+        m_sampleFunction = &RandomSampler::sampleBinomial;
+        break;
+    }
+    case RandomVariable::Poisson:
+        // Either exp(-lambda), for sampling by multiplication, or lambda itself, for the PTRS algorithm
+        m_shift = m_variable.poissonParameters();
+        m_scale = m_shift < Random::poissonPTRSThreshold ? exp(-m_shift) : m_shift;
+        if (m_shift >= Random::poissonPTRSThreshold)
+            m_poissonConstants = Random::PoissonPTRSConstants(m_shift);
+        m_sampleFunction = &RandomSampler::samplePoisson;
+        break;
+    case RandomVariable::Exponential:
+        m_scale = 1 / m_variable.exponentialParameters();
+        m_sampleFunction = &RandomSampler::sampleExponential;
+        break;
+    case RandomVariable::Normal:
+        m_shift = m_variable.normalParameters().mean;
+        m_scale = m_variable.normalParameters().stdDev;
+        m_sampleFunction = &RandomSampler::sampleNormal;
+        break;
+    case RandomVariable::LogNormal: {
+        // Parameters of the underlying Normal distribution
+        double mean = m_variable.lognormalParameters().mean, stddev = m_variable.lognormalParameters().stdDev;
+        double logVarianceRatio = log(1 + (stddev * stddev) / (mean * mean));
+        m_shift = log(mean) - logVarianceRatio / 2;
+        m_scale = sqrt(logVarianceRatio);
+        m_sampleFunction = &RandomSampler::sampleLogNormal;
+        break;
+    }
+    case RandomVariable::Categorical:
+        m_sampleFunction = &RandomSampler::sampleCategorical;
+        break;
+    case RandomVariable::Trace:
+        m_sampleFunction = &RandomSampler::sampleTrace;
+        break;
+    case RandomVariable::Gamma: {
+        // Shapes below 1 are boosted by 1, and corrected with a power of a uniform value
+        double shape = m_variable.gammaParameters().shape;
+        m_inverseShape = shape < 1 ? 1 / shape : 0;
+        m_gammaD = (shape < 1 ? shape + 1 : shape) - 1. / 3;
+        m_gammaC = 1 / sqrt(9 * m_gammaD);
+        m_scale = m_variable.gammaParameters().scale;
+        m_sampleFunction = &RandomSampler::sampleGamma;
+        break;
+    }
+    case RandomVariable::Weibull:
+        m_inverseShape = 1 / m_variable.weibullParameters().shape;
+        m_scale = m_variable.weibullParameters().scale;
+        m_sampleFunction = &RandomSampler::sampleWeibull;
+        break;
+    case RandomVariable::Pareto:
+        m_inverseShape = 1 / m_variable.paretoParameters().shape;
+        m_scale = m_variable.paretoParameters().scale;
+        m_sampleFunction = &RandomSampler::samplePareto;
+        break;
+    case RandomVariable::Erlang:
+        m_range = m_variable.erlangParameters().k;
+        m_scale = 1 / m_variable.erlangParameters().rate;
+        m_gammaD = m_range - 1. / 3;
+        m_gammaC = m_range >= Random::erlangGammaThreshold ? 1 / sqrt(9 * m_gammaD) : 0;
+        m_sampleFunction = &RandomSampler::sampleErlang;
+        break;
+    case RandomVariable::HyperExponential:
+        m_sampleFunction = &RandomSampler::sampleHyperExponential;
+        break;
+    case RandomVariable::PhaseType:
+        m_sampleFunction = &RandomSampler::samplePhaseType;
+        break;
+    default:
+        break;
+    }
+}
+
+void RandomSampler::generate(double* out, size_t n, Random* generator) const
+{
+    // Continuous distributions have vectorised bulk methods
+    switch (m_variable.type()) {
+    case RandomVariable::Uniform:
+        generator->uniform(out, n, m_shift, m_shift + m_scale);
+        break;
+    case RandomVariable::Exponential:
+        generator->exponential(out, n, m_variable.exponentialParameters());
+        break;
+    case RandomVariable::Normal:
+        generator->normal(out, n, m_shift, m_scale);
+        break;
+    case RandomVariable::LogNormal:
+        generator->normal(out, n, m_shift, m_scale);
+        for (size_t i = 0; i < n; ++i)
+            out[i] = exp(out[i]);
+        break;
+    case RandomVariable::Weibull:
+        generator->weibull(out, n, m_variable.weibullParameters().shape, m_scale);
+        break;
+    case RandomVariable::Pareto:
+        generator->pareto(out, n, m_variable.paretoParameters().shape, m_scale);
+        break;
+    default:
+        for (size_t i = 0; i < n; ++i)
+            out[i] = m_sampleFunction(*this, *generator);
+        break;
+    }
+}
+
+double RandomSampler::sampleUnusable(const RandomSampler&, Random&)
+{
+    return 0;
+}
+
+double RandomSampler::sampleUniform(const RandomSampler& sampler, Random& generator)
+{
+    return sampler.m_shift + sampler.m_scale * generator.getUniform();
+}
+
+double RandomSampler::sampleIntUniform(const RandomSampler& sampler, Random& generator)
+{
+    return sampler.m_lowerBound + (long)(generator.getRand() % sampler.m_range);
+}
+
+double RandomSampler::sampleBernoulli(const RandomSampler& sampler, Random& generator)
+{
+    return generator.getUniform() < sampler.m_scale ? 1 : 0;
+}
+
+double RandomSampler::sampleBinomial(const RandomSampler& sampler, Random& generator)
+{
+    unsigned n = (unsigned)sampler.m_range;
+    double r = sampler.m_scale;
+    if (r <= 0)
+        return sampler.m_shift ? n : 0;
+
+    unsigned v = n * r <= Random::binomialBTPEThreshold ? generator.binomialInversion(n, r) : generator.binomialBTPE(sampler.m_binomialConstants);
+    return sampler.m_shift ? n - v : v;
+}
+
+double RandomSampler::samplePoisson(const RandomSampler& sampler, Random& generator)
+{
+    if (sampler.m_shift >= Random::poissonPTRSThreshold)
+        return generator.poissonPTRS(sampler.m_poissonConstants);
+
+    double p = generator.getUniform();
+    unsigned k = 0;
+    while (p > sampler.m_scale) {
+        ++k;
+        p *= generator.getUniform();
+    }
+    return k;
+}
+
+double RandomSampler::sampleExponential(const RandomSampler& sampler, Random& generator)
+{
+    return generator.standardExponential() * sampler.m_scale;
+}
+
+double RandomSampler::sampleNormal(const RandomSampler& sampler, Random& generator)
+{
+    return sampler.m_shift + sampler.m_scale * generator.standardNormal();
+}
+
+double RandomSampler::sampleLogNormal(const RandomSampler& sampler, Random& generator)
+{
+    return exp(sampler.m_shift + sampler.m_scale * generator.standardNormal());
+}
+
+double RandomSampler::sampleCategorical(const RandomSampler& sampler, Random& generator)
+{
+    return sampler.m_variable.categoricalValues()[generator.discrete(sampler.m_variable.categoricalTable())];
+}
+
+double RandomSampler::sampleTrace(const RandomSampler& sampler, Random& generator)
+{
+    return sampler.m_variable.traceSample(&generator);
+}
+
+double RandomSampler::sampleGamma(const RandomSampler& sampler, Random& generator)
+{
+    double value = sampler.m_scale * generator.standardGamma(sampler.m_gammaD, sampler.m_gammaC);
+    if (sampler.m_inverseShape)
+        value *= pow(generator.getOpenUniform(), sampler.m_inverseShape);
+    return value;
+}
+
+double RandomSampler::sampleWeibull(const RandomSampler& sampler, Random& generator)
+{
+    return sampler.m_scale * pow(generator.standardExponential(), sampler.m_inverseShape);
+}
+
+double RandomSampler::samplePareto(const RandomSampler& sampler, Random& generator)
+{
+    return sampler.m_scale * exp(generator.standardExponential() * sampler.m_inverseShape);
+}
+
+double RandomSampler::sampleErlang(const RandomSampler& sampler, Random& generator)
+{
+    if (sampler.m_gammaC)
+        return sampler.m_scale * generator.standardGamma(sampler.m_gammaD, sampler.m_gammaC);
+
+    double product = 1;
+    for (unsigned i = 0; i < sampler.m_range; ++i)
+        product *= generator.getOpenUniform();
+    return -log(product) * sampler.m_scale;
+}
+
+double RandomSampler::sampleHyperExponential(const RandomSampler& sampler, Random& generator)
+{
+    unsigned branch = generator.discrete(sampler.m_variable.categoricalTable());
+    return generator.standardExponential() / sampler.m_variable.categoricalValues()[branch];
+}
+
+double RandomSampler::samplePhaseType(const RandomSampler& sampler, Random& generator)
+{
+    return generator.phaseType(*sampler.m_variable.phaseTypeDistribution());
+}
@@ -0,0 +1,90 @@
+#ifndef RANDOMSAMPLER_H
+#define RANDOMSAMPLER_H
+
+#include "Random.h"
+#include "RandomVariable.h"
+
+#include <cstddef>
+
+/**
+  * \brief  Compiled form of a RandomVariable, to draw many samples of the same distribution.
+  *
+  * RandomVariable::generateSample() dispatches on the variable type, and the methods of Random derive their constants
+  * from the distribution parameters, on every draw. A sampler does both only once, when built: it keeps the constants
+  * of the distribution (e.g. the parameters of the underlying Normal distribution of a Log-Normal variable) and a
+  * pointer to the function transforming random values into samples. A sample then only costs this transform:
+  *     RandomSampler serviceTime(RandomVariable(RandomVariable::LogNormal, 3, 2));
+  *     x = serviceTime.sample(randomGenerator());
+  *
+  * sample() always uses the algorithms of Random::FastSampling, while generate() uses the bulk methods of the generator
+  * for continuous distributions, which follow its sampling mode. A sampler does not follow later changes of the
+  * variable it was built from (a sampler of a replayed trace has its own position in the trace).
+  */
+class RandomSampler {
+public:
+    /**
+      * \brief  Constructor
+      * \param  variable    Random variable to sample
+      */
+    RandomSampler(const RandomVariable& variable = RandomVariable());
+
+    /**
+      * \brief  Returns the sampled random variable
+      */
+    const RandomVariable& variable() const
+    {
+        return m_variable;
+    }
+
+    /**
+      * \brief  Produces a sample of the random variable
+      * \param  generator   Generator giving the random values (the default, process wide, generator if not given)
+      */
+    double sample(Random* generator = Random::Generate()) const
+    {
+        return m_sampleFunction(*this, *generator);
+    }
+
+    /**
+      * \brief  Fills out with n samples of the random variable
+      * \param  generator   Generator giving the random values (the default, process wide, generator if not given)
+      */
+    void generate(double* out, size_t n, Random* generator = Random::Generate()) const;
+
+private:
+    typedef double (*SampleFunction)(const RandomSampler& sampler, Random& generator);
+
+    // Core transforms of each distribution
+    static double sampleUnusable(const RandomSampler& sampler, Random& generator);
+    static double sampleUniform(const RandomSampler& sampler, Random& generator);
+    static double sampleIntUniform(const RandomSampler& sampler, Random& generator);
+    static double sampleBernoulli(const RandomSampler& sampler, Random& generator);
+    static double sampleBinomial(const RandomSampler& sampler, Random& generator);
+    static double samplePoisson(const RandomSampler& sampler, Random& generator);
+    static double sampleExponential(const RandomSampler& sampler, Random& generator);
+    static double sampleNormal(const RandomSampler& sampler, Random& generator);
+    static double sampleLogNormal(const RandomSampler& sampler, Random& generator);
+    static double sampleCategorical(const RandomSampler& sampler, Random& generator);
+    static double sampleTrace(const RandomSampler& sampler, Random& generator);
+    static double sampleGamma(const RandomSampler& sampler, Random& generator);
+    static double sampleWeibull(const RandomSampler& sampler, Random& generator);
+    static double samplePareto(const RandomSampler& sampler, Random& generator);
+    static double sampleErlang(const RandomSampler& sampler, Random& generator);
+    static double sampleHyperExponential(const RandomSampler& sampler, Random& generator);
+    static double samplePhaseType(const RandomSampler& sampler, Random& generator);
+
+    RandomVariable m_variable;
+    SampleFunction m_sampleFunction;
+    // Constants of the distribution, their meaning depends on the variable type
+    double m_shift;
+    double m_scale;
+    long m_lowerBound;
+    unsigned long long m_range;
+    double m_inverseShape;
+    double m_gammaD;
+    double m_gammaC;
+    Random::PoissonPTRSConstants m_poissonConstants;
+    Random::BinomialBTPEConstants m_binomialConstants;
+};
+
+#endif // RANDOMSAMPLER_H
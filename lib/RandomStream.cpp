@@ -0,0 +1,133 @@
+#include "RandomStream.h"
+
+namespace {
+// Philox4x32 multipliers and Weyl sequence constants (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+const uint32_t philoxM0 = 0xD2511F53;
+const uint32_t philoxM1 = 0xCD9E8D57;
+const uint32_t philoxW0 = 0x9E3779B9;
+const uint32_t philoxW1 = 0xBB67AE85;
+const unsigned philoxRounds = 10;
+}
+
+const unsigned RandomStream::batchBlocksNb;
+const unsigned RandomStream::batchValuesNb;
+
+RandomStream::RandomStream(unsigned long long seed, unsigned replication, unsigned long streamId)
+    : m_key()
+    , m_replication(0)
+    , m_streamId(0)
+    , m_position(0)
+    , m_batch()
+{
+    setKey(seed, replication, streamId);
+}
+
+void RandomStream::setKey(unsigned long long seed, unsigned replication, unsigned long streamId)
+{
+    m_key[0] = (uint32_t)seed;
+    m_key[1] = (uint32_t)(seed >> 32);
+    m_replication = (uint32_t)replication;
+    m_streamId = (uint32_t)streamId;
+    reset();
+}
+
+unsigned long long RandomStream::seed() const
+{
+    return ((unsigned long long)m_key[1] << 32) | m_key[0];
+}
+
+unsigned RandomStream::replication() const
+{
+    return m_replication;
+}
+
+unsigned long RandomStream::streamId() const
+{
+    return m_streamId;
+}
+
+void RandomStream::seek(unsigned long long position)
+{
+    m_position = position;
+    // When stopping in the middle of a batch, the rest of the batch has to be available for the next draws
+    if (m_position % batchValuesNb)
+        computeBatch(m_position / batchValuesNb, m_batch);
+}
+
+void RandomStream::generate(uint64_t* out, size_t n)
+{
+    size_t i = 0;
+
+    // Finish the current batch first
+    while ((m_position % batchValuesNb) && i < n)
+        out[i++] = next();
+
+    // Then write full batches directly in the output buffer
+    while (n - i >= batchValuesNb) {
+        computeBatch(m_position / batchValuesNb, out + i);
+        i += batchValuesNb;
+        m_position += batchValuesNb;
+    }
+
+    while (i < n)
+        out[i++] = next();
+}
+
+void RandomStream::computeBatch(unsigned long long batchIndex, uint64_t* out) const
+{
+    // Each lane of the batch is independent, so that the compiler can map the batch onto vector registers
+    uint32_t c0[batchBlocksNb], c1[batchBlocksNb], c2[batchBlocksNb], c3[batchBlocksNb];
+
+    for (unsigned lane = 0; lane < batchBlocksNb; ++lane) {
+        unsigned long long blockIndex = batchIndex * batchBlocksNb + lane;
+        c0[lane] = (uint32_t)blockIndex;
+        c1[lane] = (uint32_t)(blockIndex >> 32);
+        c2[lane] = m_replication;
+        c3[lane] = m_streamId;
+    }
+
+    uint32_t k0 = m_key[0], k1 = m_key[1];
+    for (unsigned round = 0; round < philoxRounds; ++round) {
+        for (unsigned lane = 0; lane < batchBlocksNb; ++lane) {
+            uint64_t p0 = (uint64_t)philoxM0 * c0[lane];
+            uint64_t p1 = (uint64_t)philoxM1 * c2[lane];
+            uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1[lane] ^ k0;
+            uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3[lane] ^ k1;
+            c1[lane] = (uint32_t)p1;
+            c3[lane] = (uint32_t)p0;
+            c0[lane] = n0;
+            c2[lane] = n2;
+        }
+        k0 += philoxW0;
+        k1 += philoxW1;
+    }
+
+    for (unsigned lane = 0; lane < batchBlocksNb; ++lane) {
+        out[2 * lane] = ((uint64_t)c1[lane] << 32) | c0[lane];
+        out[2 * lane + 1] = ((uint64_t)c3[lane] << 32) | c2[lane];
+    }
+}
+
+void RandomStream::philox(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4])
+{
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for (unsigned round = 0; round < philoxRounds; ++round) {
+        uint64_t p0 = (uint64_t)philoxM0 * c0;
+        uint64_t p1 = (uint64_t)philoxM1 * c2;
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t)p1;
+        c3 = (uint32_t)p0;
+        c0 = n0;
+        c2 = n2;
+        k0 += philoxW0;
+        k1 += philoxW1;
+    }
+
+    result[0] = c0;
+    result[1] = c1;
+    result[2] = c2;
+    result[3] = c3;
+}
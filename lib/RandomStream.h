@@ -0,0 +1,129 @@
+#ifndef RANDOMSTREAM_H
+#define RANDOMSTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+  * \brief  Counter-based stream of random numbers (Philox4x32-10).
+  *
+  * A stream is identified by a key made of a 64 bits seed, a replication index and a stream identifier (usually the Id
+  * of the module using the stream). The n-th value of a stream is computed directly from this key and from the position
+  * n, so that:
+  * -   streams with different keys are independent, and do not share any state (no locking is needed to use them
+  *     from several threads, as long as each thread uses its own streams),
+  * -   a stream can be moved to any position in constant time (skip-ahead),
+  * -   a stream is fully reproducible from its key.
+  *
+  * Internally, each evaluation of the Philox4x32-10 bijection over the 128 bits counter
+  *     (block index [64 bits], replication [32 bits], stream identifier [32 bits])
+  * produces two 64 bits values. Only the 32 low bits of the stream identifier are significant.
+  * Blocks are computed by batches of batchBlocksNb, which are then served one value after the other.
+  */
+class RandomStream {
+public:
+    /**
+      * \brief  Number of Philox blocks computed at once
+      */
+    static const unsigned batchBlocksNb = 8;
+
+    /**
+      * \brief  Number of 64 bits values computed at once
+      */
+    static const unsigned batchValuesNb = 2 * batchBlocksNb;
+
+    /**
+      * \brief  Constructor
+      * \param  seed        Seed shared by all the streams of a simulation
+      * \param  replication Index of the replication using the stream
+      * \param  streamId    Identifier of the stream inside the replication (e.g. the Id of the module using it)
+      */
+    RandomStream(unsigned long long seed = 0, unsigned replication = 0, unsigned long streamId = 0);
+
+    /**
+      * \brief  Changes the key of the stream, and moves it back to its first value
+      */
+    void setKey(unsigned long long seed, unsigned replication, unsigned long streamId);
+
+    /**
+      * \brief  Returns the seed used in the key of the stream
+      */
+    unsigned long long seed() const;
+
+    /**
+      * \brief  Returns the replication index used in the key of the stream
+      */
+    unsigned replication() const;
+
+    /**
+      * \brief  Returns the stream identifier used in the key of the stream
+      */
+    unsigned long streamId() const;
+
+    /**
+      * \brief  Returns the number of 64 bits values already drawn from the stream
+      */
+    unsigned long long position() const
+    {
+        return m_position;
+    }
+
+    /**
+      * \brief  Moves the stream, in constant time, so that the next drawn value is the one at the given position
+      */
+    void seek(unsigned long long position);
+
+    /**
+      * \brief  Skips, in constant time, the given number of 64 bits values
+      */
+    void skip(unsigned long long count)
+    {
+        seek(m_position + count);
+    }
+
+    /**
+      * \brief  Moves the stream back to its first value
+      */
+    void reset()
+    {
+        seek(0);
+    }
+
+    /**
+      * \brief  Returns the next 64 bits value of the stream
+      */
+    inline uint64_t next()
+    {
+        unsigned index = (unsigned)(m_position % batchValuesNb);
+        if (index == 0)
+            computeBatch(m_position / batchValuesNb, m_batch);
+        ++m_position;
+        return m_batch[index];
+    }
+
+    /**
+      * \brief  Fills the given buffer with the next n 64 bits values of the stream
+      *
+      * Gives the same values as n calls to next(), but computes several Philox blocks at once.
+      */
+    void generate(uint64_t* out, size_t n);
+
+    /**
+      * \brief  Applies the Philox4x32-10 bijection to the given counter, using the given key
+      */
+    static void philox(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4]);
+
+private:
+    /**
+      * \brief  Computes the batch of values of the given index, and writes its batchValuesNb values in out
+      */
+    void computeBatch(unsigned long long batchIndex, uint64_t* out) const;
+
+    uint32_t m_key[2];
+    uint32_t m_replication;
+    uint32_t m_streamId;
+    unsigned long long m_position;
+    uint64_t m_batch[batchValuesNb];
+};
+
+#endif // RANDOMSTREAM_H
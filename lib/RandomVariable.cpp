@@ -1,18 +1,28 @@
 #include "RandomVariable.h"
 #include "Random.h"
 
+#include <algorithm>
 #include <cfloat>
 #include <climits>
 #include <cmath>
+#include <sstream>
+#include <stdexcept>
 
 const std::vector<std::string> RandomVariable::m_typesNames = {
-    "Unusable", "Uniform", "IntUniform", "Bernoulli", "Binomial", "Poisson", "Exponential", "Normal", "LogNormal"
+    "Unusable", "Uniform", "IntUniform", "Bernoulli", "Binomial", "Poisson", "Exponential", "Normal", "LogNormal", "Categorical", "Trace",
+    "Gamma", "Weibull", "Pareto", "Erlang", "HyperExponential", "PhaseType"
 };
 
 RandomVariable::RandomVariable(const VariableType varType, const double param1, const double param2)
     : m_category(RandomVariable::Undefined)
     , m_type(RandomVariable::Unusable)
     , m_param()
+    , m_aliasTable()
+    , m_values()
+    , m_traceFile()
+    , m_phaseType()
+    , m_traceMode(TraceReplay)
+    , m_tracePosition(0)
 {
     switch (varType) {
     case Uniform:
@@ -39,6 +49,18 @@ RandomVariable::RandomVariable(const VariableType varType, const double param1,
     case LogNormal:
         setLogNormal(param1, param2);
         break;
+    case Gamma:
+        setGamma(param1, param2);
+        break;
+    case Weibull:
+        setWeibull(param1, param2);
+        break;
+    case Pareto:
+        setPareto(param1, param2);
+        break;
+    case Erlang:
+        setErlang((unsigned)param1, param2);
+        break;
     default:
         break;
     }
@@ -105,6 +127,153 @@ void RandomVariable::setLogNormal(const double mean, const double standardDev)
     m_param.lognormalParam.stdDev = standardDev;
 }
 
+void RandomVariable::setGamma(const double shape, const double scale)
+{
+    m_type = Gamma;
+    m_category = Continuous;
+    m_param.gammaParam.shape = shape;
+    m_param.gammaParam.scale = scale;
+}
+
+void RandomVariable::setWeibull(const double shape, const double scale)
+{
+    m_type = Weibull;
+    m_category = Continuous;
+    m_param.weibullParam.shape = shape;
+    m_param.weibullParam.scale = scale;
+}
+
+void RandomVariable::setPareto(const double shape, const double scale)
+{
+    m_type = Pareto;
+    m_category = Continuous;
+    m_param.paretoParam.shape = shape;
+    m_param.paretoParam.scale = scale;
+}
+
+void RandomVariable::setErlang(const unsigned k, const double lambda)
+{
+    m_type = Erlang;
+    m_category = Continuous;
+    m_param.erlangParam.k = k;
+    m_param.erlangParam.rate = lambda;
+}
+
+void RandomVariable::setHyperExponential(const std::vector<double>& probabilities, const std::vector<double>& rates)
+{
+    if (rates.size() != probabilities.size()) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": " << rates.size() << " rates given for " << probabilities.size()
+                        << " probabilities.";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    m_aliasTable.setWeights(probabilities);
+    m_values = rates;
+    m_type = HyperExponential;
+    m_category = Continuous;
+}
+
+void RandomVariable::setPhaseType(const std::vector<double>& initialProbabilities, const std::vector<std::vector<double>>& subGenerator)
+{
+    setPhaseType(std::make_shared<const PhaseTypeDistribution>(initialProbabilities, subGenerator));
+}
+
+void RandomVariable::setPhaseType(const std::shared_ptr<const PhaseTypeDistribution>& distribution)
+{
+    if (!distribution) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Setting a phase-type variable without distribution.";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    m_phaseType = distribution;
+    m_type = PhaseType;
+    m_category = Continuous;
+}
+
+void RandomVariable::setCategorical(const std::vector<double>& weights, const std::vector<double>& values)
+{
+    if (!values.empty() && values.size() != weights.size()) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": " << values.size() << " values given for " << weights.size()
+                        << " weights.";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    m_aliasTable.setWeights(weights);
+    m_values = values;
+    if (m_values.empty()) {
+        m_values.resize(weights.size());
+        for (unsigned i = 0; i < m_values.size(); ++i)
+            m_values[i] = i;
+    }
+    m_type = Categorical;
+    m_category = Discrete;
+}
+
+void RandomVariable::setTrace(const std::string& fileName, const TraceMode mode)
+{
+    setTrace(std::make_shared<const TraceFile>(fileName), mode);
+}
+
+void RandomVariable::setTrace(const std::shared_ptr<const TraceFile>& traceFile, const TraceMode mode)
+{
+    if (!traceFile) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Setting a trace-driven variable without trace file.";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+    if (mode == TraceInterpolation && !traceFile->isSorted()) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Interpolating the distribution of the unsorted trace file \""
+                        << traceFile->fileName() << "\".";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    m_traceFile = traceFile;
+    m_traceMode = mode;
+    m_tracePosition = 0;
+    if (mode == TraceReplay)
+        m_traceFile->prefetch(0);
+    else
+        m_traceFile->adviseRandomAccess();
+    m_type = Trace;
+    m_category = Continuous;
+}
+
+double RandomVariable::traceSample(Random* generator) const
+{
+    const TraceFile& trace = *m_traceFile;
+    switch (m_traceMode) {
+    case TraceReplay: {
+        // Read the next window ahead, when starting a new one
+        if (m_tracePosition % TraceFile::prefetchWindowSize == 0)
+            trace.prefetch(m_tracePosition + TraceFile::prefetchWindowSize);
+        double value = trace.value(m_tracePosition);
+        if (++m_tracePosition == trace.size())
+            m_tracePosition = 0;
+        return value;
+        break;
+    }
+    case TraceResampling:
+        return trace.value(generator->intuniform(0, trace.size() - 1));
+        break;
+    case TraceInterpolation: {
+        // Inversion of the empirical distribution function, linear between consecutive values
+        double position = generator->uniform(0, 1) * (trace.size() - 1);
+        size_t index = (size_t)position;
+        if (index + 1 >= trace.size())
+            return trace.value(trace.size() - 1);
+        return trace.value(index) + (position - index) * (trace.value(index + 1) - trace.value(index));
+        break;
+    }
+    default:
+        return 0;
+        break;
+    }
+}
+
 double RandomVariable::generateSample() const
 {
     switch (m_type) {
@@ -145,12 +314,132 @@ double RandomVariable::generateSample() const
             m_param.lognormalParam.mean,
             m_param.lognormalParam.stdDev);
         break;
+    case Categorical:
+        return m_values[Random::Generate()->discrete(m_aliasTable)];
+        break;
+    case Trace:
+        return traceSample(Random::Generate());
+        break;
+    case Gamma:
+        return Random::Generate()->gamma(
+            m_param.gammaParam.shape,
+            m_param.gammaParam.scale);
+        break;
+    case Weibull:
+        return Random::Generate()->weibull(
+            m_param.weibullParam.shape,
+            m_param.weibullParam.scale);
+        break;
+    case Pareto:
+        return Random::Generate()->pareto(
+            m_param.paretoParam.shape,
+            m_param.paretoParam.scale);
+        break;
+    case Erlang:
+        return Random::Generate()->erlang(
+            m_param.erlangParam.k,
+            m_param.erlangParam.rate);
+        break;
+    case HyperExponential:
+        return Random::Generate()->hyperexponential(m_aliasTable, m_values);
+        break;
+    case PhaseType:
+        return Random::Generate()->phaseType(*m_phaseType);
+        break;
     default:
         return 0;
         break;
     }
 }
 
+void RandomVariable::generateSamples(double* out, size_t n) const
+{
+    Random* generator = Random::Generate();
+    switch (m_type) {
+    case Uniform:
+        generator->uniform(out, n,
+            m_param.uniformParam.lowerBound,
+            m_param.uniformParam.upperBound);
+        break;
+    case Exponential:
+        generator->exponential(out, n,
+            m_param.exponentialParam);
+        break;
+    case Normal:
+        generator->normal(out, n,
+            m_param.normalParam.mean,
+            m_param.normalParam.stdDev);
+        break;
+    case LogNormal:
+        generator->lognormal(out, n,
+            m_param.lognormalParam.mean,
+            m_param.lognormalParam.stdDev);
+        break;
+    case IntUniform:
+        for (size_t i = 0; i < n; ++i)
+            out[i] = generator->intuniform(
+                m_param.intUniformParam.lowerBound,
+                m_param.intUniformParam.upperBound);
+        break;
+    case Bernoulli:
+        for (size_t i = 0; i < n; ++i)
+            out[i] = generator->bernoulli(
+                m_param.bernoulliParam);
+        break;
+    case Binomial:
+        for (size_t i = 0; i < n; ++i)
+            out[i] = generator->binomial(
+                m_param.binomialParam.nb,
+                m_param.binomialParam.prob);
+        break;
+    case Poisson:
+        for (size_t i = 0; i < n; ++i)
+            out[i] = generator->poisson(
+                m_param.poissonParam);
+        break;
+    case Categorical:
+        for (size_t i = 0; i < n; ++i)
+            out[i] = m_values[generator->discrete(m_aliasTable)];
+        break;
+    case Trace:
+        for (size_t i = 0; i < n; ++i)
+            out[i] = traceSample(generator);
+        break;
+    case Gamma:
+        generator->gamma(out, n,
+            m_param.gammaParam.shape,
+            m_param.gammaParam.scale);
+        break;
+    case Weibull:
+        generator->weibull(out, n,
+            m_param.weibullParam.shape,
+            m_param.weibullParam.scale);
+        break;
+    case Pareto:
+        generator->pareto(out, n,
+            m_param.paretoParam.shape,
+            m_param.paretoParam.scale);
+        break;
+    case Erlang:
+        generator->erlang(out, n,
+            m_param.erlangParam.k,
+            m_param.erlangParam.rate);
+        break;
+    case HyperExponential:
+        for (size_t i = 0; i < n; ++i)
+            out[i] = generator->hyperexponential(m_aliasTable, m_values);
+        break;
+    case PhaseType:
+        for (size_t i = 0; i < n; ++i)
+            out[i] = generator->phaseType(*m_phaseType);
+        break;
+    default:
+        for (size_t i = 0; i < n; ++i)
+            out[i] = 0;
+        break;
+    }
+}
+
 double RandomVariable::mean() const
 {
     switch (m_type) {
@@ -178,6 +467,40 @@ double RandomVariable::mean() const
     case LogNormal:
         return m_param.lognormalParam.mean;
         break;
+    case Categorical: {
+        double sum = 0;
+        for (unsigned i = 0; i < m_values.size(); ++i)
+            sum += m_aliasTable.probability(i) * m_values[i];
+        return sum;
+        break;
+    }
+    case Trace:
+        return m_traceFile->mean();
+        break;
+    case Gamma:
+        return m_param.gammaParam.shape * m_param.gammaParam.scale;
+        break;
+    case Weibull:
+        return m_param.weibullParam.scale * tgamma(1 + 1 / m_param.weibullParam.shape);
+        break;
+    case Pareto:
+        if (m_param.paretoParam.shape <= 1)
+            return DBL_MAX;
+        return m_param.paretoParam.shape * m_param.paretoParam.scale / (m_param.paretoParam.shape - 1);
+        break;
+    case Erlang:
+        return m_param.erlangParam.k / m_param.erlangParam.rate;
+        break;
+    case HyperExponential: {
+        double sum = 0;
+        for (unsigned i = 0; i < m_values.size(); ++i)
+            sum += m_aliasTable.probability(i) / m_values[i];
+        return sum;
+        break;
+    }
+    case PhaseType:
+        return m_phaseType->mean();
+        break;
     default:
         return 0;
         break;
@@ -215,6 +538,44 @@ double RandomVariable::variance() const
     case LogNormal:
         return (m_param.lognormalParam.stdDev * m_param.lognormalParam.stdDev);
         break;
+    case Categorical: {
+        double m = mean(), sum = 0;
+        for (unsigned i = 0; i < m_values.size(); ++i)
+            sum += m_aliasTable.probability(i) * (m_values[i] - m) * (m_values[i] - m);
+        return sum;
+        break;
+    }
+    case Trace:
+        return m_traceFile->variance();
+        break;
+    case Gamma:
+        return m_param.gammaParam.shape * m_param.gammaParam.scale * m_param.gammaParam.scale;
+        break;
+    case Weibull: {
+        double g1 = tgamma(1 + 1 / m_param.weibullParam.shape), g2 = tgamma(1 + 2 / m_param.weibullParam.shape);
+        return m_param.weibullParam.scale * m_param.weibullParam.scale * (g2 - g1 * g1);
+        break;
+    }
+    case Pareto: {
+        double alpha = m_param.paretoParam.shape;
+        if (alpha <= 2)
+            return DBL_MAX;
+        return m_param.paretoParam.scale * m_param.paretoParam.scale * alpha / ((alpha - 1) * (alpha - 1) * (alpha - 2));
+        break;
+    }
+    case Erlang:
+        return m_param.erlangParam.k / (m_param.erlangParam.rate * m_param.erlangParam.rate);
+        break;
+    case HyperExponential: {
+        double m = mean(), secondMoment = 0;
+        for (unsigned i = 0; i < m_values.size(); ++i)
+            secondMoment += 2 * m_aliasTable.probability(i) / (m_values[i] * m_values[i]);
+        return secondMoment - m * m;
+        break;
+    }
+    case PhaseType:
+        return m_phaseType->variance();
+        break;
     default:
         return 0;
         break;
@@ -238,6 +599,15 @@ double RandomVariable::minValue() const
     case Normal:
         return -DBL_MAX;
         break;
+    case Categorical:
+        return *std::min_element(m_values.begin(), m_values.end());
+        break;
+    case Trace:
+        return m_traceFile->minValue();
+        break;
+    case Pareto:
+        return m_param.paretoParam.scale;
+        break;
     case Bernoulli:
     case Binomial:
     case Poisson:
@@ -267,6 +637,20 @@ double RandomVariable::maxValue() const
     case Poisson:
         return INT_MAX;
         break;
+    case Categorical:
+        return *std::max_element(m_values.begin(), m_values.end());
+        break;
+    case Trace:
+        return m_traceFile->maxValue();
+        break;
+    case Gamma:
+    case Weibull:
+    case Pareto:
+    case Erlang:
+    case HyperExponential:
+    case PhaseType:
+        return DBL_MAX;
+        break;
     case Exponential:
     case Normal:
     case LogNormal:
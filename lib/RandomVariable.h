@@ -1,9 +1,17 @@
 #ifndef RANDOMVARIABLE_H
 #define RANDOMVARIABLE_H
 
+#include "AliasTable.h"
+#include "PhaseTypeDistribution.h"
+#include "TraceFile.h"
+
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <vector>
 
+class Random;
+
 class RandomVariable {
 public:
     enum VariableCategory {
@@ -20,7 +28,24 @@ public:
         Poisson,
         Exponential,
         Normal,
-        LogNormal
+        LogNormal,
+        Categorical,
+        Trace,
+        Gamma,
+        Weibull,
+        Pareto,
+        Erlang,
+        HyperExponential,
+        PhaseType
+    };
+
+    /**
+      * \brief  Ways of producing samples from the values of a trace file
+      */
+    enum TraceMode {
+        TraceReplay, ///< Values are replayed in order, going back to the first one after the last one
+        TraceResampling, ///< Values are drawn uniformly at random among the values of the trace
+        TraceInterpolation ///< Values are drawn from the empirical distribution function of the (sorted) trace, linearly interpolated
     };
 
     struct UniformParameters {
@@ -43,6 +68,16 @@ public:
         double stdDev;
     };
 
+    struct ShapeScaleParameters {
+        double shape;
+        double scale;
+    };
+
+    struct ErlangParameters {
+        unsigned k;
+        double rate;
+    };
+
     RandomVariable(const VariableType varType = Unusable, const double param1 = 0, const double param2 = 0);
 
     // Getters
@@ -106,6 +141,51 @@ public:
         return m_param.lognormalParam;
     }
 
+    const ShapeScaleParameters& gammaParameters() const
+    {
+        return m_param.gammaParam;
+    }
+
+    const ShapeScaleParameters& weibullParameters() const
+    {
+        return m_param.weibullParam;
+    }
+
+    const ShapeScaleParameters& paretoParameters() const
+    {
+        return m_param.paretoParam;
+    }
+
+    const ErlangParameters& erlangParameters() const
+    {
+        return m_param.erlangParam;
+    }
+
+    const std::shared_ptr<const PhaseTypeDistribution>& phaseTypeDistribution() const
+    {
+        return m_phaseType;
+    }
+
+    const AliasTable& categoricalTable() const
+    {
+        return m_aliasTable;
+    }
+
+    const std::vector<double>& categoricalValues() const
+    {
+        return m_values;
+    }
+
+    const std::shared_ptr<const TraceFile>& traceFile() const
+    {
+        return m_traceFile;
+    }
+
+    TraceMode traceMode() const
+    {
+        return m_traceMode;
+    }
+
     // Setters
     void setUnusable()
     {
@@ -122,9 +202,63 @@ public:
     void setNormal(const double mean = 0, const double standardDev = 1);
     void setLogNormal(const double mean, const double standardDev);
 
+    void setGamma(const double shape, const double scale);
+    void setWeibull(const double shape, const double scale);
+    void setPareto(const double shape, const double scale);
+    void setErlang(const unsigned k, const double lambda);
+
+    /**
+      * \brief  Sets an hyperexponential distribution
+      * \param  probabilities   Probability (or weight) of each exponential distribution
+      * \param  rates           Parameter of each exponential distribution (the categorical values of the variable)
+      */
+    void setHyperExponential(const std::vector<double>& probabilities, const std::vector<double>& rates);
+
+    /**
+      * \brief  Sets a phase-type distribution (see PhaseTypeDistribution)
+      */
+    void setPhaseType(const std::vector<double>& initialProbabilities, const std::vector<std::vector<double>>& subGenerator);
+
+    /**
+      * \brief  Sets a phase-type distribution, shared with other variables
+      */
+    void setPhaseType(const std::shared_ptr<const PhaseTypeDistribution>& distribution);
+
+    /**
+      * \brief  Sets an arbitrary discrete distribution, sampled in constant time with an alias table
+      * \param  weights Weight of each value, the probability of values[i] being weights[i] / sum(weights)
+      * \param  values  Values of the distribution (if empty, the values are the indexes 0, 1, ..., weights.size()-1)
+      */
+    void setCategorical(const std::vector<double>& weights, const std::vector<double>& values = std::vector<double>());
+
+    /**
+      * \brief  Sets a trace-driven variable, whose samples come from the values of a memory mapped file (see TraceFile)
+      * \param  fileName    Name of the trace file, a raw array of doubles
+      * \param  mode        Way of producing samples from the values (TraceInterpolation needs sorted values)
+      */
+    void setTrace(const std::string& fileName, const TraceMode mode = TraceReplay);
+
+    /**
+      * \brief  Sets a trace-driven variable, on a trace file shared with other variables
+      */
+    void setTrace(const std::shared_ptr<const TraceFile>& traceFile, const TraceMode mode = TraceReplay);
+
     // Generator
+    /**
+      * \brief  Produces a sample of the random variable (see RandomSampler, to produce many samples of a same variable)
+      */
     double generateSample() const;
 
+    /**
+      * \brief  Fills out with n samples of the random variable, using the bulk generation methods of Random
+      */
+    void generateSamples(double* out, size_t n) const;
+
+    /**
+      * \brief  Produces a sample of a trace-driven variable, using the given generator for random modes
+      */
+    double traceSample(Random* generator) const;
+
     // Random Variable characteristics
     double mean() const;
     double variance() const;
@@ -144,11 +278,21 @@ private:
         double poissonParam;
         NormalParameters normalParam;
         NormalParameters lognormalParam;
+        ShapeScaleParameters gammaParam;
+        ShapeScaleParameters weibullParam;
+        ShapeScaleParameters paretoParam;
+        ErlangParameters erlangParam;
     };
 
     VariableCategory m_category;
     VariableType m_type;
     VariableParams m_param;
+    AliasTable m_aliasTable;
+    std::vector<double> m_values;
+    std::shared_ptr<const TraceFile> m_traceFile;
+    std::shared_ptr<const PhaseTypeDistribution> m_phaseType;
+    TraceMode m_traceMode;
+    mutable size_t m_tracePosition;
 
     static const std::vector<std::string> m_typesNames;
 };
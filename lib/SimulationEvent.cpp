@@ -7,6 +7,7 @@ SimulationEvent::SimulationEvent(const ModuleId& creatorId, const std::string& n
     : BaseObject(name)
     , m_occurrenceTime()
     , m_scheduled(false)
+    , m_schedulingRank(0)
 {
     m_creationTime = DESimulator::simTime();
     m_creationModule = creatorId;
@@ -16,6 +17,7 @@ SimulationEvent::SimulationEvent(const SimulationEvent& other)
     : BaseObject()
     , m_occurrenceTime()
     , m_scheduled(false)
+    , m_schedulingRank(0)
 {
     m_creationTime = DESimulator::simTime();
     operator=(other);
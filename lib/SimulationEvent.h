@@ -61,12 +61,23 @@ public:
 
     virtual const ModuleId& creationModule() const;
 
+    /**
+      * \brief  Returns the rank of the event among the events scheduled in its run, which orders simultaneous events
+      */
+    unsigned long long schedulingRank() const
+    {
+        return m_schedulingRank;
+    }
+
     virtual const char* serialize() const;
 
 protected:
 private:
+    friend class DESimulator;
+
     SimulationTime m_occurrenceTime;
     bool m_scheduled;
+    unsigned long long m_schedulingRank;
 
     SimulationTime m_creationTime;
     ModuleId m_creationModule;
@@ -3,8 +3,10 @@
 
 SimulationModule::SimulationModule(int moduleKind, const std::string& name)
     : BaseObject(name)
+    , m_randomGenerator(Random::Generate()->seed())
 {
     m_moduleId = UniqueIDGenerator<ModuleId>::Generator()->newId();
+    m_randomGenerator.stream().setKey(Random::Generate()->seed(), 0, m_moduleId);
     setKind(moduleKind);
 }
 
@@ -70,6 +72,15 @@ void SimulationModule::sim_getReady()
     if (DESimulator::simulationStage() != DESimulator::InitializationStage)
         throw std::runtime_error("Invoking module initialization method out of simulator initialization stage.");
 
+    // Every replication draws from its own streams, which are antithetic when the default generator is
+    Random* defaultGenerator = Random::defaultGenerator();
+    m_randomGenerator.stream().setKey(defaultGenerator->seed(), defaultGenerator->replication(), m_moduleId);
+    m_randomGenerator.setAntithetic(defaultGenerator->isAntithetic());
+    for (std::map<std::string, Random>::iterator it = m_inputGenerators.begin(); it != m_inputGenerators.end(); ++it) {
+        Random::SamplingMode mode = it->second.samplingMode();
+        it->second = defaultGenerator->substream(it->first);
+        it->second.setSamplingMode(mode);
+    }
     getReady();
 }
 
@@ -104,19 +115,18 @@ bool SimulationModulePtrCmp::operator()(SimulationModule* const& mod1, Simulatio
     return mod1->id() < mod2->id();
 }
 
-void SimulationModule::sim_setNeighbours(const std::set<ModuleId>& sources, const std::set<ModuleId>& dests)
+std::size_t SimulationModulePtrHash::operator()(SimulationModule* const& mod) const
 {
-    int index;
+    if (!mod)
+        throw std::runtime_error(__PRETTY_FUNCTION__ + std::string(": Hashing NULL pointer referenced SimulationModule."));
 
-    m_neighboursSourcesOfParticles.resize(sources.size());
-    index = 0;
-    for (std::set<ModuleId>::const_iterator it = sources.begin(); it != sources.end(); it++)
-        m_neighboursSourcesOfParticles.at(index++) = *it;
+    return std::hash<ModuleId>()(mod->id());
+}
 
-    m_neighboursDestinationForParticles.resize(dests.size());
-    index = 0;
-    for (std::set<ModuleId>::const_iterator it = dests.begin(); it != dests.end(); it++)
-        m_neighboursDestinationForParticles.at(index++) = *it;
+void SimulationModule::sim_setNeighbours(const std::vector<ModuleId>& sources, const std::vector<ModuleId>& dests)
+{
+    m_neighboursSourcesOfParticles = sources;
+    m_neighboursDestinationForParticles = dests;
 }
 
 ModuleId SimulationModule::neighbourSourceOfParticlesId(unsigned index) const
@@ -166,12 +176,56 @@ SimulationModule* SimulationModule::neighbourSourceOfParticlesPtr(unsigned index
 {
     if (index >= m_neighboursSourcesOfParticles.size())
         return NULL;
-    return DESimulator::theSimulator()->getSimulationGraph()->vertex(m_neighboursSourcesOfParticles.at(index));
+    return DESimulator::theSimulator()->module(m_neighboursSourcesOfParticles.at(index));
 }
 
 SimulationModule* SimulationModule::neighbourDestinationForParticlesPtr(unsigned index) const
 {
     if (index >= m_neighboursDestinationForParticles.size())
         return NULL;
-    return DESimulator::theSimulator()->getSimulationGraph()->vertex(m_neighboursDestinationForParticles.at(index));
+    return DESimulator::theSimulator()->module(m_neighboursDestinationForParticles.at(index));
+}
+
+Random* SimulationModule::inputGenerator(const std::string& inputName)
+{
+    std::map<std::string, Random>::iterator it = m_inputGenerators.find(inputName);
+    if (it == m_inputGenerators.end())
+        it = m_inputGenerators.insert(std::make_pair(inputName, Random::defaultGenerator()->substream(inputName))).first;
+    return &it->second;
+}
+
+void SimulationModule::setDestinationsWeights(const std::vector<double>& weights)
+{
+    if (weights.empty())
+        m_destinationsTable = AliasTable();
+    else
+        m_destinationsTable.setWeights(weights);
+}
+
+unsigned SimulationModule::chooseDestinationForParticlesIndex()
+{
+    unsigned destinationsNb = m_neighboursDestinationForParticles.size();
+    if (destinationsNb == 0)
+        return 0;
+
+    if (m_destinationsTable.isEmpty())
+        return m_randomGenerator.intuniform(0, destinationsNb - 1);
+
+    if (m_destinationsTable.size() != destinationsNb) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Routing table of module " << id() << " has "
+                        << m_destinationsTable.size() << " weights for " << destinationsNb << " destination modules.";
+        throw std::runtime_error(exceptionStream.str());
+    }
+    return m_randomGenerator.discrete(m_destinationsTable);
+}
+
+ModuleId SimulationModule::chooseDestinationForParticlesId()
+{
+    return neighbourDestinationForParticlesId(chooseDestinationForParticlesIndex());
+}
+
+ModuleId SimulationModule::nextHopTo(const ModuleId destinationId) const
+{
+    return DESimulator::theSimulator()->nextHop(m_moduleId, destinationId);
 }
@@ -8,11 +8,14 @@
 #ifndef SIMULATIONMODULE_H
 #define SIMULATIONMODULE_H
 
+#include "AliasTable.h"
 #include "BaseObject.h"
+#include "Random.h"
 #include "SimulationTime.h"
 #include "common.h"
 
 #include <iostream>
+#include <map>
 #include <set>
 #include <vector>
 
@@ -46,6 +49,27 @@ public:
         return m_moduleId;
     }
 
+    /**
+      * \brief  Returns the random numbers generator of the module.
+      *
+      * Each module draws from its own stream, identified by the simulation seed, the current replication index and the
+      * module Id. Modules runs are so reproducible, and independent from the events ordering in other modules.
+      */
+    Random* randomGenerator()
+    {
+        return &m_randomGenerator;
+    }
+
+    /**
+      * \brief  Returns the random numbers generator of the given model input (e.g. "arrivals" or "service times").
+      *
+      * Unlike randomGenerator(), the stream of an input only depends on the simulation seed, the current replication
+      * index and the input name: alternative configurations of a model (other modules, other Ids) draw the same random
+      * numbers for the same inputs (common random numbers), whatever the generator of the thread simulating the module
+      * (see DESimulator::setComponentsThreadsNb()). Each input of the model must have its own name.
+      */
+    Random* inputGenerator(const std::string& inputName);
+
     /**
       * \brief      Called by the simulation engine when a simulation is about to start.
       * \warning    Must ONLY be called by simulation engine. Must NOT be overloaded.
@@ -77,10 +101,12 @@ public:
     virtual void sim_handleTimerTriggering(ModuleTimer* triggeredTimer);
 
     /**
-      * \brief      Called by the simulation engine when ..
+      * \brief      Called by the simulation engine before a simulation, to set the modules linked to this one.
+      * \param      sources     Ids of the modules that can emit particles to this module, in increasing order
+      * \param      dests       Ids of the modules that can receive particles from this module, in increasing order
       * \warning    Must ONLY be called by simulation engine. Must NOT be overloaded.
       */
-    virtual void sim_setNeighbours(const std::set<ModuleId>& sources, const std::set<ModuleId>& dests);
+    virtual void sim_setNeighbours(const std::vector<ModuleId>& sources, const std::vector<ModuleId>& dests);
 
     /**
       * \brief  Returns the number of modules linked to this module in the simulation, which can emit moving particles to the current module.
@@ -114,6 +140,33 @@ public:
       */
     virtual SimulationModule* neighbourDestinationForParticlesPtr(unsigned index) const;
 
+    /**
+      * \brief  Sets the routing table of the module: the weights used to choose the modules receiving its particles.
+      * \param  weights weight of each neighbour module that can receive particles, in the order of their indexes (see
+      *                 neighbourDestinationForParticlesId()). An empty vector goes back to uniform choices.
+      */
+    virtual void setDestinationsWeights(const std::vector<double>& weights);
+    /**
+      * \brief  Chooses randomly, in constant time, the index of a module that can receive particles from the current module.
+      *
+      * The choice follows the routing table of the module if any (see setDestinationsWeights()), and is uniform among
+      * neighbour modules else. Values are drawn from the module's own random generator.
+      * \return index of the chosen neighbour module, or neighbourDestinationForParticlesNb() if there is no such module.
+      */
+    virtual unsigned chooseDestinationForParticlesIndex();
+    /**
+      * \brief  Chooses randomly a module that can receive particles from the current module (see chooseDestinationForParticlesIndex()).
+      * \return Id of the chosen neighbour module, or invalidModuleId if there is no such module.
+      */
+    virtual ModuleId chooseDestinationForParticlesId();
+
+    /**
+      * \brief  Returns, in constant time, the neighbour module to which particles are forwarded to reach the given
+      *         destination, on a shortest path (see DESimulator::computeRoutingTable()).
+      * \return Id of the neighbour module, or invalidModuleId if the destination is this module or can not be reached.
+      */
+    virtual ModuleId nextHopTo(const ModuleId destinationId) const;
+
     virtual const char* serialize() const;
 
 protected:
@@ -160,11 +213,14 @@ private:
     typedef std::vector<ModuleId> NeighboursVector;
 
     ModuleId m_moduleId;
+    Random m_randomGenerator;
+    std::map<std::string, Random> m_inputGenerators;
     tMovingParticlesSet m_particlesInModule;
     tTimersSet m_timersInModule;
 
     NeighboursVector m_neighboursSourcesOfParticles;
     NeighboursVector m_neighboursDestinationForParticles;
+    AliasTable m_destinationsTable;
 };
 
 /**
@@ -179,4 +235,11 @@ struct SimulationModulePtrCmp {
     bool operator()(SimulationModule* const& mod1, SimulationModule* const& mod2) const;
 };
 
+/**
+  * \brief  Hash of modules by their Id, consistent with SimulationModulePtrCmp.
+  */
+struct SimulationModulePtrHash {
+    std::size_t operator()(SimulationModule* const& mod) const;
+};
+
 #endif // SIMULATIONMODULE_H
@@ -0,0 +1,80 @@
+#include "SimulationModuleFactory.h"
+
+#include <sstream>
+#include <stdexcept>
+
+SimulationModuleFactory* SimulationModuleFactory::m_factory = NULL;
+
+SimulationModuleFactory::SimulationModuleFactory()
+    : m_creators()
+{
+}
+
+SimulationModuleFactory* SimulationModuleFactory::theFactory()
+{
+    if (m_factory == NULL)
+        m_factory = new SimulationModuleFactory();
+
+    return m_factory;
+}
+
+void SimulationModuleFactory::registerModule(const std::string& moduleType, const ModuleCreator& creator)
+{
+    if (!creator) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": No creator given for modules of type \"" << moduleType << "\".";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+    m_creators[moduleType] = creator;
+}
+
+bool SimulationModuleFactory::isRegistered(const std::string& moduleType) const
+{
+    return m_creators.find(moduleType) != m_creators.end();
+}
+
+void SimulationModuleFactory::clear()
+{
+    m_creators.clear();
+}
+
+SimulationModule* SimulationModuleFactory::create(const std::string& moduleType, const std::string& name, const GraphMLReader::Attributes& data) const
+{
+    ModuleCreatorSet::const_iterator it = m_creators.find(moduleType);
+    if (it == m_creators.end()) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Unknown module type \"" << moduleType << "\" for module \"" << name << "\".";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    SimulationModule* module = it->second(name, data);
+    if (!module) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Creator of type \"" << moduleType << "\" built no module.";
+        throw std::runtime_error(exceptionStream.str());
+    }
+    return module;
+}
+
+DESimulator::SimulationGraph::VertexLoader SimulationModuleFactory::vertexLoader(const std::string& typeAttribute, const std::string& nameAttribute) const
+{
+    return [this, typeAttribute, nameAttribute](const std::string& nodeId, const GraphMLReader::Attributes& data, ModuleId& vertexId) {
+        GraphMLReader::Attributes::const_iterator type = data.find(typeAttribute);
+        if (type == data.end()) {
+            std::ostringstream exceptionStream;
+            exceptionStream << __PRETTY_FUNCTION__ << ": Node " << nodeId << " has no \"" << typeAttribute << "\" data.";
+            throw std::invalid_argument(exceptionStream.str());
+        }
+        GraphMLReader::Attributes::const_iterator name = data.find(nameAttribute);
+        SimulationModule* module = create(type->second, name != data.end() ? name->second : nodeId, data);
+        vertexId = module->id();
+        return module;
+    };
+}
+
+DESimulator::SimulationGraph::VertexReleaser SimulationModuleFactory::vertexReleaser() const
+{
+    return [](SimulationModule* const& module) {
+        delete module;
+    };
+}
@@ -0,0 +1,94 @@
+#ifndef SIMULATIONMODULEFACTORY_H
+#define SIMULATIONMODULEFACTORY_H
+
+#include "DESimulator.h"
+#include "GraphMLReader.h"
+#include "SimulationModule.h"
+
+#include <functional>
+#include <map>
+#include <string>
+
+/**
+  * \brief  Builder of simulation modules from their type name, to load simulation graphs from GraphML files.
+  *
+  * Each subclass of SimulationModule is registered with a type name, and a creator of its instances given their name
+  * and the data of their node. vertexLoader() gives the loader of a simulation graph, that builds the module of each
+  * node from the type set in one of its data:
+  *
+  * \code
+  * SimulationModuleFactory::theFactory()->registerModule<MyQueue>("queue");
+  * SimulationModuleFactory* factory = SimulationModuleFactory::theFactory();
+  * graph->load("network.graphml", factory->vertexLoader(), DESimulator::SimulationGraph::ArcLoader(), &error, factory->vertexReleaser());
+  * \endcode
+  */
+class SimulationModuleFactory {
+public:
+    /**
+      * \brief  Creator of a module, from its name and the data of its node
+      */
+    typedef std::function<SimulationModule*(const std::string& name, const GraphMLReader::Attributes& data)> ModuleCreator;
+
+    /**
+      * \brief  Returns the factory
+      */
+    static SimulationModuleFactory* theFactory();
+
+    /**
+      * \brief  Registers (or replaces) the creator of the modules of the given type
+      */
+    void registerModule(const std::string& moduleType, const ModuleCreator& creator);
+
+    /**
+      * \brief  Registers the modules of the given type as instances of Module, built from their name
+      */
+    template <class Module>
+    void registerModule(const std::string& moduleType)
+    {
+        registerModule(moduleType, [](const std::string& name, const GraphMLReader::Attributes&) -> SimulationModule* {
+            return new Module(name);
+        });
+    }
+
+    /**
+      * \brief  Returns true if the given type is registered
+      */
+    bool isRegistered(const std::string& moduleType) const;
+
+    /**
+      * \brief  Removes all the registered types
+      */
+    void clear();
+
+    /**
+      * \brief  Builds a module of the given type
+      * \throw  std::invalid_argument if the type is not registered
+      */
+    SimulationModule* create(const std::string& moduleType, const std::string& name, const GraphMLReader::Attributes& data) const;
+
+    /**
+      * \brief  Returns the loader of the vertices of simulation graphs, for GenericGraph::load()
+      * \param  typeAttribute   name of the data giving the type of the module of a node
+      * \param  nameAttribute   name of the data giving the name of the module (the node id if missing)
+      *
+      * The modules are built by create(), and take their Ids as vertex Ids. Nodes without type, or of an unknown type,
+      * throw std::invalid_argument.
+      */
+    DESimulator::SimulationGraph::VertexLoader vertexLoader(const std::string& typeAttribute = "type", const std::string& nameAttribute = "name") const;
+
+    /**
+      * \brief  Returns the releaser of the modules built by vertexLoader(), deleting them when the loading fails
+      */
+    DESimulator::SimulationGraph::VertexReleaser vertexReleaser() const;
+
+private:
+    typedef std::map<std::string, ModuleCreator> ModuleCreatorSet;
+
+    SimulationModuleFactory();
+
+    static SimulationModuleFactory* m_factory;
+
+    ModuleCreatorSet m_creators;
+};
+
+#endif // SIMULATIONMODULEFACTORY_H
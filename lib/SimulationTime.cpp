@@ -7,261 +7,295 @@
 
 #include "SimulationTime.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <sstream>
+#include <stdexcept>
 
-unsigned SimulationTime::_timeDataLength = sizeof(SimulationTime::_time) << 3; // nbBits = nbOctets * 8 bits (we'll use 64 bits)
-unsigned SimulationTime::_timeDataPrecision = SimulationTime::_timeDataLength / 8 * 3; // precision = (nbBits / 8) * 3 (we'll use 24 of 64)
-/*
-SimulationTime::SimulationTime():
-    _time(0)
-{
-}
-*/
-SimulationTime::SimulationTime(const SimulationTime& other)
-    : _time(0)
-{
-    operator=(other);
-}
+namespace {
+typedef unsigned __int128 UInt128;
 
-SimulationTime::SimulationTime(const long double dbl_time)
-    : _time(0)
+// Absolute value of a signed integer, without overflow for the most negative value
+template <typename Integer>
+inline UInt128 magnitude(const Integer value)
 {
-    fromDbl(dbl_time);
+    return value < 0 ? (UInt128)0 - (UInt128)value : (UInt128)value;
 }
 
-void SimulationTime::toStr(char* writeStr) const
+// Signed integer of the given magnitude (wraps around when out of range, as the other time operations)
+template <typename Integer>
+inline Integer signedValue(const bool negative, const UInt128 magnitude)
 {
-    if (writeStr) {
-        long int intP = toInt();
-        bool sign = false;
-        if (intP < 0) {
-            sign = true;
-            intP = -intP;
-        }
-        int days = intP / (24 * 3600);
-        intP %= (24 * 3600);
-        int hours = intP / 3600;
-        intP %= 3600;
-        int minutes = intP / 60;
-        long double secondes = (intP % 60) + fabs(toDbl() - toInt());
-
-        std::ostringstream strm;
-        if (sign)
-            strm << "-";
-        if (days)
-            strm << days << "d";
-        if (hours)
-            strm << hours << "h";
-        if (minutes)
-            strm << minutes << "m";
-        if (secondes > 0) {
-            strm.precision(8);
-            strm << std::fixed << secondes << "s";
-        }
-        strcpy(writeStr, strm.str().c_str());
-    }
+    return (Integer)(negative ? (UInt128)0 - magnitude : magnitude);
 }
 
-void SimulationTime::fromStr(const char* readStr)
+// Largest value of a signed integer type
+template <typename Integer>
+inline UInt128 maxValue()
 {
-    if (!readStr)
-        return;
-
-    bool sign = false,
-         days = false,
-         hours = false,
-         minutes = false,
-         seconds = false;
-    long double tmpTime = 0, tmpNbr = 0, divisor = 0;
-    unsigned currentCharIndex = 0;
-
-    // Ignore all white spaces at string start, and react if we find a sign
-    bool stop = false;
-    while (currentCharIndex < strlen(readStr)) {
-        switch (readStr[currentCharIndex]) {
-        case '-': // Sign is switched
-            sign = !sign;
-            break;
-        case '+': // Sign does not change
-            break;
-        case ' ':
-        case '\t': // Ignore blank caracters
-            break;
-        default: // Anything else will be parsed by the next loop
-            stop = true;
-            break;
-        }
-        if (stop)
-            break;
-        else
-            currentCharIndex++;
-    }
-
-    while (currentCharIndex < strlen(readStr)) {
-        switch (readStr[currentCharIndex]) {
-        case ' ':
-        case '\t': // Ignore blank caracters
-            break;
-        case '0':
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
-            tmpNbr = tmpNbr * 10 + (readStr[currentCharIndex] - '0');
-            if (divisor)
-                divisor *= 10;
-            break;
-        case '.':
-            if (divisor)
-                throw("Encountred several decimal delimiters while parsing time string.");
-            divisor = 1;
-            break;
-        case 'd':
-            if (days)
-                throw("Encountred several day delimiters while parsing time string.");
-            if (divisor > 0)
-                tmpNbr /= divisor;
-            divisor = 0;
-            tmpTime += tmpNbr * 3600 * 24;
-            tmpNbr = 0;
-            days = true;
-            break;
-        case 'h':
-            if (hours)
-                throw("Encountred several hours delimiters while parsing time string.");
-            if (divisor > 0)
-                tmpNbr /= divisor;
-            divisor = 0;
-            tmpTime += tmpNbr * 3600;
-            tmpNbr = 0;
-            hours = true;
-            break;
-        case 'm':
-            if (minutes)
-                throw("Encountred several minutes delimiters while parsing time string.");
-            if (divisor > 0)
-                tmpNbr /= divisor;
-            divisor = 0;
-            tmpTime += tmpNbr * 60;
-            tmpNbr = 0;
-            minutes = true;
-            break;
-        case 's':
-            if (seconds)
-                throw("Encountred several seconds delimiters while parsing time string.");
-            if (divisor > 0)
-                tmpNbr /= divisor;
-            divisor = 0;
-            tmpTime += tmpNbr;
-            tmpNbr = 0;
-            seconds = true;
-            break;
-        default:
-            throw("Encountred unknown caracter while parsing time string.");
-            break;
-        }
-        currentCharIndex++;
-    }
-
-    if (tmpNbr > 0 && !seconds) // if no XXXs is to be found, but there is a XXX (with no 's')
-    {
-        if (divisor > 0)
-            tmpNbr /= divisor;
-        tmpTime += tmpNbr;
-    }
-
-    if (sign)
-        tmpTime = -tmpTime;
-    fromDbl(tmpTime);
+    return ~(UInt128)0 >> (129 - sizeof(Integer) * 8);
 }
 
-long int SimulationTime::toInt() const
+// Rounds value * 2^-shift to the nearest integer, ties away from zero
+inline UInt128 roundedShift(const UInt128 value, const int shift)
 {
-    return (long int)(toDbl());
+    if (shift <= 0)
+        return shift > -128 ? value << -shift : 0;
+    if (shift > 127)
+        return 0;
+    return (value >> shift) + ((value >> (shift - 1)) & 1);
 }
 
-void SimulationTime::fromInt(const long int int_time)
+// Rounds value * factor * 2^-shift to the nearest integer, ties away from zero (value under 2^127, factor under 2^64)
+inline UInt128 roundedProduct(const UInt128 value, const unsigned long long factor, const int shift)
 {
-    fromDbl((long double)int_time);
+    // value * factor = high * 2^64 + low
+    const UInt128 lowProduct = (UInt128)(unsigned long long)value * factor;
+    const UInt128 high = (value >> 64) * factor + (lowProduct >> 64);
+    const unsigned long long low = (unsigned long long)lowProduct;
+    if (shift > 64)
+        return roundedShift(high, shift - 64);
+    if (shift == 64)
+        return high + (low >> 63);
+    if (shift > 0)
+        return (high << (64 - shift)) + (low >> shift) + ((low >> (shift - 1)) & 1);
+    return roundedShift((high << 64) + low, shift);
 }
 
-long double SimulationTime::toDbl() const
+// Rounds numerator / denominator to the nearest integer, ties away from zero
+inline UInt128 roundedUnsignedQuotient(const UInt128 numerator, const UInt128 denominator)
 {
-    long double tmp = (long double)_time;
-    return (tmp / (long double)(2 << _timeDataPrecision));
+    UInt128 remainder = numerator % denominator;
+    return numerator / denominator + (remainder >= denominator - remainder ? 1 : 0);
 }
 
-void SimulationTime::fromDbl(const long double dbl_time)
+// Splits a finite double into mantissa * 2^(exponent - 53), with an integer mantissa (at most 53 bits)
+inline long long splitDouble(const double value, int& exponent)
 {
-    long double tmp = dbl_time * (2 << _timeDataPrecision);
-    _time = (DataType)tmp;
+    return (long long)ldexp(frexp(value, &exponent), 53);
 }
 
-SimulationTime& SimulationTime::operator+=(const SimulationTime& op)
+// Writes the decimal digits of value (at least minDigits, padded with zeros) followed by the delimiter
+char* writeDigits(char* buffer, UInt128 value, const unsigned minDigits, const char delimiter)
 {
-    _time += op._time;
-    return *this;
+    char digits[40];
+    unsigned length = 0;
+    do {
+        digits[length++] = '0' + value % 10;
+        value /= 10;
+    } while (value || length < minDigits);
+    while (length)
+        *buffer++ = digits[--length];
+    *buffer++ = delimiter;
+    return buffer;
 }
 
-SimulationTime& SimulationTime::operator-=(const SimulationTime& op)
+// Adds (number + decimals / decimalsScale) * seconds to a number of ticks, returns false if the ticks exceed maxTicks
+bool addTicks(UInt128& ticks, const UInt128 number, const unsigned long long decimals, const unsigned long long decimalsScale, const unsigned long long seconds, const UInt128 ticksPerSecond, const UInt128 maxTicks)
 {
-    _time -= op._time;
-    return *this;
+    if (number > maxTicks / ticksPerSecond / seconds)
+        return false;
+    ticks += number * seconds * ticksPerSecond + roundedUnsignedQuotient((UInt128)decimals * seconds * ticksPerSecond, decimalsScale);
+    return ticks <= maxTicks;
 }
-
-SimulationTime& SimulationTime::operator*=(const long double& op)
-{
-    fromDbl(toDbl() * op);
-    return *this;
 }
 
-SimulationTime& SimulationTime::operator/=(const long double& op)
+template <unsigned Precision, typename Storage>
+std::to_chars_result BasicSimulationTime<Precision, Storage>::toChars(char* first, char* last) const
 {
-    fromDbl(toDbl() / op);
-    return *this;
+    // Seconds, and their decimals rounded to the nearest
+    const UInt128 absolute = magnitude(_time);
+    UInt128 seconds = absolute / ticksPerSecond;
+    unsigned long long decimals = (unsigned long long)roundedUnsignedQuotient((absolute % ticksPerSecond) * secondsDecimalsScale, ticksPerSecond);
+    if (decimals == secondsDecimalsScale) {
+        ++seconds;
+        decimals = 0;
+    }
+    const UInt128 days = seconds / (24 * 3600);
+    unsigned rest = (unsigned)(seconds % (24 * 3600));
+    const unsigned hours = rest / 3600;
+    rest %= 3600;
+    const unsigned minutes = rest / 60;
+    rest %= 60;
+
+    char buffer[maxStringLength];
+    char* end = buffer;
+    if (_time < 0)
+        *end++ = '-';
+    if (days)
+        end = writeDigits(end, days, 1, 'd');
+    if (hours)
+        end = writeDigits(end, hours, 1, 'h');
+    if (minutes)
+        end = writeDigits(end, minutes, 1, 'm');
+    if (rest || decimals || !(days || hours || minutes)) {
+        end = writeDigits(end, rest, 1, '.');
+        end = writeDigits(end, decimals, secondsDecimals, 's');
+    }
+
+    if (end - buffer > last - first)
+        return { last, std::errc::value_too_large };
+    memcpy(first, buffer, end - buffer);
+    return { first + (end - buffer), std::errc() };
 }
 
-SimulationTime SimulationTime::operator+(const SimulationTime& op) const
+template <unsigned Precision, typename Storage>
+std::from_chars_result BasicSimulationTime<Precision, Storage>::fromChars(const char* first, const char* last)
 {
-    SimulationTime cpy(*this);
-    cpy.operator+=(op);
-    return cpy;
+    static const unsigned long long unitsSeconds[] = { 24 * 3600, 3600, 60, 1 };
+    static const char unitsDelimiters[] = { 'd', 'h', 'm', 's' };
+
+    const char* current = first;
+    bool negative = false;
+    // Ignore all white spaces at string start, and react if we find a sign
+    for (; current != last && strchr("-+ \t", *current) && *current; ++current)
+        if (*current == '-')
+            negative = !negative;
+
+    UInt128 ticks = 0;
+    UInt128 number = 0;
+    unsigned long long decimals = 0, decimalsScale = 1;
+    bool decimalDelimiter = false, pendingNumber = false, anyNumber = false;
+    bool unitsFound[4] = { false, false, false, false };
+    for (; current != last; ++current) {
+        const char c = *current;
+        if (c == ' ' || c == '\t')
+            continue;
+
+        if (c >= '0' && c <= '9') {
+            // Decimals beyond the 19th do not change the time
+            if (decimalDelimiter) {
+                if (decimalsScale <= ~0ULL / 10) {
+                    decimals = decimals * 10 + (c - '0');
+                    decimalsScale *= 10;
+                }
+            } else if (number <= (~(UInt128)0 - 9) / 10)
+                number = number * 10 + (c - '0');
+            else
+                return { current, std::errc::result_out_of_range };
+            pendingNumber = anyNumber = true;
+            continue;
+        }
+
+        if (c == '.') {
+            if (decimalDelimiter)
+                return { current, std::errc::invalid_argument };
+            decimalDelimiter = true;
+            continue;
+        }
+
+        const char* delimiter = (const char*)memchr(unitsDelimiters, c, sizeof(unitsDelimiters));
+        if (!delimiter)
+            break;
+        const unsigned unit = delimiter - unitsDelimiters;
+        if (unitsFound[unit] || !pendingNumber)
+            return { current, std::errc::invalid_argument };
+        if (!addTicks(ticks, number, decimals, decimalsScale, unitsSeconds[unit], ticksPerSecond, maxValue<DataType>()))
+            return { current, std::errc::result_out_of_range };
+        unitsFound[unit] = true;
+        number = 0;
+        decimals = 0;
+        decimalsScale = 1;
+        decimalDelimiter = pendingNumber = false;
+    }
+
+    if (!anyNumber)
+        return { first, std::errc::invalid_argument };
+    // A last number with no delimiter is a number of seconds
+    if (pendingNumber) {
+        if (unitsFound[3])
+            return { current, std::errc::invalid_argument };
+        if (!addTicks(ticks, number, decimals, decimalsScale, 1, ticksPerSecond, maxValue<DataType>()))
+            return { current, std::errc::result_out_of_range };
+    }
+
+    _time = signedValue<DataType>(negative, ticks);
+    return { current, std::errc() };
 }
 
-SimulationTime SimulationTime::operator-(const SimulationTime& op) const
+template <unsigned Precision, typename Storage>
+void BasicSimulationTime<Precision, Storage>::toStr(char* writeStr) const
 {
-    SimulationTime cpy(*this);
-    cpy.operator-=(op);
-    return cpy;
+    if (writeStr)
+        *toChars(writeStr, writeStr + maxStringLength).ptr = '\0';
 }
 
-SimulationTime SimulationTime::operator*(const long double& op) const
+template <unsigned Precision, typename Storage>
+void BasicSimulationTime<Precision, Storage>::fromStr(const char* readStr)
 {
-    SimulationTime cpy(*this);
-    cpy.operator*=(op);
-    return cpy;
+    if (!readStr)
+        return;
+
+    // The time is left unchanged if the string is not fully parsed
+    const char* last = readStr + strlen(readStr);
+    BasicSimulationTime parsed;
+    std::from_chars_result result = parsed.fromChars(readStr, last);
+    if (result.ec != std::errc() || result.ptr != last) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Invalid time string \"" << readStr << "\" at character "
+                        << (result.ptr - readStr) << ".";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+    _time = parsed._time;
 }
 
-SimulationTime SimulationTime::operator/(const long double& op) const
+template <unsigned Precision, typename Storage>
+BasicSimulationTime<Precision, Storage>& BasicSimulationTime<Precision, Storage>::operator*=(const double& op)
 {
-    SimulationTime cpy(*this);
-    cpy.operator/=(op);
-    return cpy;
+    if (!std::isfinite(op)) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Can not multiply a time by " << op << ".";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    // time * mantissa * 2^(exponent - 53), the product of a 64 bits time taking at most 63 + 53 bits
+    int exponent;
+    long long mantissa = splitDouble(op, exponent);
+    UInt128 product = sizeof(DataType) <= 8
+        ? roundedShift(magnitude(_time) * magnitude(mantissa), 53 - exponent)
+        : roundedProduct(magnitude(_time), (unsigned long long)magnitude(mantissa), 53 - exponent);
+    _time = signedValue<DataType>((_time < 0) != (mantissa < 0), product);
+    return *this;
 }
 
-std::ostream& operator<<(std::ostream& ost, const SimulationTime& time)
+template <unsigned Precision, typename Storage>
+BasicSimulationTime<Precision, Storage>& BasicSimulationTime<Precision, Storage>::operator/=(const double& op)
 {
-    //std::cout << "FGHJK" << std::endl;
-    char tmp[100];
-    time.toStr(&tmp[0]);
-    ost << tmp;
+    if (op == 0 || !std::isfinite(op)) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Can not divide a time by " << op << ".";
+        throw std::invalid_argument(exceptionStream.str());
+    }
+
+    // time * 2^(53 - exponent) / mantissa, the shifted operands kept under 128 bits
+    int exponent;
+    long long mantissa = splitDouble(op, exponent);
+    const bool negative = (_time < 0) != (mantissa < 0);
+    const UInt128 numerator = magnitude(_time), denominator = magnitude(mantissa);
+    const int shift = 53 - exponent;
 
-    return ost;
+    UInt128 quotient;
+    if (shift <= 0)
+        quotient = -shift > 75 ? 0 : roundedUnsignedQuotient(numerator, denominator << -shift);
+    else if (sizeof(DataType) <= 8 && shift <= 64)
+        quotient = roundedUnsignedQuotient(numerator << shift, denominator);
+    else {
+        // Long division, at most 64 bits of the shift at a time (beyond 192 bits, the result overflows anyway)
+        quotient = numerator / denominator;
+        UInt128 remainder = numerator % denominator;
+        for (int remainingShift = std::min(shift, 192); remainingShift > 0; remainingShift -= 64) {
+            const int step = std::min(remainingShift, 64);
+            remainder <<= step;
+            quotient = (quotient << step) + remainder / denominator;
+            remainder %= denominator;
+        }
+        quotient += remainder >= denominator - remainder ? 1 : 0;
+    }
+    _time = signedValue<DataType>(negative, quotient);
+    return *this;
 }
+
+template class BasicSimulationTime<24>;
+template class BasicSimulationTime<29>;
+template class BasicSimulationTime<29, __int128>;
@@ -8,100 +8,222 @@
 #ifndef SIMULATIONTIME_H
 #define SIMULATIONTIME_H
 
+#include <charconv>
 #include <iostream>
+#include <stdexcept>
+#include <type_traits>
 
 /**
  *  \brief  Abstraction of simulation time, used by simulation projects
  *
  *  This class represents the time used for simulation purposes. It uses a fixed point representation of time, to achieve
  *  speed and usability on several scales of time.
+ *
+ *  The precision is fixed at compile time: a time is stored as a number of ticks of 2^-(Precision + 1) second, so that
+ *  conversions use constant factors, and that constant times (e.g. 20_ms) are computed by the compiler. The default
+ *  precision (BasicSimulationTime<>) gives a resolution of about 30 ns over 8000 years, NanoSimulationTime a resolution
+ *  under the nanosecond over 270 years, and WideSimulationTime, stored on 128 bits, a resolution under the nanosecond
+ *  over 10^21 years. Other precisions and storages must be instantiated in SimulationTime.cpp.
+ *
+ *  SimulationTime, the time of the simulator, is BasicSimulationTime<>, or WideSimulationTime when the library is built
+ *  with SIMULATION_TIME_128BITS defined (CMake option of the same name).
  */
-class SimulationTime {
+/**
+  * \brief  Returns the smallest number of decimals of a second finer than a tick of 2^-(precision + 1) second, at most
+  *         19 (the decimals held by an unsigned long long)
+  */
+constexpr unsigned simulationTimeDecimals(const unsigned precision, const unsigned decimals = 0, const unsigned long long scale = 1)
+{
+    return decimals == 19 || (precision < 63 && scale > (2ULL << precision)) ? decimals : simulationTimeDecimals(precision, decimals + 1, scale * 10);
+}
+
+/**
+  * \brief  Returns 10^decimals
+  */
+constexpr unsigned long long simulationTimeDecimalsScale(const unsigned decimals)
+{
+    return decimals ? 10 * simulationTimeDecimalsScale(decimals - 1) : 1;
+}
+
+template <unsigned Precision = 24, typename Storage = long long>
+class BasicSimulationTime {
+    static_assert(Precision + 2 < sizeof(Storage) * 8 && Precision < 96, "The precision must leave bits for the integer part of the time");
+
 public:
+    /**
+      * \brief  Signed integer type of the number of ticks
+      */
+    typedef Storage DataType;
+
+    /**
+      * \brief  Number of ticks in a second
+      */
+    static constexpr DataType ticksPerSecond = (DataType)2 << Precision;
+
+    /**
+      * \brief  Decimals of the seconds written by toChars(): the time read back from them is the same, as long as
+      *         Precision is below 62
+      */
+    static constexpr unsigned secondsDecimals = simulationTimeDecimals(Precision);
+    static constexpr unsigned long long secondsDecimalsScale = simulationTimeDecimalsScale(secondsDecimals);
+
+    /**
+      * \brief  Maximal length of a time written by toChars() (the days taking at most as many digits as the storage)
+      */
+    static constexpr unsigned maxStringLength = sizeof(DataType) * 8 * 30103 / 100000 + 13 + secondsDecimals;
+
     // --------- Constructors
     /**
       * \brief  Default constructor that builds a 0-time.
       */
-    //SimulationTime();
+    //BasicSimulationTime();
 
     /**
       * \brief  Copy constructor.
       */
-    SimulationTime(const SimulationTime& other);
+    constexpr BasicSimulationTime(const BasicSimulationTime& other) = default;
 
     /**
       * \brief  Time Constructor from double value.
       */
-    SimulationTime(const long double dbl_time = 0);
+    constexpr BasicSimulationTime(const long double dbl_time = 0)
+        : _time((DataType)(dbl_time * ticksPerSecond))
+    {
+    }
+
+    /**
+      * \brief  Builds a time from its number of ticks
+      */
+    static constexpr BasicSimulationTime fromTicks(const DataType ticks)
+    {
+        BasicSimulationTime time;
+        time._time = ticks;
+        return time;
+    }
 
     // --------- Explicit Conversion methods
+    /**
+      * \brief  Returns the number of ticks of the time
+      */
+    constexpr DataType ticks() const
+    {
+        return _time;
+    }
+
     /**
       * \brief  Converts time into integer value
       * \return Integer part of the time stored in the object
       */
-    long int toInt() const;
+    constexpr long int toInt() const
+    {
+        return (long int)(_time / ticksPerSecond);
+    }
 
     /**
       * \brief  Converts time into double value
       * \return conversion of time into double value.
       */
-    long double toDbl() const;
+    constexpr long double toDbl() const
+    {
+        return (long double)_time / ticksPerSecond;
+    }
+
+    /**
+      * \brief  Converts time into double value, without long double arithmetic
+      * \return conversion of time into double value (exact up to 2^53 ticks).
+      */
+    constexpr double toDouble() const
+    {
+        return (double)_time * (1.0 / (double)ticksPerSecond);
+    }
 
     /**
       * \brief  Converts time from integer value
       * \param  int_time given time as integer value
       */
-    void fromInt(const long int int_time);
+    constexpr void fromInt(const long int int_time)
+    {
+        _time = (DataType)int_time * ticksPerSecond;
+    }
 
     /**
       * \brief  Converts time from double value
       * \param  dbl_time given time as double value
       */
-    void fromDbl(const long double dbl_time);
+    constexpr void fromDbl(const long double dbl_time)
+    {
+        _time = (DataType)(dbl_time * ticksPerSecond);
+    }
+
+    /**
+      * \brief  Converts time from double value, without long double arithmetic
+      * \param  dbl_time given time as double value (truncated toward zero to the time resolution, as fromDbl())
+      */
+    constexpr void fromDouble(const double dbl_time)
+    {
+        _time = (DataType)(dbl_time * (double)ticksPerSecond);
+    }
 
     /**
-      * \brief  Writes the time into the given string
-      * \param  writeStr    string where a string-version of the time is written
+      * \brief  Writes the time into the given string, as "1d2h3m4.50000000s" (see toChars())
+      * \param  writeStr    string where a string-version of the time is written, of maxStringLength + 1 characters
       */
     void toStr(char* writeStr) const;
 
     /**
       * \brief  Reads the time from the given string
       * \param  readStr    string from where a string-version of the time is read
+      * \throw  std::invalid_argument if the string is not a valid time (see fromChars())
       */
     void fromStr(const char* readStr);
 
+    /**
+      * \brief  Writes the time into [first, last), as "1d2h3m4.50000000s", without terminating null character
+      *
+      * Null parts are omitted, the seconds are rounded to secondsDecimals decimals (8 with the default precision, 10
+      * with the nanosecond ones), and a null time is written "0.00000000s".
+      * Nothing is allocated, and at most maxStringLength characters are written.
+      * \return Past-the-end pointer of the written characters, or last and std::errc::value_too_large if the range is
+      *         too short (its content is then unspecified)
+      */
+    std::to_chars_result toChars(char* first, char* last) const;
+
+    /**
+      * \brief  Reads the time from [first, last), without allocation
+      *
+      * Numbers followed by 'd', 'h', 'm' and 's', each at most once and in any order, are summed. A last number with no
+      * delimiter is a number of seconds. Leading signs and blanks are accepted. The time is rounded to the nearest tick.
+      * \return Pointer to the first character not parsed, and std::errc::invalid_argument (malformed time) or
+      *         std::errc::result_out_of_range (time too large) on error, in which case the time is not changed
+      */
+    std::from_chars_result fromChars(const char* first, const char* last);
+
     // --------- Information Getters
     /**
       * \brief  Returns the number of bits used to store time, as fixed point value.
       */
-    static inline unsigned getBitsLength()
+    static constexpr unsigned getBitsLength()
     {
-        return _timeDataLength;
+        return sizeof(DataType) << 3;
     }
 
     /**
       * \brief  Returns the number of bits used to store the fractionnal part of time.
       */
-    static inline unsigned getPrecisionLength()
+    static constexpr unsigned getPrecisionLength()
     {
-        return _timeDataPrecision;
+        return Precision;
     }
 
     /**
       * \brief  Assignment operator
       */
-    inline SimulationTime& operator=(const SimulationTime& other)
-    {
-        if (this != &other)
-            _time = other._time;
-        return *this;
-    }
+    constexpr BasicSimulationTime& operator=(const BasicSimulationTime& other) = default;
 
     /**
       * \brief  Equality test operator
       */
-    inline bool operator==(const SimulationTime& other) const
+    constexpr bool operator==(const BasicSimulationTime& other) const
     {
         return (_time == other._time);
     }
@@ -109,7 +231,7 @@ public:
     /**
       * \brief  Difference test operator
       */
-    inline bool operator!=(const SimulationTime& other) const
+    constexpr bool operator!=(const BasicSimulationTime& other) const
     {
         return !operator==(other);
     }
@@ -117,7 +239,7 @@ public:
     /**
       * \brief  Less than test operator
       */
-    inline bool operator<(const SimulationTime& other) const
+    constexpr bool operator<(const BasicSimulationTime& other) const
     {
         return (_time < other._time);
     }
@@ -125,15 +247,15 @@ public:
     /**
       * \brief  Less than or equal to test operator
       */
-    inline bool operator<=(const SimulationTime& other) const
+    constexpr bool operator<=(const BasicSimulationTime& other) const
     {
-        return (operator==(other) || operator<(other));
+        return (_time <= other._time);
     }
 
     /**
       * \brief  Greater than test operator
       */
-    inline bool operator>(const SimulationTime& other) const
+    constexpr bool operator>(const BasicSimulationTime& other) const
     {
         return (_time > other._time);
     }
@@ -141,62 +263,231 @@ public:
     /**
       * \brief  Greater than or equal to test operator
       */
-    inline bool operator>=(const SimulationTime& other) const
+    constexpr bool operator>=(const BasicSimulationTime& other) const
     {
-        return (operator==(other) || operator>(other));
+        return (_time >= other._time);
     }
 
     /**
       * \brief  Addition assignment operator
       */
-    SimulationTime& operator+=(const SimulationTime&);
+    constexpr BasicSimulationTime& operator+=(const BasicSimulationTime& op)
+    {
+        _time += op._time;
+        return *this;
+    }
 
     /**
       * \brief  Substraction assignment operator
       */
-    SimulationTime& operator-=(const SimulationTime&);
+    constexpr BasicSimulationTime& operator-=(const BasicSimulationTime& op)
+    {
+        _time -= op._time;
+        return *this;
+    }
 
     /**
       * \brief  Multiplication assignment operator
+      *
+      * The product is computed on integers (the exact binary value of the factor, with a 128 bits intermediate), and
+      * rounded to the nearest time tick, ties away from zero.
+      * \throw  std::invalid_argument if the factor is not finite
       */
-    SimulationTime& operator*=(const long double&);
+    BasicSimulationTime& operator*=(const double&);
+
+    /**
+      * \brief  Multiplication assignment operator by an integer, exact
+      * \throw  std::overflow_error if the product can not be stored, in which case the time is not changed
+      */
+    template <typename Integer>
+    constexpr typename std::enable_if<std::is_integral<Integer>::value, BasicSimulationTime&>::type operator*=(const Integer& op)
+    {
+        DataType product = 0;
+        if (__builtin_mul_overflow(_time, op, &product))
+            throw std::overflow_error("Time multiplied beyond its range.");
+        _time = product;
+        return *this;
+    }
 
     /**
       * \brief  Division assignment operator
+      *
+      * The quotient is computed on integers (the exact binary value of the divisor, with a 128 bits intermediate), and
+      * rounded to the nearest time tick, ties away from zero.
+      * \throw  std::invalid_argument if the divisor is null or not finite
       */
-    SimulationTime& operator/=(const long double&);
+    BasicSimulationTime& operator/=(const double&);
+
+    /**
+      * \brief  Division assignment operator by an integer, rounded to the nearest time tick, ties away from zero
+      * \throw  std::invalid_argument if the divisor is null
+      */
+    template <typename Integer>
+    constexpr typename std::enable_if<std::is_integral<Integer>::value, BasicSimulationTime&>::type operator/=(const Integer& op)
+    {
+        if (op == 0)
+            throw std::invalid_argument("Can not divide a time by 0.");
+        _time = roundedQuotient(_time, (DataType)op);
+        return *this;
+    }
 
     /**
       * \brief  Addition operator
       */
-    SimulationTime operator+(const SimulationTime&) const;
+    constexpr BasicSimulationTime operator+(const BasicSimulationTime& op) const
+    {
+        return fromTicks(_time + op._time);
+    }
 
     /**
       * \brief  Substraction operator
       */
-    SimulationTime operator-(const SimulationTime&) const;
+    constexpr BasicSimulationTime operator-(const BasicSimulationTime& op) const
+    {
+        return fromTicks(_time - op._time);
+    }
 
     /**
       * \brief  Multiplication operator
       */
-    SimulationTime operator*(const long double&) const;
+    BasicSimulationTime operator*(const double& op) const
+    {
+        BasicSimulationTime cpy(*this);
+        cpy.operator*=(op);
+        return cpy;
+    }
+
+    /**
+      * \brief  Multiplication operator by an integer
+      */
+    template <typename Integer>
+    constexpr typename std::enable_if<std::is_integral<Integer>::value, BasicSimulationTime>::type operator*(const Integer& op) const
+    {
+        BasicSimulationTime cpy(*this);
+        cpy.operator*=(op);
+        return cpy;
+    }
 
     /**
       * \brief  Division operator
       */
-    SimulationTime operator/(const long double&) const;
+    BasicSimulationTime operator/(const double& op) const
+    {
+        BasicSimulationTime cpy(*this);
+        cpy.operator/=(op);
+        return cpy;
+    }
 
-private:
-    typedef signed long long int DataType;
+    /**
+      * \brief  Division operator by an integer
+      */
+    template <typename Integer>
+    constexpr typename std::enable_if<std::is_integral<Integer>::value, BasicSimulationTime>::type operator/(const Integer& op) const
+    {
+        BasicSimulationTime cpy(*this);
+        cpy.operator/=(op);
+        return cpy;
+    }
 
-    static unsigned _timeDataLength, _timeDataPrecision;
+    /**
+      * \brief  Returns numerator / denominator rounded to the nearest integer, ties away from zero
+      */
+    static constexpr DataType roundedQuotient(const DataType numerator, const DataType denominator)
+    {
+        const unsigned __int128 n = numerator < 0 ? (unsigned __int128)0 - (unsigned __int128)numerator : (unsigned __int128)numerator;
+        const unsigned __int128 d = denominator < 0 ? (unsigned __int128)0 - (unsigned __int128)denominator : (unsigned __int128)denominator;
+        const unsigned __int128 remainder = n % d;
+        const unsigned __int128 quotient = n / d + (remainder >= d - remainder ? 1 : 0);
+        return (DataType)((numerator < 0) != (denominator < 0) ? (unsigned __int128)0 - quotient : quotient);
+    }
 
+    /**
+      * \brief  Returns the ticks of value units of 1/unitsPerSecond second, rounded to the nearest tick, ties away
+      *         from zero (the product by ticksPerSecond does not overflow before the division)
+      */
+    static constexpr DataType unitsTicks(const unsigned long long value, const unsigned long long unitsPerSecond)
+    {
+        return (DataType)(((unsigned __int128)value * (unsigned __int128)ticksPerSecond * 2 + unitsPerSecond) / ((unsigned __int128)unitsPerSecond * 2));
+    }
+
+private:
     DataType _time;
 };
 
+/**
+  * \brief  Simulation time with a resolution under the nanosecond
+  */
+typedef BasicSimulationTime<29> NanoSimulationTime;
+
+/**
+  * \brief  Simulation time with a resolution under the nanosecond, stored on 128 bits to never overflow
+  */
+typedef BasicSimulationTime<29, __int128> WideSimulationTime;
+
+/**
+  * \brief  Time of the simulator
+  */
+#ifdef SIMULATION_TIME_128BITS
+typedef WideSimulationTime SimulationTime;
+#else
+typedef BasicSimulationTime<> SimulationTime;
+#endif
+
+extern template class BasicSimulationTime<24>;
+extern template class BasicSimulationTime<29>;
+extern template class BasicSimulationTime<29, __int128>;
+
 /**
   * \brief Output stream writer
   */
-std::ostream& operator<<(std::ostream& ost, const SimulationTime& time);
+template <unsigned Precision, typename Storage>
+std::ostream& operator<<(std::ostream& ost, const BasicSimulationTime<Precision, Storage>& time)
+{
+    char buffer[BasicSimulationTime<Precision, Storage>::maxStringLength];
+    ost.write(buffer, time.toChars(buffer, buffer + sizeof(buffer)).ptr - buffer);
+
+    return ost;
+}
+
+// --------- Literals of simulation time: 5_s, 20_ms, 1.5_us, 100_ns
+constexpr SimulationTime operator"" _s(const unsigned long long value)
+{
+    return SimulationTime::fromTicks(SimulationTime::unitsTicks(value, 1));
+}
+
+constexpr SimulationTime operator"" _s(const long double value)
+{
+    return SimulationTime(value);
+}
+
+constexpr SimulationTime operator"" _ms(const unsigned long long value)
+{
+    return SimulationTime::fromTicks(SimulationTime::unitsTicks(value, 1000));
+}
+
+constexpr SimulationTime operator"" _ms(const long double value)
+{
+    return SimulationTime(value / 1000);
+}
+
+constexpr SimulationTime operator"" _us(const unsigned long long value)
+{
+    return SimulationTime::fromTicks(SimulationTime::unitsTicks(value, 1000000));
+}
+
+constexpr SimulationTime operator"" _us(const long double value)
+{
+    return SimulationTime(value / 1000000);
+}
+
+constexpr SimulationTime operator"" _ns(const unsigned long long value)
+{
+    return SimulationTime::fromTicks(SimulationTime::unitsTicks(value, 1000000000));
+}
+
+constexpr SimulationTime operator"" _ns(const long double value)
+{
+    return SimulationTime(value / 1000000000);
+}
 
 #endif // SIMULATIONTIME_H
@@ -0,0 +1,108 @@
+#include "TraceFile.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+const size_t TraceFile::prefetchWindowSize;
+
+TraceFile::TraceFile(const std::string& fileName)
+    : m_file(fileName)
+    , m_values(reinterpret_cast<const double*>(m_file.data()))
+    , m_size(m_file.size() / sizeof(double))
+    , m_statisticsComputed()
+    , m_sorted(false)
+    , m_mean(0)
+    , m_variance(0)
+    , m_minValue(0)
+    , m_maxValue(0)
+{
+    if (m_file.size() % sizeof(double) != 0) {
+        std::ostringstream exceptionStream;
+        exceptionStream << __PRETTY_FUNCTION__ << ": Trace file \"" << fileName << "\" is not an array of doubles.";
+        throw std::runtime_error(exceptionStream.str());
+    }
+    madvise(const_cast<char*>(m_file.data()), m_file.size(), MADV_SEQUENTIAL);
+}
+
+void TraceFile::prefetch(size_t index) const
+{
+    const size_t pageSize = sysconf(_SC_PAGESIZE);
+    const size_t windowLength = prefetchWindowSize * sizeof(double);
+    char* base = const_cast<char*>(m_file.data());
+    const size_t mappingLength = m_file.size();
+
+    // Windows are aligned on pages, as required by madvise
+    size_t begin = (index % m_size) * sizeof(double) / pageSize * pageSize;
+    size_t length = begin + windowLength < mappingLength ? windowLength : mappingLength - begin;
+    madvise(base + begin, length, MADV_WILLNEED);
+
+    // The window before index is being read, the one before it is not needed anymore
+    if (begin >= 2 * windowLength)
+        madvise(base + begin - 2 * windowLength, windowLength, MADV_DONTNEED);
+}
+
+void TraceFile::adviseRandomAccess() const
+{
+    madvise(const_cast<char*>(m_file.data()), m_file.size(), MADV_RANDOM);
+}
+
+bool TraceFile::isSorted() const
+{
+    computeStatistics();
+    return m_sorted;
+}
+
+double TraceFile::mean() const
+{
+    computeStatistics();
+    return m_mean;
+}
+
+double TraceFile::variance() const
+{
+    computeStatistics();
+    return m_variance;
+}
+
+double TraceFile::minValue() const
+{
+    computeStatistics();
+    return m_minValue;
+}
+
+double TraceFile::maxValue() const
+{
+    computeStatistics();
+    return m_maxValue;
+}
+
+void TraceFile::computeStatistics() const
+{
+    // Threads sharing the trace wait for the first one to compute the statistics
+    std::call_once(m_statisticsComputed, [this]() {
+        // Single pass, with Welford's update of the mean and variance
+        double mean = 0, squaresSum = 0;
+        m_sorted = true;
+        m_minValue = m_maxValue = m_values[0];
+        for (size_t i = 0; i < m_size; ++i) {
+            if (i % prefetchWindowSize == 0)
+                prefetch(i + prefetchWindowSize);
+
+            double x = m_values[i];
+            double delta = x - mean;
+            mean += delta / (i + 1);
+            squaresSum += delta * (x - mean);
+            if (x < m_minValue)
+                m_minValue = x;
+            if (x > m_maxValue)
+                m_maxValue = x;
+            if (i > 0 && x < m_values[i - 1])
+                m_sorted = false;
+        }
+        m_mean = mean;
+        m_variance = m_size > 1 ? squaresSum / (m_size - 1) : 0;
+    });
+}
@@ -0,0 +1,99 @@
+#ifndef TRACEFILE_H
+#define TRACEFILE_H
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+/**
+  * \brief  Read-only, memory mapped, file of empirical values (e.g. inter-arrival times or service times from logs).
+  *
+  * The file is a raw array of doubles, in the native byte order. It is mapped in memory (see MappedFile), not loaded:
+  * its pages are read by the system when values are accessed, so that traces much larger than the available memory can be used.
+  * When the values are read in order, prefetch() asks the system to read the next window of values ahead, and to drop
+  * the values already read.
+  */
+class TraceFile {
+public:
+    /**
+      * \brief  Number of values read ahead by prefetch() (4 MB)
+      */
+    static const size_t prefetchWindowSize = 1 << 19;
+
+    /**
+      * \brief  Constructor, maps the given file in memory
+      * \throw  std::runtime_error if the file can not be mapped, or is not an array of doubles
+      */
+    TraceFile(const std::string& fileName);
+
+    TraceFile(const TraceFile&) = delete;
+    TraceFile& operator=(const TraceFile&) = delete;
+
+    /**
+      * \brief  Returns the name of the mapped file
+      */
+    const std::string& fileName() const
+    {
+        return m_file.fileName();
+    }
+
+    /**
+      * \brief  Returns the number of values of the file
+      */
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    /**
+      * \brief  Returns the value at the given index
+      */
+    double value(size_t index) const
+    {
+        return m_values[index];
+    }
+
+    /**
+      * \brief  Returns the array of values of the file
+      */
+    const double* values() const
+    {
+        return m_values;
+    }
+
+    /**
+      * \brief  Asks the system to read the window of values starting at index, and to drop the windows before the
+      *         previous one (which is supposed to be read at the same time)
+      */
+    void prefetch(size_t index) const;
+
+    /**
+      * \brief  Asks the system to read ahead only the pages accessed, for random accesses to the values
+      */
+    void adviseRandomAccess() const;
+
+    // Characteristics of the values, computed by a single pass over the file, on the first call of any thread
+    bool isSorted() const;
+    double mean() const;
+    double variance() const;
+    double minValue() const;
+    double maxValue() const;
+
+private:
+    void computeStatistics() const;
+
+    MappedFile m_file;
+    const double* m_values;
+    size_t m_size;
+
+    mutable std::once_flag m_statisticsComputed;
+    mutable bool m_sorted;
+    mutable double m_mean;
+    mutable double m_variance;
+    mutable double m_minValue;
+    mutable double m_maxValue;
+};
+
+#endif // TRACEFILE_H
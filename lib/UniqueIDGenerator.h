@@ -1,11 +1,14 @@
 #ifndef UNIQUEIDGENERATOR_H
 #define UNIQUEIDGENERATOR_H
 
+#include <atomic>
+
 /**
   * \brief  Generator of unique Ids for simulation purpose.
   *
   * This class is a singleton, with a single instance for every different type name used with.
-  * Each time its method 'newId' is invoked, it creates a new, unqiue, ID for the specified type.
+  * Each time its method 'newId' is invoked, it creates a new, unqiue, ID for the specified type. Ids may be generated
+  * and reserved by several threads at once.
   */
 template <typename T>
 class UniqueIDGenerator {
@@ -35,6 +38,16 @@ public:
         return generatedNb;
     }
 
+    /**
+      * \brief  Reserves an Id given by other means, so that it is never generated afterwards
+      */
+    inline void reserve(const T id)
+    {
+        T currentNextId = nextId.load();
+        while (id >= currentNextId && !nextId.compare_exchange_weak(currentNextId, id + 1)) {
+        }
+    }
+
     /**
       * \brief  Resets the generator's generation process
       */
@@ -49,16 +62,14 @@ public:
       */
     inline static UniqueIDGenerator<T>* Generator()
     {
-        if (singleInstance == 0)
-            singleInstance = new UniqueIDGenerator<T>;
+        // Built once, even by concurrent first calls
+        static UniqueIDGenerator<T>* singleInstance = new UniqueIDGenerator<T>;
         return singleInstance;
     }
 
 private:
-    static UniqueIDGenerator<T>* singleInstance;
-
-    unsigned long generatedNb;
-    T nextId;
+    std::atomic<unsigned long> generatedNb;
+    std::atomic<T> nextId;
 
     // Constructor
     UniqueIDGenerator()
@@ -67,7 +78,4 @@ private:
     }
 };
 
-template <typename T>
-UniqueIDGenerator<T>* UniqueIDGenerator<T>::singleInstance = 0;
-
 #endif // UNIQUEIDGENERATOR_H
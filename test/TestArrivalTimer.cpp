@@ -0,0 +1,71 @@
+#include "ArrivalTimer.h"
+#include "Random.h"
+
+#include "catch2/catch.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+TEST_CASE("Arrival timers follow their rate profile", "[ArrivalTimer]")
+{
+    // Daily profile: nothing at night, a morning peak, a plateau and an evening decrease
+    const std::vector<double> times = { 0, 6 * 3600, 9 * 3600, 12 * 3600, 18 * 3600, 24 * 3600 };
+    const std::vector<double> rates = { 0, 0, 0.5, 0.2, 0.2, 0 };
+
+    ArrivalTimer timer("arrivals");
+    timer.setRateProfile(times, rates);
+
+    REQUIRE(timer.rate(3 * 3600) == 0);
+    REQUIRE(timer.rate(7.5 * 3600) == Approx(0.25));
+    REQUIRE(timer.rate(24 * 3600 + 7.5 * 3600) == Approx(0.25));
+    REQUIRE(timer.cumulativeRate(9 * 3600) == Approx(0.5 * 0.5 * 3 * 3600));
+    REQUIRE(timer.cumulativeRate(48 * 3600) == Approx(2 * timer.cumulativeRate(24 * 3600)));
+
+    const ArrivalTimer::GenerationMethod methods[] = { ArrivalTimer::CumulativeRateInversion, ArrivalTimer::Thinning };
+    for (ArrivalTimer::GenerationMethod method : methods) {
+        timer.setGenerationMethod(method);
+        Random generator(42);
+
+        // Two days of arrivals, counted per segment of the profile
+        std::vector<unsigned> counts(times.size() - 1, 0);
+        double previous = 0, t = timer.nextArrivalTime(0, &generator);
+        while (t < 2 * times.back()) {
+            REQUIRE(t >= previous);
+            double inPeriod = fmod(t, times.back());
+            REQUIRE(inPeriod >= 6 * 3600);
+            unsigned i = 0;
+            while (inPeriod >= times[i + 1])
+                ++i;
+            ++counts[i];
+            previous = t;
+            t = timer.nextArrivalTime(t, &generator);
+        }
+
+        for (unsigned i = 0; i < counts.size(); ++i) {
+            double expected = 2 * (timer.cumulativeRate(times[i + 1]) - timer.cumulativeRate(times[i]));
+            std::cout << "Method " << method << ", segment " << i << ": " << counts[i] << " arrivals, " << expected << " expected" << std::endl;
+            REQUIRE(fabs(counts[i] - expected) <= 5 * sqrt(expected) + 1e-9);
+        }
+    }
+
+    // A non periodic profile ending with a null rate has a last arrival
+    timer.setRateProfile({ 0, 10 }, { 1, 0 }, false);
+    Random generator(7);
+    for (ArrivalTimer::GenerationMethod method : methods) {
+        timer.setGenerationMethod(method);
+        double t = 0;
+        unsigned count = 0;
+        while ((t = timer.nextArrivalTime(t, &generator)) >= 0) {
+            REQUIRE(t <= 10);
+            ++count;
+        }
+        REQUIRE(count < 30);
+    }
+
+    REQUIRE_THROWS_AS(timer.setRateProfile({ 1, 2 }, { 1, 1 }), std::invalid_argument);
+    REQUIRE_THROWS_AS(timer.setRateProfile({ 0, 2, 2 }, { 1, 1, 1 }), std::invalid_argument);
+    REQUIRE_THROWS_AS(timer.setRateProfile({ 0, 2 }, { 1, -1 }), std::invalid_argument);
+    REQUIRE_THROWS_AS(timer.setRateProfile({ 0, 2 }, { 1 }), std::invalid_argument);
+    REQUIRE_THROWS_AS(ArrivalTimer().nextArrivalTime(0, &generator), std::runtime_error);
+}
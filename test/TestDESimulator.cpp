@@ -9,6 +9,122 @@
 
 #include <iostream>
 
+TEST_CASE("Modules find their next hop towards a destination", "[DESimulator]")
+{
+    // Line of queues from q[0] to q[3], with a slower shortcut from q[0] to q[3]
+    DESimulator::SimulationGraph* graph = new DESimulator::SimulationGraph();
+    std::vector<MyQueue*> q;
+    for (int i = 0; i < 4; i++) {
+        q.push_back(new MyQueue("Queue"));
+        graph->add(q[i], q[i]->id());
+    }
+    for (int i = 0; i < 3; i++)
+        graph->add(q[i], q[i + 1], 1);
+    graph->add(q[0], q[3], 5);
+
+    DESimulator* simulator = DESimulator::theSimulator();
+    simulator->initiateSimulator(graph);
+    simulator->computeRoutingTable();
+    REQUIRE(q[0]->nextHopTo(q[3]->id()) == q[3]->id());
+    REQUIRE(q[1]->nextHopTo(q[3]->id()) == q[2]->id());
+    REQUIRE(q[3]->nextHopTo(q[0]->id()) == invalidModuleId);
+    REQUIRE(q[3]->nextHopTo(q[3]->id()) == invalidModuleId);
+
+    simulator->computeRoutingTable(std::vector<ModuleId> { q[3]->id() }, [](const int& delay) { return delay; });
+    REQUIRE(simulator->getRoutingTable().destinationsNb() == 1);
+    REQUIRE(q[0]->nextHopTo(q[3]->id()) == q[1]->id());
+    REQUIRE(q[0]->nextHopTo(q[2]->id()) == invalidModuleId);
+    REQUIRE_THROWS_AS(simulator->computeRoutingTable(std::vector<ModuleId> { invalidModuleId }), std::invalid_argument);
+
+    simulator->cleanupSimulator();
+    REQUIRE(simulator->getRoutingTable().isEmpty());
+    for (MyQueue* queue : q)
+        delete queue;
+}
+
+TEST_CASE("Disconnected components are simulated in parallel", "[DESimulator]")
+{
+    // Three components of two tickers each
+    DESimulator::SimulationGraph* graph = new DESimulator::SimulationGraph();
+    std::vector<MyTicker*> t;
+    for (int i = 0; i < 6; i++) {
+        t.push_back(new MyTicker("Ticker"));
+        graph->add(t[i], t[i]->id());
+    }
+    for (int i = 0; i < 6; i += 2)
+        graph->add(t[i], t[i + 1]);
+
+    DESimulator* simulator = DESimulator::theSimulator();
+    simulator->initiateSimulator(graph);
+    REQUIRE(simulator->componentsNb() == 3);
+
+    // Each component has its own time, and draws the same values whatever the number of threads
+    std::vector<std::vector<double>> drawnValues;
+    for (unsigned threadsNb : { 2, 3 }) {
+        DESimulator::setComponentsThreadsNb(threadsNb);
+        simulator->simulate(10);
+        REQUIRE(DESimulator::simTime() == 10);
+        REQUIRE_FALSE(DESimulator::isCurrentlySimulating());
+        for (MyTicker* ticker : t) {
+            REQUIRE(ticker->nbTicks == 10);
+            REQUIRE(ticker->nbLateTicks == 0);
+            REQUIRE(ticker->terminationThread == std::this_thread::get_id());
+            drawnValues.push_back(ticker->drawnValues);
+        }
+    }
+    for (unsigned i = 0; i < t.size(); i++)
+        REQUIRE(drawnValues[i] == drawnValues[t.size() + i]);
+    REQUIRE(drawnValues[0] != drawnValues[2]);
+
+    DESimulator::setComponentsThreadsNb(1);
+    simulator->simulate(10);
+    for (MyTicker* ticker : t)
+        REQUIRE(ticker->nbTicks == 10);
+
+    simulator->cleanupSimulator();
+    REQUIRE(simulator->componentsNb() == 0);
+    for (MyTicker* ticker : t)
+        delete ticker;
+}
+
+TEST_CASE("Simulations give the same results with one or several threads", "[DESimulator]")
+{
+    // Two components of two tickers each, and a lone ticker
+    DESimulator::SimulationGraph* graph = new DESimulator::SimulationGraph();
+    std::vector<MyTicker*> t;
+    for (int i = 0; i < 5; i++) {
+        t.push_back(new MyTicker("Ticker"));
+        graph->add(t[i], t[i]->id());
+    }
+    graph->add(t[0], t[1]);
+    graph->add(t[2], t[3]);
+
+    DESimulator* simulator = DESimulator::theSimulator();
+    simulator->initiateSimulator(graph);
+    std::vector<std::vector<double>> drawnValues, inputValues;
+    for (unsigned threadsNb : { 1, 4 }) {
+        DESimulator::setComponentsThreadsNb(threadsNb);
+        simulator->simulate(20);
+        for (MyTicker* ticker : t) {
+            REQUIRE(ticker->nbTicks == 20);
+            drawnValues.push_back(ticker->drawnValues);
+            inputValues.push_back(ticker->inputValues);
+        }
+    }
+    DESimulator::setComponentsThreadsNb(1);
+    for (unsigned i = 0; i < t.size(); i++) {
+        REQUIRE(drawnValues[i] == drawnValues[t.size() + i]);
+        REQUIRE(inputValues[i] == inputValues[t.size() + i]);
+    }
+    // Inputs of the same name draw the same values in every module
+    REQUIRE(inputValues[0] == inputValues[4]);
+    REQUIRE(inputValues[0] != drawnValues[0]);
+
+    simulator->cleanupSimulator();
+    for (MyTicker* ticker : t)
+        delete ticker;
+}
+
 TEST_CASE("A Discrete Event Simulation can be defined and run", "[DESimulator]")
 {
     DESimulator::SimulationGraph mySimGraph;
@@ -240,7 +356,7 @@ void MyQueue::handleTimerTriggering(ModuleTimer* triggeredTimer)
     releaseParticle(particleToSend);
 
     // This module can have several outputs, choose randomly one of them to send the particle
-    unsigned choosenDestIndex = Random::Generate()->intuniform(0, neighbourDestinationForParticlesNb() - 1);
+    unsigned choosenDestIndex = chooseDestinationForParticlesIndex();
     std::cout << "Choosen index == " << choosenDestIndex << std::endl;
     particleToSend->send(neighbourDestinationForParticlesId(choosenDestIndex), DESimulator::simTime());
 
@@ -263,3 +379,36 @@ MyQueue::~MyQueue()
 {
     delete m_servingTimer;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////
+void MyTicker::getReady()
+{
+    nbTicks = 0;
+    nbLateTicks = 0;
+    drawnValues.clear();
+    inputValues.clear();
+    if (!m_tickingTimer)
+        m_tickingTimer = new ModuleTimer("Ticking Timer");
+    m_tickingTimer->scheduleAt(1);
+}
+
+void MyTicker::handleTimerTriggering(ModuleTimer*)
+{
+    ++nbTicks;
+    if (DESimulator::simTime() != nbTicks)
+        ++nbLateTicks;
+    drawnValues.push_back(Random::Generate()->uniform(0, 1));
+    inputValues.push_back(inputGenerator("ticks")->uniform(0, 1));
+    m_tickingTimer->scheduleAt(DESimulator::simTime() + 1);
+}
+
+void MyTicker::terminate()
+{
+    m_tickingTimer->cancelScheduling();
+    terminationThread = std::this_thread::get_id();
+}
+
+MyTicker::~MyTicker()
+{
+    delete m_tickingTimer;
+}
@@ -13,6 +13,7 @@
 
 #include <iostream>
 #include <queue>
+#include <thread>
 
 /**
   * \brief  Kinds of modules used in Discret Events simulator framework.
@@ -183,4 +184,56 @@ private:
     unsigned nbReceivedParticles;
 };
 
+////////////////////////////////////////////////////////////////////////////////////////////
+/**
+  * \brief  Module triggering its timer at each time unit, and drawing random values at each triggering.
+  */
+class MyTicker : public SimulationModule {
+public:
+    /**
+      * \brief  Default constructor
+      * \param  name    The ticker's name.
+      */
+    MyTicker(const std::string& name = std::string())
+        : SimulationModule(Generator, name)
+        , nbTicks(0)
+        , nbLateTicks(0)
+        , drawnValues()
+        , inputValues()
+        , terminationThread()
+        , m_tickingTimer(NULL)
+    {
+    }
+
+    /**
+      * \brief  Destructor
+      */
+    virtual ~MyTicker();
+
+    unsigned nbTicks;
+    unsigned nbLateTicks; ///< Triggerings at a simulation time other than the number of triggerings
+    std::vector<double> drawnValues;
+    std::vector<double> inputValues; ///< Values of the "ticks" input generator
+    std::thread::id terminationThread;
+
+protected:
+    /**
+      * \brief  Overloaded initialization method
+      */
+    virtual void getReady();
+
+    /**
+      * \brief  Overloaded method for handeling timers firing
+      */
+    virtual void handleTimerTriggering(ModuleTimer* triggeredTimer);
+
+    /**
+      * \brief  Overloaded termination method
+      */
+    virtual void terminate();
+
+private:
+    ModuleTimer* m_tickingTimer;
+};
+
 #endif // TEST_DESIMULATOR_H
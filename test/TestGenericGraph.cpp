@@ -1,9 +1,16 @@
 #include "GenericGraph.h"
+#include "GraphAlgorithms.h"
+#include "NextHopTable.h"
 #include "Random.h"
 
 #include "catch2/catch.hpp"
 
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <random>
+#include <set>
 
 // //#define DEBUG
 // //#define CHECK_BEFORE_INSERTION
@@ -205,4 +212,733 @@ TEST_CASE("Random GenericGraph can be created", "[GenericGraph]")
         std::cout << "done !" << std::endl;
     }
     std::cout << "done !" << std::endl;
-}
\ No newline at end of file
+}
+
+TEST_CASE("GenericGraph can be compiled into a CSR snapshot", "[GenericGraph]")
+{
+    GenericGraph<int, Edge> graph;
+    GenericGraph<int, Edge>::VertexID ids[6];
+    for (int i = 0; i < 6; i++)
+        ids[i] = graph.add(10 * i);
+    for (int i = 0; i < 6; i++)
+        for (int j = 0; j < 6; j++)
+            if (i != j && (i + 2 * j) % 3 == 0)
+                graph.add(ids[i], ids[j], Edge { 100 * i + j });
+
+    CompiledGraph<int, Edge> compiledGraph = graph.compile();
+    REQUIRE(compiledGraph.verticesNb() == graph.verticesNb());
+    REQUIRE(compiledGraph.arcsNb() == graph.arcsNb());
+
+    for (int i = 0; i < 6; i++) {
+        CompiledGraph<int, Edge>::VertexIndex index = compiledGraph.index(ids[i]);
+        REQUIRE(index != CompiledGraph<int, Edge>::IllegalVertexIndex);
+        REQUIRE(compiledGraph.vertexId(index) == ids[i]);
+        REQUIRE(compiledGraph.vertex(index) == 10 * i);
+
+        GenericGraph<int, Edge>::VertexIDSet successors, predecessors;
+        for (unsigned long successor : compiledGraph.successors(index)) {
+            successors.insert(compiledGraph.vertexId(successor));
+            CompiledGraph<int, Edge>::ArcIndex arcIndex = compiledGraph.arcIndex(index, successor);
+            REQUIRE(compiledGraph.arcHead(arcIndex) == successor);
+            REQUIRE(compiledGraph.arc(arcIndex).cost == graph.vertex(compiledGraph.vertexId(successor)) / 10 + 100 * i);
+        }
+        CompiledGraph<int, Edge>::IndexRange predecessorArcs = compiledGraph.predecessorArcs(index);
+        for (unsigned long position = 0; position < predecessorArcs.size(); position++) {
+            unsigned long predecessor = compiledGraph.predecessors(index)[position];
+            predecessors.insert(compiledGraph.vertexId(predecessor));
+            REQUIRE(predecessorArcs[position] == compiledGraph.arcIndex(predecessor, index));
+        }
+        REQUIRE(successors == graph.successors(ids[i]));
+        REQUIRE(predecessors == graph.predecessors(ids[i]));
+        REQUIRE(compiledGraph.successorsNb(index) == graph.successorsNb(ids[i]));
+        REQUIRE(compiledGraph.predecessorsNb(index) == graph.predecessorsNb(ids[i]));
+    }
+    REQUIRE(compiledGraph.arcIndex(0, 0) == CompiledGraph<int, Edge>::IllegalArcIndex);
+
+    // Ids with gaps are found by binary search
+    graph.remove(ids[2]);
+    compiledGraph = graph.compile();
+    REQUIRE(compiledGraph.verticesNb() == 5);
+    REQUIRE(compiledGraph.arcsNb() == graph.arcsNb());
+    REQUIRE(compiledGraph.index(ids[2]) == CompiledGraph<int, Edge>::IllegalVertexIndex);
+    REQUIRE(compiledGraph.vertex(compiledGraph.index(ids[3])) == 30);
+    REQUIRE(compiledGraph.index(ids[5] + 1) == CompiledGraph<int, Edge>::IllegalVertexIndex);
+
+    std::vector<unsigned long> vertexIds = { 1, 2 }, successorsOffsets = { 0, 1, 1 }, successors = { 2 };
+    std::vector<int> vertices = { 1, 2 };
+    std::vector<Edge> arcs = { Edge { 0 } };
+    CompiledGraph<int, Edge> invalidGraph;
+    REQUIRE_THROWS_AS(invalidGraph.assign(vertexIds, vertices, successorsOffsets, successors, arcs), std::invalid_argument);
+
+    compiledGraph.clear();
+    REQUIRE(compiledGraph.isEmpty());
+    REQUIRE(compiledGraph.index(0) == CompiledGraph<int, Edge>::IllegalVertexIndex);
+}
+
+TEST_CASE("GenericGraph can be saved in a binary file used in place", "[GenericGraph]")
+{
+    const char* fileName = "TestGenericGraph.bin";
+    GenericGraph<int, Edge> graph;
+    std::vector<GenericGraph<int, Edge>::VertexID> ids;
+    for (int i = 0; i < 100; i++)
+        ids.push_back(graph.add(i * i));
+    for (int i = 0; i < 100; i++)
+        for (int j = 1; j <= i % 4; j++)
+            graph.add(ids[i], ids[(i * 13 + j) % 100], Edge { i * 1000 + j });
+    graph.remove(ids[50]);
+    REQUIRE(graph.saveBinary(fileName));
+
+    CompiledGraph<int, Edge> compiledGraph = graph.compile(), mappedGraph;
+    mappedGraph.map(fileName);
+    REQUIRE(mappedGraph.isMapped());
+    REQUIRE(mappedGraph.verticesNb() == compiledGraph.verticesNb());
+    REQUIRE(mappedGraph.arcsNb() == compiledGraph.arcsNb());
+    for (unsigned long index = 0; index < compiledGraph.verticesNb(); index++) {
+        REQUIRE(mappedGraph.vertexId(index) == compiledGraph.vertexId(index));
+        REQUIRE(mappedGraph.index(compiledGraph.vertexId(index)) == index);
+        REQUIRE(mappedGraph.vertex(index) == compiledGraph.vertex(index));
+        REQUIRE(std::vector<unsigned long>(mappedGraph.successors(index).begin(), mappedGraph.successors(index).end())
+            == std::vector<unsigned long>(compiledGraph.successors(index).begin(), compiledGraph.successors(index).end()));
+        REQUIRE(std::vector<unsigned long>(mappedGraph.predecessorArcs(index).begin(), mappedGraph.predecessorArcs(index).end())
+            == std::vector<unsigned long>(compiledGraph.predecessorArcs(index).begin(), compiledGraph.predecessorArcs(index).end()));
+        for (unsigned long successor : mappedGraph.successors(index))
+            REQUIRE(mappedGraph.arc(mappedGraph.arcIndex(index, successor)).cost == compiledGraph.arc(compiledGraph.arcIndex(index, successor)).cost);
+    }
+    REQUIRE(mappedGraph.index(ids[50]) == CompiledGraph<int, Edge>::IllegalVertexIndex);
+
+    // Copies share the mapping, and stay valid after the snapshot is cleared
+    CompiledGraph<int, Edge> copiedGraph = mappedGraph;
+    mappedGraph.clear();
+    REQUIRE(!mappedGraph.isMapped());
+    REQUIRE(copiedGraph.isMapped());
+    REQUIRE(copiedGraph.vertex(copiedGraph.index(ids[99])) == 99 * 99);
+
+    // Files of other types, or truncated, are refused
+    CompiledGraph<int, double> otherGraph;
+    REQUIRE_THROWS_AS(otherGraph.map(fileName), std::runtime_error);
+    {
+        std::ofstream truncatedFile(fileName, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+        truncatedFile << "DESGRAPH";
+    }
+    REQUIRE_THROWS_AS(mappedGraph.map(fileName), std::runtime_error);
+    REQUIRE(mappedGraph.isEmpty());
+    std::remove(fileName);
+    REQUIRE_THROWS_AS(mappedGraph.map(fileName), std::runtime_error);
+
+    // Empty graphs are saved too
+    GenericGraph<int, Edge> emptyGraph;
+    REQUIRE(emptyGraph.saveBinary(fileName));
+    copiedGraph.map(fileName);
+    REQUIRE(copiedGraph.isEmpty());
+    std::remove(fileName);
+}
+
+TEST_CASE("Shortest paths and next hops are found in GenericGraph", "[GenericGraph]")
+{
+    // Grid of 8x8 vertices, with arcs to the right and down of random costs, and expensive shortcuts
+    const int side = 8;
+    GenericGraph<int, Edge> graph;
+    std::vector<GenericGraph<int, Edge>::VertexID> ids;
+    for (int i = 0; i < side * side; i++)
+        ids.push_back(graph.add(i));
+    for (int i = 0; i < side * side; i++) {
+        if (i % side < side - 1)
+            graph.add(ids[i], ids[i + 1], Edge { 1 + (i * 7) % 5 });
+        if (i / side < side - 1)
+            graph.add(ids[i], ids[i + side], Edge { 1 + (i * 11) % 5 });
+    }
+    graph.add(ids[0], ids[side * side - 1], Edge { 1000 });
+    GenericGraph<int, Edge>::ArcWeight cost = [](const Edge& edge) { return edge.cost; };
+
+    // Fewest arcs, and lowest cost
+    GenericGraph<int, Edge>::VertexIDPath path = graph.shortestPath(ids[0], ids[side * side - 1]);
+    REQUIRE(path == GenericGraph<int, Edge>::VertexIDPath { ids[0], ids[side * side - 1] });
+    path = graph.shortestPath(0, side * side - 1, cost);
+    REQUIRE(path.size() == 2 * side - 1);
+    REQUIRE(path.front() == ids[0]);
+    REQUIRE(path.back() == ids[side * side - 1]);
+    for (unsigned i = 1; i < path.size(); i++)
+        REQUIRE(graph.exists(path[i - 1], path[i]));
+    REQUIRE(graph.shortestPath(ids[side * side - 1], ids[0]).empty());
+    REQUIRE_THROWS_AS(graph.shortestPath(ids[0], ids[side * side - 1] + 1), std::invalid_argument);
+
+    // Dijkstra, and A* with the Manhattan distance (every arc costs at least 1), find the same distances
+    CompiledGraph<int, Edge> compiledGraph = graph.compile();
+    PathFinder<int, Edge> dijkstra(compiledGraph, cost), aStar(compiledGraph, cost);
+    std::vector<unsigned long> dijkstraPath, aStarPath;
+    for (unsigned long source = 0; source < compiledGraph.verticesNb(); source += 5)
+        for (unsigned long destination = 0; destination < compiledGraph.verticesNb(); destination += 3) {
+            int target = compiledGraph.vertex(destination);
+            PathFinder<int, Edge>::Heuristic manhattan = [&compiledGraph, target](unsigned long vertex) {
+                int position = compiledGraph.vertex(vertex);
+                return std::abs(target % side - position % side) + std::abs(target / side - position / side);
+            };
+            bool found = dijkstra.shortestPath(source, destination, dijkstraPath);
+            REQUIRE(aStar.shortestPath(source, destination, aStarPath, manhattan) == found);
+            if (found)
+                REQUIRE(aStar.distance(destination) == dijkstra.distance(destination));
+            else
+                REQUIRE(dijkstraPath.empty());
+        }
+
+    // Following the next hops gives the shortest distances
+    NextHopTable<int, Edge> table(compiledGraph, cost);
+    REQUIRE(table.destinationsNb() == compiledGraph.verticesNb());
+    for (unsigned long destination = 0; destination < compiledGraph.verticesNb(); destination++) {
+        for (unsigned long source = 0; source < compiledGraph.verticesNb(); source++) {
+            dijkstra.shortestPath(source, destination, dijkstraPath);
+            double distance = 0;
+            unsigned long vertex = source;
+            while (table.nextHop(vertex, destination) != CompiledGraph<int, Edge>::IllegalVertexIndex) {
+                unsigned long hop = table.nextHop(vertex, destination);
+                distance += compiledGraph.arc(compiledGraph.arcIndex(vertex, hop)).cost;
+                vertex = hop;
+            }
+            REQUIRE(vertex == (dijkstraPath.empty() ? source : destination));
+            REQUIRE(distance == (dijkstraPath.empty() ? 0 : dijkstra.distance(destination)));
+        }
+    }
+
+    NextHopTable<int, Edge> depotsTable(compiledGraph, std::vector<unsigned long> { 9, 9, 63 });
+    REQUIRE(depotsTable.destinationsNb() == 2);
+    REQUIRE(depotsTable.isDestination(63));
+    REQUIRE(depotsTable.nextHop(0, 63) == 63);
+    REQUIRE(depotsTable.nextHop(0, 9) != CompiledGraph<int, Edge>::IllegalVertexIndex);
+    REQUIRE(depotsTable.nextHop(0, 10) == CompiledGraph<int, Edge>::IllegalVertexIndex);
+    depotsTable.clear();
+    REQUIRE(depotsTable.isEmpty());
+
+    PathFinder<int, Edge> negativeFinder(compiledGraph, [](const Edge&) { return -1.0; });
+    REQUIRE_THROWS_AS(negativeFinder.shortestPath(0, 1, dijkstraPath), std::invalid_argument);
+    REQUIRE_THROWS_AS(dijkstra.shortestPath(0, compiledGraph.verticesNb(), dijkstraPath), std::invalid_argument);
+}
+
+namespace {
+/**
+  * \brief  Builds a snapshot of random arcs, sorted by tail and head
+  */
+CompiledGraph<int, Edge> randomCompiledGraph(unsigned long verticesNb, unsigned long arcsNb, unsigned long seed)
+{
+    std::vector<std::pair<unsigned long, unsigned long>> arcIds;
+    for (unsigned long i = 0; i < arcsNb; i++) {
+        seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+        arcIds.push_back(std::make_pair((seed >> 33) % verticesNb, (seed >> 13) % verticesNb));
+    }
+    std::sort(arcIds.begin(), arcIds.end());
+    arcIds.erase(std::unique(arcIds.begin(), arcIds.end()), arcIds.end());
+
+    std::vector<unsigned long> vertexIds, successorsOffsets(verticesNb + 1, 0), successors;
+    std::vector<int> vertices;
+    std::vector<Edge> arcs;
+    for (unsigned long i = 0; i < verticesNb; i++) {
+        vertexIds.push_back(i + 1);
+        vertices.push_back((int)i);
+    }
+    for (const std::pair<unsigned long, unsigned long>& arcId : arcIds) {
+        ++successorsOffsets[arcId.first + 1];
+        successors.push_back(arcId.second);
+        arcs.push_back(Edge { (int)(arcId.first + arcId.second) % 7 + 1 });
+    }
+    for (unsigned long i = 0; i < verticesNb; i++)
+        successorsOffsets[i + 1] += successorsOffsets[i];
+    CompiledGraph<int, Edge> graph;
+    graph.assign(vertexIds, vertices, successorsOffsets, successors, arcs);
+    return graph;
+}
+}
+
+TEST_CASE("Parallel graph algorithms give the results of sequential ones", "[GenericGraph]")
+{
+    // Large enough for frontiers to be expanded by several threads
+    CompiledGraph<int, Edge> graph = randomCompiledGraph(30000, 100000, 1);
+    std::vector<unsigned long> distances, parallelDistances, parents, parallelParents;
+    GraphAlgorithms<int, Edge>::breadthFirstSearch(graph, 0, distances, parents, 1);
+    GraphAlgorithms<int, Edge>::breadthFirstSearch(graph, 0, parallelDistances, parallelParents, 4);
+    REQUIRE(parallelDistances == distances);
+    PathFinder<int, Edge> pathFinder(graph);
+    std::vector<unsigned long> path;
+    unsigned long reachedNb = 0;
+    for (unsigned long vertex = 0; vertex < graph.verticesNb(); vertex++) {
+        if (distances[vertex] == GraphAlgorithms<int, Edge>::Unreached) {
+            REQUIRE(parallelParents[vertex] == CompiledGraph<int, Edge>::IllegalVertexIndex);
+            continue;
+        }
+        ++reachedNb;
+        if (vertex > 0) {
+            REQUIRE(distances[parallelParents[vertex]] + 1 == distances[vertex]);
+            REQUIRE(graph.arcIndex(parallelParents[vertex], vertex) != CompiledGraph<int, Edge>::IllegalArcIndex);
+        }
+        if (vertex % 100 == 0) {
+            REQUIRE(pathFinder.shortestPath(0, vertex, path));
+            REQUIRE(path.size() == distances[vertex] + 1);
+        }
+    }
+    REQUIRE(reachedNb > GraphAlgorithms<int, Edge>::parallelFrontierSize);
+
+    std::vector<unsigned long> components, parallelComponents;
+    unsigned long componentsNb = GraphAlgorithms<int, Edge>::stronglyConnectedComponents(graph, components, 1);
+    REQUIRE(GraphAlgorithms<int, Edge>::stronglyConnectedComponents(graph, parallelComponents, 4) == componentsNb);
+    REQUIRE(parallelComponents == components);
+    REQUIRE(*std::max_element(components.begin(), components.end()) == componentsNb - 1);
+
+    // Components checked against the reachability of each pair of vertices
+    CompiledGraph<int, Edge> smallGraph = randomCompiledGraph(200, 260, 2);
+    componentsNb = GraphAlgorithms<int, Edge>::stronglyConnectedComponents(smallGraph, components, 3);
+    REQUIRE(componentsNb > 1);
+    REQUIRE(componentsNb < smallGraph.verticesNb());
+    std::vector<std::vector<unsigned long>> reachDistances(smallGraph.verticesNb());
+    for (unsigned long vertex = 0; vertex < smallGraph.verticesNb(); vertex++)
+        GraphAlgorithms<int, Edge>::breadthFirstSearch(smallGraph, vertex, reachDistances[vertex], parents, 2);
+    for (unsigned long vertex1 = 0; vertex1 < smallGraph.verticesNb(); vertex1++)
+        for (unsigned long vertex2 = 0; vertex2 < smallGraph.verticesNb(); vertex2++) {
+            bool stronglyConnected = reachDistances[vertex1][vertex2] != GraphAlgorithms<int, Edge>::Unreached
+                && reachDistances[vertex2][vertex1] != GraphAlgorithms<int, Edge>::Unreached;
+            REQUIRE((components[vertex1] == components[vertex2]) == stronglyConnected);
+        }
+
+    // Next hops computed by several threads
+    NextHopTable<int, Edge>::ArcWeight cost = [](const Edge& edge) { return edge.cost; };
+    NextHopTable<int, Edge> table(smallGraph, cost, 1), parallelTable(smallGraph, cost, 4);
+    for (unsigned long vertex = 0; vertex < smallGraph.verticesNb(); vertex++)
+        for (unsigned long destination = 0; destination < smallGraph.verticesNb(); destination++)
+            REQUIRE(parallelTable.nextHop(vertex, destination) == table.nextHop(vertex, destination));
+    NextHopTable<int, Edge>::ArcWeight negativeCost = [](const Edge&) { return -1.0; };
+    REQUIRE_THROWS_AS((NextHopTable<int, Edge>(smallGraph, negativeCost, 4)), std::invalid_argument);
+    REQUIRE_THROWS_AS((GraphAlgorithms<int, Edge>::breadthFirstSearch(smallGraph, 200, distances, parents)), std::invalid_argument);
+}
+
+TEST_CASE("GenericGraph neighbours can be iterated without copy", "[GenericGraph]")
+{
+    GenericGraph<int, Edge> graph;
+    GenericGraph<int, Edge>::VertexID ids[5];
+    for (int i = 0; i < 5; i++)
+        ids[i] = graph.add(i);
+    for (int i = 0; i < 5; i++)
+        for (int j = i + 1; j < 5; j += i + 1)
+            graph.add(ids[i], ids[j], Edge { i + j });
+
+    GenericGraph<int, Edge>::VertexIDSet vertices(graph.verticesRange().begin(), graph.verticesRange().end());
+    REQUIRE(vertices == graph.vertices());
+    REQUIRE(graph.verticesRange().size() == graph.verticesNb());
+
+    for (GenericGraph<int, Edge>::VertexID id : graph.verticesRange()) {
+        GenericGraph<int, Edge>::SuccessorIDRange successorsRange = graph.successorsRange(id);
+        GenericGraph<int, Edge>::PredecessorIDRange predecessorsRange = graph.predecessorsRange(id);
+        GenericGraph<int, Edge>::ArcIDRange arcsRange = graph.arcsRange(id);
+        REQUIRE(GenericGraph<int, Edge>::VertexIDSet(successorsRange.begin(), successorsRange.end()) == graph.successors(id));
+        REQUIRE(GenericGraph<int, Edge>::VertexIDSet(predecessorsRange.begin(), predecessorsRange.end()) == graph.predecessors(id));
+        REQUIRE(GenericGraph<int, Edge>::ArcIDSet(arcsRange.begin(), arcsRange.end()) == graph.arcs(id));
+
+        REQUIRE(successorsRange.size() == graph.successors(id).size());
+        REQUIRE(graph.successorsNb(id) == graph.successors(id).size());
+        REQUIRE(graph.successorsNb(graph.vertex(id)) == graph.successors(id).size());
+        REQUIRE(graph.predecessorsNb(id) == graph.predecessors(id).size());
+        REQUIRE(graph.predecessorsNb(graph.vertex(id)) == graph.predecessors(id).size());
+        REQUIRE(graph.arcsNb(id) == graph.arcs(id).size());
+        REQUIRE(arcsRange.empty() == graph.arcs(id).empty());
+    }
+
+    GenericGraph<int, Edge>::VertexID missingId = ids[4] + 1;
+    REQUIRE(graph.successorsRange(missingId).empty());
+    REQUIRE(graph.successorsRange(missingId).begin() == graph.successorsRange(missingId).end());
+    REQUIRE(graph.predecessorsRange(missingId).empty());
+    REQUIRE(graph.arcsRange(missingId).empty());
+    REQUIRE(graph.successorsNb(missingId) == 0);
+    REQUIRE(graph.predecessorsNb(42) == 0);
+
+    // Copies keep the vertices, the arcs and their data
+    graph.add(5);
+    GenericGraph<int, Edge> copy(graph);
+    REQUIRE(copy.vertices() == graph.vertices());
+    REQUIRE(copy.arcsNb() == graph.arcsNb());
+    for (GenericGraph<int, Edge>::ArcID arcId : copy.arcsRange(copy.vertex(0)))
+        REQUIRE(copy.arc(arcId).cost == copy.vertex(arcId.second));
+}
+
+template <class Graph>
+std::vector<std::string> buildAndEditGraph(Graph& graph)
+{
+    std::vector<std::string> log;
+    std::vector<typename Graph::VertexID> ids;
+    for (int i = 0; i < 200; i++)
+        ids.push_back(graph.add(i * 7));
+    for (int i = 0; i < 200; i++)
+        for (int j = 1; j < 4; j++)
+            graph.add(i * 7, ((i * j + 3) % 200) * 7, Edge { i + j });
+
+    for (int i = 0; i < 200; i += 3)
+        graph.remove(ids[i]);
+    for (int i = 1; i < 200; i += 5)
+        graph.setVertex(ids[i], -i);
+    graph.add(ids[4], ids[8], Edge { 48 }, true);
+
+    for (typename Graph::VertexID id : graph.verticesRange()) {
+        std::ostringstream line;
+        line << id - ids[0] << ":" << graph.vertex(id) << ":" << graph.vertex(graph.vertex(id)) - ids[0] << ":";
+        for (typename Graph::VertexID successor : graph.successorsRange(id))
+            line << " " << successor - ids[0] << "(" << graph.arc(typename Graph::ArcID(id, successor)).cost << ")";
+        line << " |";
+        for (typename Graph::VertexID predecessor : graph.predecessorsRange(id))
+            line << " " << predecessor - ids[0];
+        log.push_back(line.str());
+    }
+    return log;
+}
+
+TEST_CASE("GenericGraph storages have the same behaviour", "[GenericGraph]")
+{
+    GenericGraph<int, Edge> orderedGraph;
+    GenericGraph<int, Edge, true, std::less<int>, HashedGraphStorage<>> hashedGraph;
+    std::vector<std::string> orderedLog = buildAndEditGraph(orderedGraph);
+    std::vector<std::string> hashedLog = buildAndEditGraph(hashedGraph);
+
+    REQUIRE(orderedLog.size() == 133);
+    REQUIRE(hashedLog == orderedLog);
+    REQUIRE(hashedGraph.verticesNb() == orderedGraph.verticesNb());
+    REQUIRE(hashedGraph.arcsNb() == orderedGraph.arcsNb());
+    REQUIRE(hashedGraph.exists(14));
+    REQUIRE(!hashedGraph.exists(0));
+    REQUIRE(!hashedGraph.exists(1));
+    REQUIRE(hashedGraph.vertex(hashedGraph.vertex(-1)) == -1);
+    REQUIRE(hashedGraph.vertex(7) == orderedGraph.IllegalVertexID);
+
+    GenericGraph<int, Edge, true, std::less<int>, HashedGraphStorage<>> hashedCopy(hashedGraph);
+    CompiledGraph<int, Edge> orderedSnapshot = orderedGraph.compile(), hashedSnapshot = hashedCopy.compile();
+    REQUIRE(hashedSnapshot.verticesNb() == orderedSnapshot.verticesNb());
+    REQUIRE(hashedSnapshot.arcsNb() == orderedSnapshot.arcsNb());
+    for (unsigned long i = 0; i < hashedSnapshot.verticesNb(); i++) {
+        REQUIRE(hashedSnapshot.vertex(i) == orderedSnapshot.vertex(i));
+        REQUIRE(hashedSnapshot.successorsNb(i) == orderedSnapshot.successorsNb(i));
+    }
+
+    hashedGraph.clear();
+    REQUIRE(hashedGraph.isEmpty());
+    REQUIRE(hashedGraph.verticesRange().begin() == hashedGraph.verticesRange().end());
+}
+
+TEST_CASE("GenericGraph is built in bulk", "[GenericGraph]")
+{
+    typedef GenericGraph<int, Edge> Graph;
+    typedef Graph::VertexID VertexID;
+
+    // The same graph, added arc by arc, and given in bulk in disorder
+    Graph addedGraph;
+    std::vector<Graph::VertexEntry> vertices;
+    std::vector<Graph::ArcEntry> arcs;
+    for (int i = 0; i < 100; i++) {
+        VertexID vertexId = 1000 - i;
+        addedGraph.add(i * 3, vertexId);
+        vertices.push_back(Graph::VertexEntry(vertexId, i * 3));
+    }
+    for (int i = 0; i < 100; i++)
+        for (int j = 1; j < 4; j++) {
+            VertexID tailId = 1000 - i, headId = 1000 - (i + j * 17) % 100;
+            addedGraph.add(tailId, headId, Edge { i + j });
+            arcs.push_back(Graph::ArcEntry { tailId, headId, Edge { i + j } });
+        }
+    std::reverse(vertices.begin(), vertices.end());
+    std::reverse(arcs.begin(), arcs.end());
+    arcs.push_back(Graph::ArcEntry { 1000, 983, Edge { -1 } });
+
+    typedef GenericGraph<int, Edge, true, std::less<int>, HashedGraphStorage<>> HashedGraph;
+    HashedGraph hashedGraph;
+    std::vector<HashedGraph::VertexEntry> hashedVertices(vertices);
+    std::vector<HashedGraph::ArcEntry> hashedArcs;
+    for (const Graph::ArcEntry& arc : arcs)
+        hashedArcs.push_back(HashedGraph::ArcEntry { arc.tailId, arc.headId, arc.arc });
+    hashedGraph.build(hashedVertices, hashedArcs);
+    Graph builtGraph;
+    builtGraph.add(5);
+    builtGraph.build(vertices, arcs);
+    REQUIRE(builtGraph.verticesNb() == 100);
+    REQUIRE(builtGraph.arcsNb() == 300);
+    REQUIRE(builtGraph.vertex(297) == 901);
+    REQUIRE(hashedGraph.vertex(297) == 901);
+    REQUIRE(builtGraph.vertex(5) == Graph::IllegalVertexID);
+    REQUIRE(builtGraph.arc(Graph::ArcID(1000, 983)).cost == 1);
+
+    CompiledGraph<int, Edge> addedSnapshot = addedGraph.compile();
+    for (const CompiledGraph<int, Edge>& snapshot : { builtGraph.compile(), hashedGraph.compile() }) {
+        REQUIRE(snapshot.verticesNb() == addedSnapshot.verticesNb());
+        REQUIRE(snapshot.arcsNb() == addedSnapshot.arcsNb());
+        for (unsigned long i = 0; i < snapshot.verticesNb(); i++) {
+            REQUIRE(snapshot.vertexId(i) == addedSnapshot.vertexId(i));
+            REQUIRE(snapshot.vertex(i) == addedSnapshot.vertex(i));
+            REQUIRE(std::vector<unsigned long>(snapshot.successors(i).begin(), snapshot.successors(i).end())
+                == std::vector<unsigned long>(addedSnapshot.successors(i).begin(), addedSnapshot.successors(i).end()));
+            REQUIRE(std::vector<unsigned long>(snapshot.predecessors(i).begin(), snapshot.predecessors(i).end())
+                == std::vector<unsigned long>(addedSnapshot.predecessors(i).begin(), addedSnapshot.predecessors(i).end()));
+        }
+        for (unsigned long i = 0; i < snapshot.arcsNb(); i++)
+            REQUIRE(snapshot.arc(i).cost == addedSnapshot.arc(i).cost);
+    }
+
+    // Wrong arrays leave the graph unchanged
+    std::vector<Graph::VertexEntry> wrongVertices { { 1, 10 }, { 2, 20 } };
+    std::vector<Graph::ArcEntry> wrongArcs { { 1, 3, Edge { 0 } } };
+    REQUIRE_THROWS_AS(builtGraph.build(wrongVertices, wrongArcs), std::invalid_argument);
+    wrongVertices = { { 1, 10 }, { 1, 20 } };
+    wrongArcs.clear();
+    REQUIRE_THROWS_AS(builtGraph.build(wrongVertices, wrongArcs), std::invalid_argument);
+    wrongVertices = { { 1, 10 }, { 2, 10 } };
+    REQUIRE_THROWS_AS(builtGraph.build(wrongVertices, wrongArcs), std::invalid_argument);
+    REQUIRE(builtGraph.arcsNb() == 300);
+
+    // Edge lists
+    Graph::EdgeListVertexLoader vertexLoader = [](const VertexID vertexId) { return (int)vertexId * 10; };
+    Graph::EdgeListArcLoader arcLoader = [](const VertexID, const VertexID, const std::string& data) {
+        return Edge { data.empty() ? 1 : std::stoi(data) };
+    };
+    std::istringstream edgeList("# tail head cost\n1 2 5\n\n  2 3 7\r\n3\t1\n");
+    Graph listGraph;
+    REQUIRE(listGraph.loadEdgeList(edgeList, vertexLoader, arcLoader));
+    REQUIRE(listGraph.verticesNb() == 3);
+    REQUIRE(listGraph.arcsNb() == 3);
+    REQUIRE(listGraph.vertex((VertexID)2) == 20);
+    REQUIRE(listGraph.arc(Graph::ArcID(1, 2)).cost == 5);
+    REQUIRE(listGraph.arc(Graph::ArcID(2, 3)).cost == 7);
+    REQUIRE(listGraph.arc(Graph::ArcID(3, 1)).cost == 1);
+
+    std::string errorMessage;
+    std::istringstream wrongEdgeList("1 2\n3 x\n");
+    REQUIRE(!listGraph.loadEdgeList(wrongEdgeList, vertexLoader, arcLoader, &errorMessage));
+    REQUIRE(errorMessage.find("Line 2") == 0);
+    REQUIRE(listGraph.arcsNb() == 3);
+    REQUIRE(!listGraph.loadEdgeList("TestGenericGraphMissing.txt", vertexLoader, arcLoader, &errorMessage));
+
+    // Vertices built are released when the graph can not be built
+    unsigned releasedNb = 0;
+    Graph::VertexReleaser releaser = [&releasedNb](const int&) {
+        releasedNb++;
+    };
+    Graph::EdgeListVertexLoader sameVertexLoader = [](const VertexID) { return 0; };
+    std::istringstream equivalentVertices("1 2\n2 3\n");
+    REQUIRE(!listGraph.loadEdgeList(equivalentVertices, sameVertexLoader, arcLoader, &errorMessage, releaser));
+    REQUIRE(releasedNb == 3);
+    REQUIRE(listGraph.arcsNb() == 3);
+}
+
+template <class Graph>
+void checkCopiesSharing()
+{
+    typedef typename Graph::VertexID VertexID;
+    typedef typename Graph::ArcID ArcID;
+
+    Graph graph;
+    for (VertexID vertexId = 1; vertexId <= 20; vertexId++)
+        graph.add((int)vertexId * 10, vertexId);
+    for (VertexID vertexId = 1; vertexId <= 20; vertexId++)
+        graph.add(vertexId, vertexId % 20 + 1, Edge { (int)vertexId });
+    graph.add((VertexID)5, (VertexID)5, Edge { 0 });
+    REQUIRE(graph.arcsNb() == 21);
+
+    // Each copy changes, leaving the others unchanged
+    Graph arcsCopy(graph), verticesCopy(graph), loopCopy;
+    loopCopy = graph;
+    arcsCopy.remove((VertexID)1, (VertexID)2);
+    arcsCopy.add((VertexID)3, (VertexID)10, Edge { 7 });
+    verticesCopy.remove((VertexID)10);
+    verticesCopy.add(210, (VertexID)21);
+    verticesCopy.setVertex(4, 400);
+    loopCopy.remove((VertexID)5);
+
+    REQUIRE(arcsCopy.arcsNb() == 21);
+    REQUIRE(!arcsCopy.exists(ArcID(1, 2)));
+    REQUIRE(arcsCopy.arc(ArcID(3, 10)).cost == 7);
+    REQUIRE(arcsCopy.predecessorsNb((VertexID)10) == 2);
+    REQUIRE(verticesCopy.verticesNb() == 20);
+    REQUIRE(verticesCopy.arcsNb() == 19);
+    REQUIRE(verticesCopy.vertex(400) == 4);
+    REQUIRE(verticesCopy.vertex(40) == Graph::IllegalVertexID);
+    REQUIRE(loopCopy.verticesNb() == 19);
+    REQUIRE(loopCopy.arcsNb() == 18);
+    REQUIRE(loopCopy.successorsNb((VertexID)4) == 0);
+
+    REQUIRE(graph.verticesNb() == 20);
+    REQUIRE(graph.arcsNb() == 21);
+    REQUIRE(graph.exists(ArcID(1, 2)));
+    REQUIRE(!graph.exists(ArcID(3, 10)));
+    REQUIRE(graph.exists(ArcID(9, 10)));
+    REQUIRE(graph.exists(ArcID(5, 5)));
+    REQUIRE(graph.predecessorsNb((VertexID)10) == 1);
+    REQUIRE(graph.vertex(40) == 4);
+    REQUIRE(graph.vertex(210) == Graph::IllegalVertexID);
+
+    // Copies changed concurrently, the vertices added taking distinct Ids
+    std::vector<Graph> copies(4, graph);
+    std::vector<std::vector<VertexID>> addedIds(copies.size());
+    ParallelTasks::run(copies.size(), [&copies, &addedIds](unsigned threadIndex) {
+        for (VertexID vertexId = 1; vertexId <= 20; vertexId++)
+            if (vertexId % copies.size() == threadIndex)
+                copies[threadIndex].remove(vertexId);
+        for (int i = 0; i < 1000; i++)
+            addedIds[threadIndex].push_back(copies[threadIndex].add(-1000 * (int)(threadIndex + 1) - i));
+    });
+    std::set<VertexID> allAddedIds;
+    for (unsigned i = 0; i < copies.size(); i++) {
+        REQUIRE(copies[i].verticesNb() == 1015);
+        allAddedIds.insert(addedIds[i].begin(), addedIds[i].end());
+    }
+    REQUIRE(allAddedIds.size() == 4000);
+    REQUIRE(graph.compile().arcsNb() == 21);
+
+    graph.clear();
+    REQUIRE(arcsCopy.verticesNb() == 20);
+}
+
+TEST_CASE("GenericGraph copies share their content until changed", "[GenericGraph]")
+{
+    checkCopiesSharing<GenericGraph<int, Edge>>();
+    checkCopiesSharing<GenericGraph<int, Edge, true, std::less<int>, HashedGraphStorage<>>>();
+}
+
+TEST_CASE("Hash and dense maps keep their elements", "[GenericGraph]")
+{
+    OpenAddressingMap<int, int> hashMap;
+    std::map<int, int> reference;
+    OpenAddressingMap<int, int>::iterator first = hashMap.insert(std::pair<int, int>(-1, 1)).first;
+    reference[-1] = 1;
+    for (int i = 0; i < 5000; i++) {
+        int key = Random::Generate()->intuniform(0, 3000);
+        if (i % 3 == 2) {
+            REQUIRE(hashMap.erase(key) == reference.erase(key));
+        } else {
+            REQUIRE(hashMap.insert(std::pair<int, int>(key, i)).second == reference.insert(std::pair<int, int>(key, i)).second);
+        }
+    }
+    // Elements are not moved when the table grows
+    REQUIRE(first->first == -1);
+    REQUIRE(&*first == &*hashMap.find(-1));
+    REQUIRE(hashMap.size() == reference.size());
+    std::map<int, int> content(hashMap.begin(), hashMap.end());
+    REQUIRE(content == reference);
+
+    DenseIdMap<int> denseMap;
+    denseMap.insert(std::pair<unsigned long, int>(10, 10));
+    denseMap.insert(std::pair<unsigned long, int>(7, 7));
+    denseMap.insert(std::pair<unsigned long, int>(12, 12));
+    REQUIRE(!denseMap.insert(std::pair<unsigned long, int>(7, 0)).second);
+    REQUIRE(denseMap.erase(10) == 1);
+    REQUIRE(denseMap.erase(11) == 0);
+    REQUIRE(denseMap.erase(100) == 0);
+    REQUIRE(denseMap.find(3) == denseMap.end());
+    REQUIRE(denseMap.find(12)->second == 12);
+    REQUIRE(denseMap.size() == 2);
+    std::vector<std::pair<unsigned long, int>> elements(denseMap.begin(), denseMap.end());
+    REQUIRE(elements == std::vector<std::pair<unsigned long, int>> { { 7, 7 }, { 12, 12 } });
+    // Ids inserted in decreasing order, then sparse Ids moving the elements to the ordered map
+    denseMap.clear();
+    for (unsigned long id = 200000; id > 100000; id--)
+        denseMap.insert(std::pair<unsigned long, int>(id, (int)id));
+    REQUIRE(denseMap.size() == 100000);
+    REQUIRE(!denseMap.isSparse());
+    REQUIRE(denseMap.begin()->first == 100001);
+    denseMap.insert(std::pair<unsigned long, int>(1000000000000UL, -1));
+    REQUIRE(denseMap.isSparse());
+    denseMap.insert(denseMap.end(), std::pair<unsigned long, int>(5, 5));
+    REQUIRE(denseMap.erase(150000) == 1);
+    REQUIRE(denseMap.size() == 100001);
+    REQUIRE(denseMap.find(150000) == denseMap.end());
+    REQUIRE(denseMap.find(1000000000000UL)->second == -1);
+    REQUIRE(denseMap.count(5) == 1);
+    const DenseIdMap<int> sparseCopy(denseMap);
+    denseMap.clear();
+    REQUIRE(sparseCopy.find(100002)->second == 100002);
+    elements.assign(sparseCopy.begin(), sparseCopy.end());
+    REQUIRE(elements.size() == 100001);
+    REQUIRE(elements.front().first == 5);
+    REQUIRE(elements[1].first == 100001);
+    REQUIRE(elements.back().first == 1000000000000UL);
+    REQUIRE(std::is_sorted(elements.begin(), elements.end()));
+
+    // Graph of sparse Ids, in a hashed storage
+    GenericGraph<int, Edge, true, std::less<int>, HashedGraphStorage<>> sparseGraph;
+    GenericGraph<int, Edge, true, std::less<int>, HashedGraphStorage<>>::VertexID largeId = 1000000000000UL, smallId = 3;
+    sparseGraph.add(1, largeId);
+    sparseGraph.add(2, smallId);
+    sparseGraph.add(largeId, smallId, Edge { 4 });
+    REQUIRE(sparseGraph.vertex(1) == largeId);
+    REQUIRE(sparseGraph.successorsNb(largeId) == 1);
+    REQUIRE(sparseGraph.compile().vertexId(1) == largeId);
+}
+
+TEST_CASE("Large binary graph files are mapped in milliseconds", "[.][benchmark]")
+{
+    const char* fileName = "TestGenericGraphBenchmark.bin";
+    const unsigned long verticesNb = 5000000, arcsPerVertex = 10;
+    {
+        std::vector<unsigned long> vertexIds(verticesNb), successorsOffsets(verticesNb + 1), successors(verticesNb * arcsPerVertex);
+        std::vector<int> vertices(verticesNb);
+        std::vector<Edge> arcs(verticesNb * arcsPerVertex);
+        for (unsigned long i = 0; i < verticesNb; i++) {
+            vertexIds[i] = i + 1;
+            vertices[i] = (int)i;
+            successorsOffsets[i] = i * arcsPerVertex;
+            for (unsigned long j = 0; j < arcsPerVertex; j++) {
+                successors[i * arcsPerVertex + j] = (i + j * 7919 + 1) % verticesNb;
+                arcs[i * arcsPerVertex + j] = Edge { (int)j };
+            }
+            std::sort(successors.begin() + i * arcsPerVertex, successors.begin() + (i + 1) * arcsPerVertex);
+        }
+        successorsOffsets[verticesNb] = successors.size();
+        CompiledGraph<int, Edge> compiledGraph;
+        compiledGraph.assign(vertexIds, vertices, successorsOffsets, successors, arcs);
+        REQUIRE(compiledGraph.save(fileName));
+    }
+
+    CompiledGraph<int, Edge> mappedGraph;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    mappedGraph.map(fileName);
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    std::cout << "Mapped " << mappedGraph.arcsNb() << " arcs in " << duration.count() * 1000 << " ms" << std::endl;
+    REQUIRE(mappedGraph.verticesNb() == verticesNb);
+    REQUIRE(mappedGraph.successorsNb(verticesNb - 1) == arcsPerVertex);
+    std::remove(fileName);
+}
+
+TEST_CASE("Parallel graph algorithms scale on large topologies", "[.][benchmark]")
+{
+    CompiledGraph<int, Edge> graph = randomCompiledGraph(500000, 2000000, 3);
+    std::vector<unsigned long> distances, parents, components, destinations;
+    for (unsigned long destination = 0; destination < 64; destination++)
+        destinations.push_back(destination * 7919);
+    for (unsigned threadsNb : { 1u, ParallelTasks::threadsNb() }) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        GraphAlgorithms<int, Edge>::breadthFirstSearch(graph, 0, distances, parents, threadsNb);
+        std::chrono::steady_clock::time_point searched = std::chrono::steady_clock::now();
+        unsigned long componentsNb = GraphAlgorithms<int, Edge>::stronglyConnectedComponents(graph, components, threadsNb);
+        std::chrono::steady_clock::time_point split = std::chrono::steady_clock::now();
+        NextHopTable<int, Edge> table(graph, destinations, NextHopTable<int, Edge>::ArcWeight(), threadsNb);
+        std::chrono::steady_clock::time_point routed = std::chrono::steady_clock::now();
+        std::cout << threadsNb << " threads: BFS " << std::chrono::duration<double>(searched - start).count() << " s, "
+                  << componentsNb << " components " << std::chrono::duration<double>(split - searched).count() << " s, "
+                  << destinations.size() << " next-hop rows " << std::chrono::duration<double>(routed - split).count() << " s" << std::endl;
+    }
+}
+
+TEST_CASE("Large topologies are built in bulk faster than arc by arc", "[.][benchmark]")
+{
+    typedef GenericGraph<int, Edge> Graph;
+    const unsigned long verticesNb = 200000, arcsNb = 2000000;
+    std::vector<Graph::VertexEntry> vertices;
+    std::vector<Graph::ArcEntry> arcs;
+    for (unsigned long i = 0; i < verticesNb; i++)
+        vertices.push_back(Graph::VertexEntry(i + 1, (int)i));
+    for (unsigned long i = 0; i < arcsNb; i++)
+        arcs.push_back(Graph::ArcEntry { i % verticesNb + 1, (i % verticesNb + (i / verticesNb + 1) * 7919) % verticesNb + 1, Edge { (int)i } });
+    std::shuffle(arcs.begin(), arcs.end(), std::mt19937(1));
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Graph addedGraph;
+    for (const Graph::VertexEntry& vertex : vertices)
+        addedGraph.add(vertex.second, vertex.first);
+    for (const Graph::ArcEntry& arc : arcs)
+        addedGraph.add(arc.tailId, arc.headId, arc.arc);
+    std::chrono::steady_clock::time_point added = std::chrono::steady_clock::now();
+    Graph builtGraph;
+    builtGraph.build(vertices, arcs);
+    std::chrono::steady_clock::time_point built = std::chrono::steady_clock::now();
+    std::cout << arcsNb << " arcs added in " << std::chrono::duration<double>(added - start).count() << " s, built in "
+              << std::chrono::duration<double>(built - added).count() << " s" << std::endl;
+    REQUIRE(builtGraph.arcsNb() == addedGraph.arcsNb());
+}
@@ -0,0 +1,260 @@
+#include "GenericGraph.h"
+#include "GraphMLReader.h"
+#include "SimulationModuleFactory.h"
+#include "TestDESimulator.h"
+
+#include "catch2/catch.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+class RecordingHandler : public GraphMLReader::Handler {
+public:
+    virtual void graph(const std::string& id, bool directed)
+    {
+        log.push_back("graph " + id + (directed ? " directed" : " undirected"));
+    }
+
+    virtual void node(const std::string& id, const GraphMLReader::Attributes& data)
+    {
+        log.push_back("node " + id + describe(data));
+    }
+
+    virtual void edge(const std::string& source, const std::string& target, bool directed, const GraphMLReader::Attributes& data)
+    {
+        log.push_back("edge " + source + (directed ? "->" : "--") + target + describe(data));
+    }
+
+    std::vector<std::string> log;
+
+private:
+    static std::string describe(const GraphMLReader::Attributes& data)
+    {
+        std::string description;
+        for (GraphMLReader::Attributes::const_iterator it = data.begin(); it != data.end(); it++)
+            description += " " + it->first + "=" + it->second;
+        return description;
+    }
+};
+
+struct Link {
+    int capacity;
+};
+
+bool readGraphML(const std::string& text, std::vector<std::string>& log, std::string& error)
+{
+    std::istringstream ist(text);
+    GraphMLReader reader(ist);
+    RecordingHandler handler;
+    bool success = reader.read(handler);
+    log = handler.log;
+    error = reader.error();
+    return success;
+}
+}
+
+TEST_CASE("GraphML files are read as a stream of nodes and edges", "[GraphML]")
+{
+    const std::string text = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                             "<!DOCTYPE graphml>\n"
+                             "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+                             "  <key id=\"d0\" for=\"node\" attr.name=\"type\" attr.type=\"string\"><default>queue</default></key>\n"
+                             "  <key id=\"d1\" for=\"edge\" attr.name=\"capacity\"/>\n"
+                             "  <!-- a <commented> node: <node id=\"x\"/> -->\n"
+                             "  <graph id=\"net\" edgedefault=\"undirected\">\n"
+                             "    <node id=\"a\"><data key=\"d0\">generator</data></node>\n"
+                             "    <node id='b &amp; c'/>\n"
+                             "    <node id=\"d\"><data key=\"d0\"><![CDATA[<sink>]]></data><port name=\"p\"/></node>\n"
+                             "    <edge source=\"a\" target=\"b &amp; c\"><data key=\"d1\">10</data></edge>\n"
+                             "    <edge id=\"e1\" source=\"b &amp; c\" target=\"d\" directed=\"true\"><data key=\"d1\">&#50;&#x30;</data></edge>\n"
+                             "  </graph>\n"
+                             "</graphml>\n";
+
+    std::vector<std::string> log, expected = {
+        "graph net undirected",
+        "node a type=generator",
+        "node b & c type=queue",
+        "node d type=<sink>",
+        "edge a--b & c capacity=10",
+        "edge b & c->d capacity=20"
+    };
+    std::string error;
+    REQUIRE(readGraphML(text, log, error));
+    REQUIRE(log == expected);
+
+    REQUIRE(!readGraphML("<graphml><graph><node id=\"a\"></graph></graphml>", log, error));
+    REQUIRE(error.find("Line 1") == 0);
+    REQUIRE(!readGraphML("<graphml><graph><node/></graph></graphml>", log, error));
+    REQUIRE(!readGraphML("<graphml><graph><edge source=\"a\"/></graph></graphml>", log, error));
+    REQUIRE(!readGraphML("<graphml><graph><node id=\"a&foo;\"/></graph></graphml>", log, error));
+    REQUIRE(!readGraphML("<graphml><graph><graph/></graph></graphml>", log, error));
+    REQUIRE(!readGraphML("<graphml><graph>", log, error));
+    REQUIRE(!readGraphML("<graphml/>", log, error));
+}
+
+TEST_CASE("GenericGraph can be loaded from GraphML", "[GraphML]")
+{
+    GenericGraph<int, Link> graph("saved");
+    std::vector<GenericGraph<int, Link>::VertexID> ids;
+    for (int i = 0; i < 50; i++)
+        ids.push_back(graph.add(i * i));
+    for (int i = 0; i < 50; i++)
+        graph.add(ids[i], ids[(i * 7 + 1) % 50], Link { i });
+
+    // Only the structure is saved: vertices are rebuilt from the ids
+    std::stringstream stream;
+    REQUIRE(graph.save(stream));
+    GenericGraph<int, Link> loadedGraph;
+    GenericGraph<int, Link>::VertexLoader vertexLoader = [&graph](const std::string&, const GraphMLReader::Attributes&, GenericGraph<int, Link>::VertexID& vertexId) {
+        return graph.vertex(vertexId);
+    };
+    std::string error;
+    REQUIRE(loadedGraph.load(stream, vertexLoader, GenericGraph<int, Link>::ArcLoader(), &error));
+    REQUIRE(std::string(loadedGraph.name()) == "saved");
+    REQUIRE(loadedGraph.vertices() == graph.vertices());
+    REQUIRE(loadedGraph.arcs() == graph.arcs());
+    for (GenericGraph<int, Link>::VertexID id : graph.verticesRange())
+        REQUIRE(loadedGraph.vertex(id) == graph.vertex(id));
+
+    // Nodes named freely, edges before their nodes, and arcs data
+    std::istringstream namedGraph("<graphml><key id=\"c\" for=\"edge\" attr.name=\"capacity\"/><graph edgedefault=\"directed\">"
+                                  "<edge source=\"left\" target=\"right\"><data key=\"c\">5</data></edge>"
+                                  "<edge source=\"right\" target=\"3\" directed=\"false\"><data key=\"c\">7</data></edge>"
+                                  "<node id=\"left\"/><node id=\"right\"/><node id=\"3\"/></graph></graphml>");
+    int nextValue = 1000;
+    GenericGraph<int, Link>::VertexLoader countingLoader = [&nextValue](const std::string&, const GraphMLReader::Attributes&, GenericGraph<int, Link>::VertexID&) {
+        return nextValue++;
+    };
+    GenericGraph<int, Link>::ArcLoader arcLoader = [](GenericGraph<int, Link>::VertexID, GenericGraph<int, Link>::VertexID, const GraphMLReader::Attributes& data) {
+        return Link { std::stoi(data.at("capacity")) };
+    };
+    REQUIRE(loadedGraph.load(namedGraph, countingLoader, arcLoader, &error));
+    REQUIRE(loadedGraph.verticesNb() == 3);
+    REQUIRE(loadedGraph.arcsNb() == 3);
+    const GenericGraph<int, Link>::VertexID numericId = 3;
+    REQUIRE(loadedGraph.vertex(numericId) == 1002);
+    REQUIRE(loadedGraph.arc(loadedGraph.arc(1000, 1001)).capacity == 5);
+    REQUIRE(loadedGraph.arc(loadedGraph.arc(1002, 1001)).capacity == 7);
+    REQUIRE(loadedGraph.arc(loadedGraph.arc(1001, 1002)).capacity == 7);
+
+    std::istringstream unknownNode("<graphml><graph><node id=\"a\"/><edge source=\"a\" target=\"b\"/></graph></graphml>");
+    REQUIRE(!loadedGraph.load(unknownNode, countingLoader, arcLoader, &error));
+    REQUIRE(error.find("unknown nodes") != std::string::npos);
+    std::istringstream duplicateNode("<graphml><graph><node id=\"1\"/><node id=\"1\"/></graph></graphml>");
+    REQUIRE(!loadedGraph.load(duplicateNode, countingLoader, arcLoader, &error));
+    REQUIRE(loadedGraph.verticesNb() == 3); // unchanged
+
+    // Ids generated for the named nodes never take the numeric ids, even those read after them
+    std::istringstream mixedIds("<graphml><graph><node id=\"a\"/><node id=\"b\"/><node id=\"9000\"/><node id=\"9001\"/>"
+                                "<edge source=\"a\" target=\"9001\"/></graph></graphml>");
+    REQUIRE(loadedGraph.load(mixedIds, countingLoader, GenericGraph<int, Link>::ArcLoader(), &error));
+    REQUIRE(loadedGraph.verticesNb() == 4);
+    const GenericGraph<int, Link>::VertexID firstNumericId = 9000, secondNumericId = 9001;
+    REQUIRE(loadedGraph.vertex(firstNumericId) == nextValue - 2);
+    REQUIRE(loadedGraph.vertex(secondNumericId) == nextValue - 1);
+    REQUIRE(loadedGraph.vertex(nextValue - 4) > secondNumericId);
+    REQUIRE(loadedGraph.exists(loadedGraph.vertex(nextValue - 4), secondNumericId));
+    REQUIRE(graph.add(-1) > secondNumericId);
+
+    std::istringstream severalGraphs("<graphml><graph><node id=\"a\"/></graph><graph><node id=\"b\"/></graph></graphml>");
+    REQUIRE(!loadedGraph.load(severalGraphs, countingLoader, GenericGraph<int, Link>::ArcLoader(), &error));
+    REQUIRE(error.find("graphs") != std::string::npos);
+
+    // Vertices built are released on errors
+    std::vector<int> released;
+    GenericGraph<int, Link>::VertexReleaser releaser = [&released](const int& vertex) {
+        released.push_back(vertex);
+    };
+    std::istringstream unknownEdge("<graphml><graph><node id=\"a\"/><node id=\"b\"/><edge source=\"a\" target=\"c\"/></graph></graphml>");
+    REQUIRE(!loadedGraph.load(unknownEdge, countingLoader, GenericGraph<int, Link>::ArcLoader(), &error, releaser));
+    REQUIRE(released == std::vector<int> { nextValue - 2, nextValue - 1 });
+    REQUIRE(loadedGraph.verticesNb() == 4);
+    REQUIRE(!loadedGraph.load("/nonexistent/graph.graphml", countingLoader, arcLoader, &error));
+    REQUIRE_THROWS_AS(loadedGraph.load(unknownNode, GenericGraph<int, Link>::VertexLoader()), std::invalid_argument);
+}
+
+TEST_CASE("Simulation graphs are loaded with modules built by the factory", "[GraphML]")
+{
+    SimulationModuleFactory* factory = SimulationModuleFactory::theFactory();
+    factory->registerModule<MyGen>("generator");
+    factory->registerModule<MyQueue>("queue");
+    factory->registerModule("sink", [](const std::string& name, const GraphMLReader::Attributes& data) -> SimulationModule* {
+        return new MySink(name + "/" + data.at("site"));
+    });
+    REQUIRE(factory->isRegistered("queue"));
+    REQUIRE(!factory->isRegistered("router"));
+
+    std::istringstream network("<graphml><key id=\"t\" for=\"node\" attr.name=\"type\"/><key id=\"n\" for=\"node\" attr.name=\"name\"/>"
+                               "<key id=\"s\" for=\"node\" attr.name=\"site\"/><graph>"
+                               "<node id=\"0\"><data key=\"t\">generator</data><data key=\"n\">source</data></node>"
+                               "<node id=\"1\"><data key=\"t\">queue</data></node>"
+                               "<node id=\"2\"><data key=\"t\">sink</data><data key=\"s\">paris</data></node>"
+                               "<edge source=\"0\" target=\"1\"/><edge source=\"1\" target=\"2\"/></graph></graphml>");
+    DESimulator::SimulationGraph graph;
+    std::string error;
+    REQUIRE(graph.load(network, factory->vertexLoader(), DESimulator::SimulationGraph::ArcLoader(), &error));
+    REQUIRE(graph.verticesNb() == 3);
+    REQUIRE(graph.arcsNb() == 2);
+
+    std::vector<SimulationModule*> modules;
+    for (DESimulator::SimulationGraph::VertexID id : graph.verticesRange()) {
+        modules.push_back(graph.vertex(id));
+        REQUIRE(graph.vertex(id)->id() == id);
+    }
+    REQUIRE(dynamic_cast<MyGen*>(modules[0]));
+    REQUIRE(std::string(modules[0]->name()) == "source");
+    REQUIRE(dynamic_cast<MyQueue*>(modules[1]));
+    REQUIRE(std::string(modules[1]->name()) == "1");
+    REQUIRE(dynamic_cast<MySink*>(modules[2]));
+    REQUIRE(std::string(modules[2]->name()) == "2/paris");
+    REQUIRE(graph.exists(modules[0]->id(), modules[1]->id()));
+    REQUIRE(graph.exists(modules[1]->id(), modules[2]->id()));
+    for (SimulationModule* module : modules)
+        delete module;
+    graph.clear();
+
+    std::istringstream unknownType("<graphml><key id=\"t\" attr.name=\"type\"/><graph><node id=\"0\"><data key=\"t\">router</data></node></graph></graphml>");
+    REQUIRE_THROWS_AS(graph.load(unknownType, factory->vertexLoader()), std::invalid_argument);
+
+    // Modules built before an error are deleted
+    std::istringstream unknownLaterType("<graphml><key id=\"t\" attr.name=\"type\"/><graph><node id=\"0\"><data key=\"t\">queue</data></node>"
+                                        "<node id=\"1\"><data key=\"t\">router</data></node></graph></graphml>");
+    unsigned releasedNb = 0;
+    DESimulator::SimulationGraph::VertexReleaser releaser = [&releasedNb, factory](SimulationModule* const& module) {
+        releasedNb++;
+        factory->vertexReleaser()(module);
+    };
+    REQUIRE_THROWS_AS(graph.load(unknownLaterType, factory->vertexLoader(), DESimulator::SimulationGraph::ArcLoader(), &error, releaser), std::invalid_argument);
+    REQUIRE(releasedNb == 1);
+    REQUIRE(graph.verticesNb() == 0);
+    factory->clear();
+}
+
+TEST_CASE("Large GraphML files are loaded in seconds", "[.][benchmark]")
+{
+    const unsigned long nodesNb = 1000000;
+    std::stringstream stream;
+    {
+        GenericGraph<int, Link, true, std::less<int>, HashedGraphStorage<>> graph;
+        std::vector<GenericGraph<int, Link>::VertexID> ids;
+        for (unsigned long i = 0; i < nodesNb; i++)
+            ids.push_back(graph.add((int)i));
+        for (unsigned long i = 0; i < nodesNb; i++)
+            graph.add(ids[i], ids[(i * 7919 + 1) % nodesNb], Link { 0 });
+        graph.save(stream);
+    }
+    std::cout << "GraphML of " << nodesNb << " nodes: " << stream.str().size() / 1000000 << " MB" << std::endl;
+
+    GenericGraph<int, Link, true, std::less<int>, HashedGraphStorage<>> graph;
+    int nextValue = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    REQUIRE(graph.load(stream, [&nextValue](const std::string&, const GraphMLReader::Attributes&, unsigned long&) { return nextValue++; }));
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    std::cout << "Loaded in " << duration.count() << " s" << std::endl;
+    REQUIRE(graph.verticesNb() == nodesNb);
+    REQUIRE(graph.arcsNb() == nodesNb);
+}
@@ -39,4 +39,127 @@ TEST_CASE("Random numbers can be generated using a distribution", "[Random]")
     }
     std::cout << "Number of 0 = " << nb0 << std::endl;
     std::cout << "Number of 1 = " << nb1 << std::endl;
-}
\ No newline at end of file
+}
+TEST_CASE("Exponential and Normal values can be generated with both sampling modes", "[Random]")
+{
+    const unsigned n = 1000000;
+    Random generator(20110609);
+    Random::SamplingMode modes[] = { Random::FastSampling, Random::ReferenceSampling };
+
+    for (Random::SamplingMode mode : modes) {
+        generator.setSamplingMode(mode);
+        long double expSum = 0, expTail = 0, normalSum = 0, normalSquaresSum = 0, normalTail = 0;
+        for (unsigned i = 0; i < n; ++i) {
+            long double e = generator.exponential(2);
+            expSum += e;
+            if (e > 2)
+                ++expTail;
+            long double z = generator.normal(1, 3);
+            normalSum += z;
+            normalSquaresSum += (z - 1) * (z - 1);
+            if (fabsl(z - 1) > 6)
+                ++normalTail;
+        }
+        std::cout << (mode == Random::FastSampling ? "Fast" : "Reference") << " sampling:"
+                  << " exponential mean = " << expSum / n << ", P(X>2) = " << expTail / n
+                  << ", normal mean = " << normalSum / n << ", variance = " << normalSquaresSum / n
+                  << ", P(|X-1|>6) = " << normalTail / n << std::endl;
+        REQUIRE(expSum / n == Approx(0.5).epsilon(0.01));
+        REQUIRE(expTail / n == Approx(exp(-4.)).epsilon(0.05));
+        REQUIRE(normalSum / n == Approx(1).epsilon(0.01));
+        REQUIRE(normalSquaresSum / n == Approx(9).epsilon(0.01));
+        REQUIRE(normalTail / n == Approx(0.0455).epsilon(0.05));
+    }
+}
+
+TEST_CASE("Poisson and Binomial values can be generated for large parameters", "[Random]")
+{
+    const unsigned n = 1000000;
+    Random generator(20110609);
+
+    struct Case {
+        bool poisson;
+        unsigned trials;
+        double param; // lambda or p
+    } cases[] = {
+        { true, 0, 3.5 }, { true, 0, 50 }, { true, 0, 5000 },
+        { false, 20, 0.2 }, { false, 1000, 0.3 }, { false, 100000, 0.7 }
+    };
+
+    for (const Case& c : cases) {
+        double mean = c.poisson ? c.param : c.trials * c.param;
+        double variance = c.poisson ? c.param : c.trials * c.param * (1 - c.param);
+
+        // Exact probability of X <= floor(mean)
+        unsigned mode = (unsigned)floor(mean);
+        double cdf = 0;
+        for (unsigned k = 0; k <= mode; ++k) {
+            double logPmf = c.poisson
+                ? -c.param + k * log(c.param) - lgamma(k + 1.0)
+                : lgamma(c.trials + 1.0) - lgamma(k + 1.0) - lgamma(c.trials - k + 1.0) + k * log(c.param) + (c.trials - k) * log(1 - c.param);
+            cdf += exp(logPmf);
+        }
+
+        double sum = 0, squaresSum = 0, belowMode = 0;
+        time_t t = time(NULL);
+        for (unsigned i = 0; i < n; ++i) {
+            double x = c.poisson ? generator.poisson(c.param) : generator.binomial(c.trials, c.param);
+            sum += x;
+            squaresSum += (x - mean) * (x - mean);
+            if (x <= mode)
+                ++belowMode;
+        }
+        std::cout << (c.poisson ? "Poisson(" : "Binomial(") << (c.poisson ? "" : std::to_string(c.trials) + ", ") << c.param << "): "
+                  << n << " values in " << time(NULL) - t << " seconds,"
+                  << " mean = " << sum / n << " (" << mean << "),"
+                  << " variance = " << squaresSum / n << " (" << variance << "),"
+                  << " P(X<=" << mode << ") = " << belowMode / n << " (" << cdf << ")" << std::endl;
+        REQUIRE(sum / n == Approx(mean).epsilon(0.005));
+        REQUIRE(squaresSum / n == Approx(variance).epsilon(0.02));
+        REQUIRE(belowMode / n == Approx(cdf).margin(0.003));
+    }
+}
+
+TEST_CASE("Antithetic generators draw negatively correlated values", "[Random]")
+{
+    const unsigned n = 1000000;
+    Random generator(2011, 0, 3), antitheticGenerator(2011, 0, 3);
+    generator.setSamplingMode(Random::InversionSampling);
+    antitheticGenerator.setSamplingMode(Random::InversionSampling);
+    antitheticGenerator.setAntithetic(true);
+
+    // Inversion of the Normal distribution function, checked on a few quantiles
+    double belowQuantiles[3] = { 0, 0, 0 };
+    const double quantiles[3] = { -3.090232306167814, 0.6744897501960817, 1.959963984540054 };
+    const double probabilities[3] = { 0.001, 0.75, 0.975 };
+    double pairsSum = 0, pairsSquaresSum = 0;
+    for (unsigned i = 0; i < n; ++i) {
+        double x = generator.normal(2, 1), y = antitheticGenerator.normal(2, 1);
+        REQUIRE(x + y == Approx(4).margin(1e-9));
+        for (unsigned q = 0; q < 3; ++q)
+            if (x - 2 < quantiles[q])
+                ++belowQuantiles[q];
+
+        // Mean of antithetic pairs of Exponential values
+        double pairMean = (generator.exponential(1) + antitheticGenerator.exponential(1)) / 2;
+        pairsSum += pairMean;
+        pairsSquaresSum += pairMean * pairMean;
+    }
+    for (unsigned q = 0; q < 3; ++q) {
+        std::cout << "P(X < " << quantiles[q] << ") = " << belowQuantiles[q] / n << " (" << probabilities[q] << ")" << std::endl;
+        REQUIRE(belowQuantiles[q] / n == Approx(probabilities[q]).margin(0.002));
+    }
+
+    // Var((X+Y)/2) = (1 + Corr(X,Y)) / 2 for Exponential(1) values, with Corr(X,Y) = 1 - pi^2/6 for antithetic ones
+    double pairsVariance = pairsSquaresSum / n - (pairsSum / n) * (pairsSum / n);
+    std::cout << "Variance of antithetic pairs means = " << pairsVariance << " (independent pairs: 0.5)" << std::endl;
+    REQUIRE(pairsSum / n == Approx(1).epsilon(0.005));
+    REQUIRE(pairsVariance == Approx((2 - M_PI * M_PI / 6) / 2).epsilon(0.02));
+
+    // Bulk values are complemented as well
+    std::vector<double> values(1000), antitheticValues(1000);
+    generator.uniform(values.data(), values.size(), 0, 1);
+    antitheticGenerator.uniform(antitheticValues.data(), antitheticValues.size(), 0, 1);
+    for (unsigned i = 0; i < values.size(); ++i)
+        REQUIRE(values[i] + antitheticValues[i] == Approx(1).margin(1e-12));
+}
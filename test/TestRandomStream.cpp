@@ -0,0 +1,123 @@
+#include "Random.h"
+#include "RandomStream.h"
+
+#include "catch2/catch.hpp"
+
+#include <iostream>
+
+TEST_CASE("Philox4x32-10 bijection gives the reference values", "[RandomStream]")
+{
+    // Known answer tests of the Random123 library
+    uint32_t result[4];
+
+    uint32_t zeroCounter[4] = { 0, 0, 0, 0 };
+    uint32_t zeroKey[2] = { 0, 0 };
+    RandomStream::philox(zeroCounter, zeroKey, result);
+    REQUIRE(result[0] == 0x6627e8d5);
+    REQUIRE(result[1] == 0xe169c58d);
+    REQUIRE(result[2] == 0xbc57ac4c);
+    REQUIRE(result[3] == 0x9b00dbd8);
+
+    uint32_t onesCounter[4] = { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff };
+    uint32_t onesKey[2] = { 0xffffffff, 0xffffffff };
+    RandomStream::philox(onesCounter, onesKey, result);
+    REQUIRE(result[0] == 0x408f276d);
+    REQUIRE(result[1] == 0x41c83b0e);
+    REQUIRE(result[2] == 0xa20bc7c6);
+    REQUIRE(result[3] == 0x6d5451fd);
+
+    uint32_t piCounter[4] = { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 };
+    uint32_t piKey[2] = { 0xa4093822, 0x299f31d0 };
+    RandomStream::philox(piCounter, piKey, result);
+    REQUIRE(result[0] == 0xd16cfe09);
+    REQUIRE(result[1] == 0x94fdcceb);
+    REQUIRE(result[2] == 0x5001e420);
+    REQUIRE(result[3] == 0x24126ea1);
+}
+
+TEST_CASE("Random streams are reproducible and can skip ahead", "[RandomStream]")
+{
+    const unsigned n = 1001;
+    RandomStream stream(20110609, 3, 42);
+    std::vector<uint64_t> values(n);
+    for (unsigned i = 0; i < n; ++i)
+        values[i] = stream.next();
+    REQUIRE(stream.position() == n);
+
+    // Same key, same values
+    RandomStream sameStream(20110609, 3, 42);
+    for (unsigned i = 0; i < n; ++i)
+        REQUIRE(sameStream.next() == values[i]);
+
+    // Skipping ahead, at odd and even positions
+    RandomStream skippingStream(20110609, 3, 42);
+    skippingStream.skip(777);
+    REQUIRE(skippingStream.next() == values[777]);
+    skippingStream.seek(500);
+    REQUIRE(skippingStream.next() == values[500]);
+    skippingStream.reset();
+    REQUIRE(skippingStream.next() == values[0]);
+
+    // Other replication or other stream identifier, other values
+    RandomStream otherReplication(20110609, 4, 42), otherStream(20110609, 3, 43);
+    unsigned sameValuesNb = 0;
+    for (unsigned i = 0; i < n; ++i) {
+        uint64_t v1 = otherReplication.next(), v2 = otherStream.next();
+        if (v1 == values[i] || v2 == values[i])
+            ++sameValuesNb;
+    }
+    REQUIRE(sameValuesNb == 0);
+}
+
+TEST_CASE("Random generators can use their own streams", "[RandomStream][Random]")
+{
+    Random gen1(1234, 0, 1), gen2(1234, 0, 1), gen3(1234, 1, 1);
+
+    long double mean = 0;
+    for (unsigned i = 0; i < 1000; ++i) {
+        long double x = gen1.exponential(2);
+        REQUIRE(x == gen2.exponential(2));
+        mean += x;
+    }
+    std::cout << "Mean of exponential(2) = " << mean / 1000 << std::endl;
+    REQUIRE(gen3.uniform(0, 1) != gen1.uniform(0, 1));
+}
+
+TEST_CASE("Random streams can be drawn in bulk", "[RandomStream]")
+{
+    RandomStream stream(5, 0, 7), bulkStream(5, 0, 7);
+    std::vector<uint64_t> bulkValues(1000);
+
+    // Start from an odd position, to check blocks boundaries
+    stream.next();
+    bulkStream.next();
+    bulkStream.generate(bulkValues.data(), bulkValues.size());
+    for (unsigned i = 0; i < bulkValues.size(); ++i)
+        REQUIRE(bulkValues[i] == stream.next());
+    REQUIRE(bulkStream.position() == stream.position());
+    REQUIRE(bulkStream.next() == stream.next());
+}
+
+TEST_CASE("Random generators can be seeded and split into substreams", "[RandomStream][Random]")
+{
+    Random gen1(1), gen2(2);
+    gen1.uniform(0, 1);
+    gen2.setSeed(1);
+    REQUIRE(gen2.seed() == 1);
+    REQUIRE(gen2.uniform(0, 1) != gen1.uniform(0, 1));
+    gen1.setSeed(1);
+    REQUIRE(gen1.uniform(0, 1) == Random(1).uniform(0, 1));
+
+    // Each replication has its own stream
+    Random replicated(1);
+    replicated.setReplication(5);
+    REQUIRE(replicated.replication() == 5);
+    REQUIRE(replicated.stream().next() == RandomStream(1, 5, 0).next());
+
+    // Named substreams are reproducible, and distinct from each other and from modules streams
+    Random arrivals = gen1.substream("arrivals"), services = gen1.substream("services");
+    REQUIRE(arrivals.stream().streamId() >= 0x80000000ul);
+    REQUIRE(arrivals.stream().streamId() != services.stream().streamId());
+    REQUIRE(arrivals.stream().streamId() != Random(1, 0, 7).substream("arrivals").stream().streamId());
+    REQUIRE(arrivals.exponential(2) == Random(1).substream("arrivals").exponential(2));
+}
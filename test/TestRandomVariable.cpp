@@ -1,7 +1,14 @@
+#include "ParallelTasks.h"
+#include "Random.h"
+#include "RandomSampler.h"
 #include "RandomVariable.h"
+#include "TraceFile.h"
 
 #include "catch2/catch.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 
 TEST_CASE("Random numbers can be generated, with distribution", "[Random][RandomVariable]")
@@ -97,4 +104,221 @@ TEST_CASE("Random numbers can be generated, with distribution", "[Random][Random
     }
     std::cout << std::endl
               << "(Mean = " << mean / nbSamples << " )" << std::endl;
-}
\ No newline at end of file
+}
+TEST_CASE("Random variables can be sampled in bulk", "[Random][RandomVariable]")
+{
+    const size_t nbSamples = 1000000;
+    std::vector<double> samples(nbSamples);
+    RandomVariable variables[] = {
+        RandomVariable(RandomVariable::Uniform, 2, 5),
+        RandomVariable(RandomVariable::Exponential, 5),
+        RandomVariable(RandomVariable::Normal, 3, 2),
+        RandomVariable(RandomVariable::LogNormal, 3, 2),
+        RandomVariable(RandomVariable::Poisson, 4),
+    };
+
+    for (const RandomVariable& X : variables) {
+        time_t t = time(NULL);
+        X.generateSamples(samples.data(), nbSamples);
+
+        double mean = 0, variance = 0;
+        for (double sample : samples)
+            mean += sample;
+        mean /= nbSamples;
+        for (double sample : samples)
+            variance += (sample - mean) * (sample - mean);
+        variance /= nbSamples - 1;
+
+        std::cout << "Generated " << nbSamples << " samples of '" << X.typeString() << "' in " << time(NULL) - t << " seconds"
+                  << " (Mean = " << mean << ", expected " << X.mean()
+                  << ", Variance = " << variance << ", expected " << X.variance() << ")" << std::endl;
+        REQUIRE(mean == Approx(X.mean()).epsilon(0.01));
+        REQUIRE(sqrt(variance) == Approx(X.standardDeviation()).epsilon(0.02));
+    }
+}
+
+TEST_CASE("Arbitrary discrete random variables are sampled with alias tables", "[Random][RandomVariable]")
+{
+    const unsigned nbSamples = 1000000;
+    const std::vector<double> weights = { 1, 0, 3, 6 }, values = { -2, 7, 0.5, 10 };
+
+    AliasTable table(weights);
+    REQUIRE(table.size() == weights.size());
+    REQUIRE(table.probability(3) == Approx(0.6));
+    REQUIRE_THROWS(AliasTable({ 1, -1 }));
+    REQUIRE_THROWS(AliasTable({ 0, 0 }));
+
+    std::vector<unsigned> counts(weights.size());
+    for (unsigned i = 0; i < nbSamples; ++i)
+        counts.at(Random::Generate()->discrete(table))++;
+    for (unsigned i = 0; i < counts.size(); ++i) {
+        std::cout << "Index " << i << " drawn " << counts[i] << " times, expected " << table.probability(i) * nbSamples
+                  << std::endl;
+        REQUIRE((double)counts[i] / nbSamples == Approx(table.probability(i)).margin(0.002));
+    }
+
+    RandomVariable X;
+    X.setCategorical(weights, values);
+    REQUIRE(X.typeString() == "Categorical");
+    REQUIRE(X.minValue() == -2);
+    REQUIRE(X.maxValue() == 10);
+
+    std::vector<double> samples(nbSamples);
+    X.generateSamples(samples.data(), nbSamples);
+    double mean = 0;
+    for (double sample : samples)
+        mean += sample;
+    mean /= nbSamples;
+    std::cout << "Mean of categorical variable = " << mean << ", expected " << X.mean() << std::endl;
+    REQUIRE(mean == Approx(X.mean()).epsilon(0.01));
+    REQUIRE_THROWS(X.setCategorical(weights, { 1, 2 }));
+}
+
+TEST_CASE("Random variables can be compiled into samplers", "[Random][RandomVariable]")
+{
+    const unsigned nbSamples = 1000000;
+    RandomVariable variables[] = {
+        RandomVariable(RandomVariable::Uniform, 2, 5),
+        RandomVariable(RandomVariable::IntUniform, -4, 10),
+        RandomVariable(RandomVariable::Bernoulli, 0.3),
+        RandomVariable(RandomVariable::Binomial, 200, 0.7),
+        RandomVariable(RandomVariable::Poisson, 4),
+        RandomVariable(RandomVariable::Poisson, 40),
+        RandomVariable(RandomVariable::Exponential, 5),
+        RandomVariable(RandomVariable::Normal, 3, 2),
+        RandomVariable(RandomVariable::LogNormal, 3, 2),
+    };
+
+    Random generator(20110726);
+    for (const RandomVariable& X : variables) {
+        RandomSampler sampler(X);
+        double mean = 0;
+        for (unsigned i = 0; i < nbSamples; ++i)
+            mean += sampler.sample(&generator);
+        mean /= nbSamples;
+        std::cout << "Mean of sampled '" << X.typeString() << "' = " << mean << ", expected " << X.mean() << std::endl;
+        REQUIRE(mean == Approx(X.mean()).epsilon(0.01));
+    }
+
+    // Samplers transform the same values as the generator methods
+    Random gen1(42, 0, 1), gen2(42, 0, 1);
+    RandomSampler normalSampler(RandomVariable(RandomVariable::Normal, 3, 2));
+    for (unsigned i = 0; i < 100; ++i)
+        REQUIRE(normalSampler.sample(&gen1) == Approx(gen2.normal(3, 2)));
+
+    // Including the rejection samplers, from the constants computed by the sampler
+    RandomSampler binomialSampler(RandomVariable(RandomVariable::Binomial, 200, 0.7));
+    RandomSampler poissonSampler(RandomVariable(RandomVariable::Poisson, 40));
+    for (unsigned i = 0; i < 1000; ++i) {
+        REQUIRE(binomialSampler.sample(&gen1) == gen2.binomial(200, 0.7));
+        REQUIRE(poissonSampler.sample(&gen1) == gen2.poisson(40));
+    }
+}
+
+TEST_CASE("Random variables can be driven by trace files", "[Random][RandomVariable]")
+{
+    const char* sortedFileName = "TestRandomVariable_sorted.trace";
+    const char* unsortedFileName = "TestRandomVariable_unsorted.trace";
+    const unsigned nbValues = 1000, nbSamples = 100000;
+
+    std::vector<double> values(nbValues);
+    for (unsigned i = 0; i < nbValues; ++i)
+        values[i] = i + 1;
+    std::ofstream(sortedFileName, std::ios::binary).write((const char*)values.data(), nbValues * sizeof(double));
+    std::swap(values[0], values[1]);
+    std::ofstream(unsortedFileName, std::ios::binary).write((const char*)values.data(), nbValues * sizeof(double));
+
+    // Values are replayed in order, and again from the start
+    RandomVariable X;
+    X.setTrace(unsortedFileName);
+    REQUIRE(X.typeString() == "Trace");
+    REQUIRE(X.mean() == Approx(500.5));
+    REQUIRE(X.minValue() == 1);
+    REQUIRE(X.maxValue() == nbValues);
+    for (unsigned i = 0; i < 2 * nbValues; ++i)
+        REQUIRE(X.generateSample() == values[i % nbValues]);
+    REQUIRE_THROWS(X.setTrace(unsortedFileName, RandomVariable::TraceInterpolation));
+    REQUIRE_THROWS(X.setTrace("TestRandomVariable_missing.trace"));
+
+    // Resampled and interpolated values
+    RandomVariable::TraceMode modes[] = { RandomVariable::TraceResampling, RandomVariable::TraceInterpolation };
+    std::vector<double> samples(nbSamples);
+    for (RandomVariable::TraceMode mode : modes) {
+        X.setTrace(sortedFileName, mode);
+        X.generateSamples(samples.data(), nbSamples);
+        double mean = 0;
+        for (double sample : samples) {
+            REQUIRE(sample >= X.minValue());
+            REQUIRE(sample <= X.maxValue());
+            mean += sample;
+        }
+        mean /= nbSamples;
+        std::cout << "Mean of trace samples (mode " << mode << ") = " << mean << ", expected " << X.mean() << std::endl;
+        REQUIRE(mean == Approx(X.mean()).epsilon(0.01));
+    }
+
+    // Statistics of a trace shared by several threads
+    TraceFile trace(unsortedFileName);
+    std::vector<double> means(4);
+    ParallelTasks::run(means.size(), [&trace, &means](unsigned threadIndex) {
+        means[threadIndex] = trace.mean();
+    });
+    for (double mean : means)
+        REQUIRE(mean == Approx(500.5));
+    REQUIRE(!trace.isSorted());
+
+    X.setUnusable();
+    std::remove(sortedFileName);
+    std::remove(unsortedFileName);
+}
+
+TEST_CASE("Gamma, Weibull, Pareto, Erlang and phase-type variables can be sampled", "[Random][RandomVariable]")
+{
+    const size_t nbSamples = 1000000;
+    std::vector<double> samples(nbSamples);
+
+    RandomVariable hyperExponential, coxian;
+    hyperExponential.setHyperExponential({ 0.2, 0.8 }, { 0.5, 4 });
+    // Coxian distribution: phase 1 (rate 3) then, with probability 1/3, phase 2 (rate 1)
+    coxian.setPhaseType({ 1, 0 }, { { -3, 1 }, { 0, -1 } });
+    RandomVariable variables[] = {
+        RandomVariable(RandomVariable::Gamma, 0.5, 2),
+        RandomVariable(RandomVariable::Gamma, 7.5, 0.1),
+        RandomVariable(RandomVariable::Weibull, 1.5, 2),
+        RandomVariable(RandomVariable::Pareto, 8, 1),
+        RandomVariable(RandomVariable::Erlang, 3, 2),
+        RandomVariable(RandomVariable::Erlang, 40, 8),
+        hyperExponential,
+        coxian,
+    };
+    REQUIRE(coxian.mean() == Approx(1. / 3 + 1. / 3));
+    REQUIRE(coxian.variance() == Approx(1. / 9 + (2. / 3 - 1. / 9)));
+    // Phases 2 and 3 are never left, initial probabilities above 1
+    REQUIRE_THROWS_AS(PhaseTypeDistribution({ 1, 0, 0 }, { { -2, 1, 0 }, { 0, -1, 1 }, { 0, 1, -1 } }), std::invalid_argument);
+    REQUIRE_THROWS_AS(PhaseTypeDistribution({ 0.7, 0.7 }, { { -3, 1 }, { 0, -1 } }), std::invalid_argument);
+
+    Random generator(20110812);
+    for (const RandomVariable& X : variables) {
+        // Bulk, scalar and compiled samples
+        X.generateSamples(samples.data(), nbSamples / 2);
+        RandomSampler sampler(X);
+        for (size_t i = nbSamples / 2; i < nbSamples; i += 2) {
+            samples[i] = X.generateSample();
+            samples[i + 1] = sampler.sample(&generator);
+        }
+
+        double mean = 0, variance = 0;
+        for (double sample : samples)
+            mean += sample;
+        mean /= nbSamples;
+        for (double sample : samples)
+            variance += (sample - mean) * (sample - mean);
+        variance /= nbSamples - 1;
+
+        std::cout << "Samples of '" << X.typeString() << "': mean = " << mean << " (" << X.mean() << "),"
+                  << " variance = " << variance << " (" << X.variance() << ")" << std::endl;
+        REQUIRE(mean == Approx(X.mean()).epsilon(0.01));
+        REQUIRE(variance == Approx(X.variance()).epsilon(0.03));
+        REQUIRE(*std::min_element(samples.begin(), samples.end()) >= X.minValue());
+    }
+}
@@ -1,8 +1,62 @@
+#include "Random.h"
 #include "SimulationTime.h"
 
 #include "catch2/catch.hpp"
 
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
 #include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+// Event loop of the simulator reduced to its time operations: the earliest event is taken from the queue of future
+// events, and a new event is scheduled after it. Returns the time taken by an event, in nanoseconds.
+template <typename Time>
+double eventLoopDuration(const unsigned eventsNb)
+{
+    Random generator(1);
+    std::vector<Time> delays(1024);
+    for (Time& delay : delays)
+        delay = Time(generator.exponential(1000));
+    std::priority_queue<Time, std::vector<Time>, std::greater<Time>> events;
+    for (unsigned i = 0; i < 10000; ++i)
+        events.push(delays[i % delays.size()] * (i + 1));
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < eventsNb; ++i) {
+        Time now = events.top();
+        events.pop();
+        events.push(now + delays[i % delays.size()]);
+    }
+    std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+    REQUIRE(events.top() > Time());
+    return duration.count() / eventsNb;
+}
+
+// Formats and parses back times of every magnitude, positive and negative
+template <typename Time>
+void checkRoundTrips()
+{
+    typedef typename Time::DataType DataType;
+    const DataType maxTicks = (DataType)(~(unsigned __int128)0 >> (129 - sizeof(DataType) * 8));
+    char buffer[Time::maxStringLength];
+    Time parsed;
+    for (DataType ticks = 1; ticks <= maxTicks / 3; ticks = ticks * 3 + 1) {
+        for (int sign = -1; sign <= 1; sign += 2) {
+            Time t = Time::fromTicks(sign * ticks);
+            std::to_chars_result written = t.toChars(buffer, buffer + sizeof(buffer));
+            REQUIRE(written.ec == std::errc());
+            REQUIRE(parsed.fromChars(buffer, written.ptr).ptr == written.ptr);
+            REQUIRE(parsed == t);
+        }
+    }
+}
+}
 
 TEST_CASE("SimulationTime can be converted to and from strings", "[SimulationTime]")
 {
@@ -43,4 +97,153 @@ TEST_CASE("SimulationTime can be converted to and from strings", "[SimulationTim
               << ", 0.1*time = " << testtime * 0.1 << std::endl
               << ", 10.5*time = " << testtime * 10.5 << std::endl
               << ", 1000*time = " << testtime * 1000 << std::endl;
-}
\ No newline at end of file
+}
+
+TEST_CASE("SimulationTime is multiplied and divided on integers", "[SimulationTime]")
+{
+    const double tick = 1.0 / (2LL << SimulationTime::getPrecisionLength());
+
+    SimulationTime t;
+    t.fromDouble(3600.5);
+    REQUIRE(t.toDouble() == 3600.5);
+    REQUIRE(t.toDbl() == 3600.5);
+
+    // Exact products and quotients
+    REQUIRE((t * 2).toDouble() == 7201);
+    REQUIRE((t * 1.5).toDouble() == 5400.75);
+    REQUIRE((t * -0.25).toDouble() == -900.125);
+    REQUIRE((t / 2).toDouble() == 1800.25);
+    REQUIRE((t / 0.5).toDouble() == 7201);
+    REQUIRE((t / -4.0).toDouble() == -900.125);
+    REQUIRE((t * 1000000).toDouble() == 3600500000.);
+
+    // Rounding to the nearest tick, ties away from zero
+    SimulationTime oneTick(tick), threeTicks(3 * tick);
+    REQUIRE((oneTick / 2).toDouble() == tick);
+    REQUIRE((oneTick * -0.5).toDouble() == -tick);
+    REQUIRE((oneTick * 0.49).toDouble() == 0);
+    REQUIRE((threeTicks / 2).toDouble() == 2 * tick);
+    REQUIRE((threeTicks / 4.0).toDouble() == tick);
+    REQUIRE((threeTicks * -1 / 2).toDouble() == -2 * tick);
+
+    // Very small and very large factors
+    REQUIRE((oneTick / ldexp(1, -20)).toDouble() == ldexp(tick, 20));
+    REQUIRE((oneTick * ldexp(1, 20)).toDouble() == ldexp(tick, 20));
+    REQUIRE((t / ldexp(1, 80)).toDouble() == 0);
+    REQUIRE((t * 0.1).toDouble() == Approx(360.05).margin(tick / 2));
+    REQUIRE((t / 3.0).toDouble() == Approx(3600.5 / 3).margin(tick / 2));
+
+    REQUIRE_THROWS_AS(t / 0, std::invalid_argument);
+    REQUIRE_THROWS_AS(t / 0.0, std::invalid_argument);
+    REQUIRE_THROWS_AS(t * NAN, std::invalid_argument);
+
+    // Integer factors of any size, without truncation nor undefined overflow
+    const unsigned long long largestFactor = std::numeric_limits<unsigned long long>::max();
+    REQUIRE((SimulationTime() * largestFactor) == SimulationTime());
+    REQUIRE((oneTick * (largestFactor >> 1)) == SimulationTime::fromTicks(std::numeric_limits<long long>::max()));
+    REQUIRE_THROWS_AS(t * largestFactor * largestFactor, std::overflow_error);
+}
+
+TEST_CASE("SimulationTime constants are computed at compile time", "[SimulationTime]")
+{
+    constexpr SimulationTime delay = 5_s + 20_ms;
+    static_assert(delay > 5_s && delay < 6_s, "Literals must be compared at compile time");
+    static_assert(125_ms * 8 == 1_s, "Integer scaling must be exact");
+    static_assert((1_s / 3).ticks() == (SimulationTime::ticksPerSecond + 1) / 3, "Integer division must round to the nearest tick");
+    static_assert(BasicSimulationTime<>::getPrecisionLength() == 24, "The default precision must be 24 bits");
+    REQUIRE(delay.toDouble() == Approx(5.02).margin(1.0 / SimulationTime::ticksPerSecond));
+    REQUIRE((1.5_s).toDouble() == 1.5);
+    REQUIRE(1000_us == 1_ms);
+    REQUIRE(1000000_ns == 1_ms);
+    static_assert(86400000000000_ns == 86400_s, "Large literals must not overflow before the division");
+    static_assert(3600000000_us == 3600_s && 3600000_ms == 3600_s, "Large literals must not overflow before the division");
+    REQUIRE(1500000000001_ns - 1500_s == 1_ns);
+
+    // Nanosecond resolution, over a few centuries
+    NanoSimulationTime nanosecond(1e-9), centuries(250 * 365.25 * 86400.);
+    REQUIRE(nanosecond.ticks() > 0);
+    REQUIRE((centuries + nanosecond) > centuries);
+    REQUIRE((centuries / 2).toDouble() == Approx(125 * 365.25 * 86400.));
+    REQUIRE((centuries - nanosecond - centuries + nanosecond).ticks() == 0);
+    std::ostringstream output;
+    output << NanoSimulationTime(1.5);
+    REQUIRE(output.str() == "1.5000000000s");
+}
+
+TEST_CASE("SimulationTime is formatted and parsed without allocation", "[SimulationTime]")
+{
+    char buffer[SimulationTime::maxStringLength];
+    SimulationTime t;
+
+    REQUIRE(t.fromChars("1d2h3m4.5s", strchr("1d2h3m4.5s", 0)).ec == std::errc());
+    REQUIRE(t == 1_s * (86400 + 2 * 3600 + 3 * 60) + 4.5_s);
+    std::to_chars_result written = t.toChars(buffer, buffer + sizeof(buffer));
+    REQUIRE(written.ec == std::errc());
+    REQUIRE(std::string(buffer, written.ptr) == "1d2h3m4.5" + std::string(SimulationTime::secondsDecimals - 1, '0') + "s");
+
+    // Round trip of times of every magnitude, with enough decimals for each precision
+    checkRoundTrips<BasicSimulationTime<>>();
+    checkRoundTrips<NanoSimulationTime>();
+    checkRoundTrips<WideSimulationTime>();
+    static_assert(BasicSimulationTime<>::secondsDecimals == 8 && NanoSimulationTime::secondsDecimals == 10, "Decimals must be finer than a tick");
+
+    // Largest time, and too short buffers
+    t = SimulationTime::fromTicks(-(~0ULL >> 1));
+    written = t.toChars(buffer, buffer + sizeof(buffer));
+    REQUIRE(written.ec == std::errc());
+    REQUIRE(t.toChars(buffer, written.ptr - 1).ec == std::errc::value_too_large);
+    REQUIRE(SimulationTime().toChars(buffer, buffer + sizeof(buffer)).ptr == buffer + 3 + SimulationTime::secondsDecimals);
+
+    // Formats accepted by fromStr()
+    t.fromStr(" - 3h 2d 30 ");
+    REQUIRE(t == 1_s * -(2 * 86400 + 3 * 3600 + 30));
+    t.fromStr("0.25m");
+    REQUIRE(t == 15_s);
+    REQUIRE_THROWS_AS(t.fromStr("1h2h"), std::invalid_argument);
+    REQUIRE_THROWS_AS(t.fromStr("1.2.3s"), std::invalid_argument);
+    REQUIRE_THROWS_AS(t.fromStr("3x"), std::invalid_argument);
+    REQUIRE_THROWS_AS(t.fromStr("1000000000000000000000000000000d"), std::invalid_argument);
+    REQUIRE(t == 15_s);
+
+    const char* garbage = "12mx";
+    std::from_chars_result read = t.fromChars(garbage, garbage + 4);
+    REQUIRE(read.ec == std::errc());
+    REQUIRE(read.ptr == garbage + 3);
+    REQUIRE(t.fromChars(garbage + 3, garbage + 4).ec == std::errc::invalid_argument);
+}
+
+TEST_CASE("Wide SimulationTime keeps nanoseconds over centuries", "[SimulationTime]")
+{
+    const WideSimulationTime nanosecond(1e-9), year(365.25 * 86400);
+    WideSimulationTime t = year * 100000;
+    REQUIRE(t > year);
+    REQUIRE(t + nanosecond > t);
+    REQUIRE((t + nanosecond - t) == nanosecond);
+    REQUIRE(((t * 1.5) / 3.0) == t / 2);
+    REQUIRE((t / 100000) == year);
+
+    char buffer[WideSimulationTime::maxStringLength];
+    std::to_chars_result written = t.toChars(buffer, buffer + sizeof(buffer));
+    REQUIRE(std::string(buffer, written.ptr) == "36525000d");
+    WideSimulationTime parsed;
+    REQUIRE(parsed.fromChars(buffer, written.ptr).ec == std::errc());
+    REQUIRE(parsed == t);
+
+    // Around the largest time
+    t = WideSimulationTime::fromTicks(WideSimulationTime::ticksPerSecond - (WideSimulationTime::DataType)(~(unsigned __int128)0 >> 1));
+    written = t.toChars(buffer, buffer + sizeof(buffer));
+    REQUIRE(written.ec == std::errc());
+    REQUIRE(parsed.fromChars(buffer, written.ptr).ec == std::errc());
+    REQUIRE((parsed - t).ticks() < WideSimulationTime::ticksPerSecond / 100000000);
+    REQUIRE_THROWS_AS(parsed.fromStr("1000000000000000000000000000000d"), std::invalid_argument);
+}
+
+TEST_CASE("SimulationTime storages are benchmarked in an event loop", "[.][benchmark]")
+{
+    const unsigned eventsNb = 10000000;
+    double duration64 = eventLoopDuration<BasicSimulationTime<>>(eventsNb);
+    double duration128 = eventLoopDuration<WideSimulationTime>(eventsNb);
+    std::cout << "Event loop with 64 bits times: " << duration64 << " ns per event" << std::endl
+              << "Event loop with 128 bits times: " << duration128 << " ns per event ("
+              << 100 * (duration128 / duration64 - 1) << "% more)" << std::endl;
+}